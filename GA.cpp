@@ -1,26 +1,94 @@
 #include "GA.h"
 #include <algorithm>
+#include <bit>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace {
+int maxNumThreads()
+{
+#ifdef _OPENMP
+    return omp_get_max_threads();
+#else
+    return 1;
+#endif
+}
+
+int threadNum()
+{
+#ifdef _OPENMP
+    return omp_get_thread_num();
+#else
+    return 0;
+#endif
+}
+
+int numThreadsInTeam()
+{
+#ifdef _OPENMP
+    return omp_get_num_threads();
+#else
+    return 1;
+#endif
+}
+
+bool inParallelRegion()
+{
+#ifdef _OPENMP
+    return omp_in_parallel() != 0;
+#else
+    return false;
+#endif
+}
+}   // namespace
 
 void GA::setGAParameters(int numRecords)
 {
     int threshold = 0;
     for(const auto val : GENOMESIZETHRESHOLD) {
         if(numRecords < val) {
-            populationsize = POPULATIONSIZE[threshold];
-            topgenomelikelihood = TOPGENOMELIKELIHOOD[threshold];
-            numgenerationsofancestors = NUMGENERATIONSOFANCESTORS[threshold];
-            mutationlikelihood = MUTATIONLIKELIHOOD[threshold];
             break;
         }
         threshold++;
     }
+    populationsize = POPULATIONSIZE[threshold];
+    topgenomelikelihood = TOPGENOMELIKELIHOOD[threshold];
+    numgenerationsofancestors = NUMGENERATIONSOFANCESTORS[threshold];
+    mutationlikelihood = MUTATIONLIKELIHOOD[threshold];
+
+    // large cohort: keep the total size of the genepool (population size x genome size) about the same as for LARGE_COHORT_RECORDS,
+    // down to the minimum population size, and shrink the tournament along with the population
+    if(numRecords > LARGE_COHORT_RECORDS) {
+        populationsize = std::max(MIN_POPULATIONSIZE, int((static_cast<long long>(POPULATIONSIZE[threshold]) * LARGE_COHORT_RECORDS) / numRecords));
+    }
+    tournamentsize = std::clamp((TOURNAMENTSIZE * populationsize) / POPULATIONSIZE[threshold], MIN_TOURNAMENTSIZE, TOURNAMENTSIZE);
+}
+
+
+//////////////////
+// Shrink the working values set for the whole population down to a smaller population (e.g., one island of it), with the tournament shrinking along with the population
+//////////////////
+void GA::setReducedPopulationSize(const int reducedPopulationSize)
+{
+    tournamentsize = std::clamp(int((static_cast<long long>(tournamentsize) * reducedPopulationSize) / populationsize), MIN_TOURNAMENTSIZE, tournamentsize);
+    populationsize = reducedPopulationSize;
+}
+
+int GA::numAncestors() const
+{
+    int numAncestors = 2;   // always track mom & dad
+    for(int generation = 0; generation < numgenerationsofancestors; ++generation) {
+        numAncestors += (4 << generation);   // add 2^(n+1) for each level of (great)grandparents
+    }
+    return numAncestors;
 }
 
 
 //////////////////
 // Clone one parent from the genepool into new genepool
 //////////////////
-void GA::clone(const int *const parent, const int *const ancestors, const int parentsIndex, int child[], int parentage[], const int genomeSize)
+void GA::clone(const int *const parent, const int *const ancestors, const int parentsIndex, int child[], int parentage[], const int genomeSize) const
 {
     for(int ID = 0; ID < genomeSize; ID++) {
         child[ID] = parent[ID];
@@ -48,7 +116,7 @@ void GA::clone(const int *const parent, const int *const ancestors, const int pa
 // Select two parents from the genepool using tournament selection
 //////////////////
 void GA::tournamentSelectParents(const int *const *const genePool, const int *const orderedIndex, const int *const *const ancestors,
-                                 const int *&mom, const int *&dad, int parentage[], std::mt19937 &pRNG)
+                                 const int *&mom, const int *&dad, int parentage[], std::mt19937 &pRNG) const
 {
     std::uniform_int_distribution<unsigned int> randProbability(1, 100);
     std::uniform_int_distribution<unsigned int> randGenome(0, populationsize-1);
@@ -60,10 +128,10 @@ void GA::tournamentSelectParents(const int *const *const genePool, const int *co
         //get tournamentSize random values in the range 0 -> populationSize-1 and then sort them
         //these represent ordinal genome within the genepool (i.e., 0 = top scoring genome in genepool, 1 = 2nd highest scoring genome in genepool)
         unsigned int tourneyPick[TOURNAMENTSIZE];
-        for(auto &player : tourneyPick) {
-            player = randGenome(pRNG);
+        for(int player = 0; player < tournamentsize; player++) {
+            tourneyPick[player] = randGenome(pRNG);
         }
-        std::sort(tourneyPick, tourneyPick+TOURNAMENTSIZE);
+        std::sort(tourneyPick, tourneyPick+tournamentsize);
 
         //pick first genome from tournament, most likely from the beginning so that best genomes are more likely have offspring
         //for now, index represent which ordinal genome from the tournament is selected (i.e., 0 = top scoring genome in tournament, 1 = 2nd highest scoring, etc.)
@@ -79,13 +147,13 @@ void GA::tournamentSelectParents(const int *const *const genePool, const int *co
 
         //convert momsindex from ordinal value within tournament to index within the genepool
         //using '%tournamentSize' to wrap around from end of tournament back to the beginning, just in case
-        momsindex = orderedIndex[tourneyPick[momsindex % TOURNAMENTSIZE]];
+        momsindex = orderedIndex[tourneyPick[momsindex % tournamentsize]];
         const auto &momsancestors = ancestors[momsindex];
 
         //now make sure partners do not have any common ancestors going back numgenerationsofancestors generations
         bool potentialMatesAreRelated;
         do {
-            const auto &dadsancestors = ancestors[orderedIndex[tourneyPick[dadsindex % TOURNAMENTSIZE]]];
+            const auto &dadsancestors = ancestors[orderedIndex[tourneyPick[dadsindex % tournamentsize]]];
             potentialMatesAreRelated = false;
             int startAncestor = 0, endAncestor = 2;
             for(int generation = 0; generation < numgenerationsofancestors && !potentialMatesAreRelated; generation++) {
@@ -95,7 +163,7 @@ void GA::tournamentSelectParents(const int *const *const genePool, const int *co
                         if(momsAncestor == dadsancestors[dadsAncestorIndex]) {
                             potentialMatesAreRelated = true;
                             dadsindex++;
-                            if(dadsindex >= TOURNAMENTSIZE) {
+                            if(dadsindex >= tournamentsize) {
                                 failedTournament = true;
                             }
                         }
@@ -107,7 +175,7 @@ void GA::tournamentSelectParents(const int *const *const genePool, const int *co
         } while(potentialMatesAreRelated && !failedTournament);
 
         //as done for momsindex before, convert dadsindex from ordinal value within tournament to index within the genepool
-        dadsindex = orderedIndex[tourneyPick[dadsindex % TOURNAMENTSIZE]];
+        dadsindex = orderedIndex[tourneyPick[dadsindex % tournamentsize]];
     } while(failedTournament);
 
 
@@ -139,8 +207,8 @@ void GA::tournamentSelectParents(const int *const *const genePool, const int *co
 //////////////////
 // Use ordered crossover to make child from mom and dad, splitting at random team boundaries within the genome
 //////////////////
-void GA::mate(const int *const mom, const int *const dad, const int teamStartPositions[],
-              const int numTeams, int child[], const long long genomeSize, std::mt19937 &pRNG)
+std::pair<int, int> GA::mate(const int *const mom, const int *const dad, const int teamStartPositions[],
+                             const int numTeams, int child[], const long long genomeSize, uint64_t inMomsAllele[], std::mt19937 &pRNG) const
 {
 
     //randomly choose two team boundaries in the genome from which to cut an allele
@@ -156,38 +224,58 @@ void GA::mate(const int *const mom, const int *const dad, const int teamStartPos
     }
 
     //Now, need to find positions in genome to start and end allele--the "breaks" before startTeam and endTeam
-    const unsigned int start = teamStartPositions[startTeam];
-    const unsigned int end = teamStartPositions[endTeam];
+    const long long start = teamStartPositions[startTeam];
+    const long long end = teamStartPositions[endTeam];
 
-    //copy all of dad into child
-    std::copy(dad, dad + genomeSize, child);
+    //mark each value in mom's allele
+    for(long long i = start; i < end; i++) {
+        const auto value = static_cast<unsigned int>(mom[i]);
+        inMomsAllele[value / 64] |= (uint64_t(1) << (value % 64));
+    }
 
-    //remove from the child each value in mom's allele
-    for(unsigned int i = 0; i < (end-start); i++) {
-        (void)std::remove(child, child + genomeSize, mom[start+i]);
+    //copy dad into child, in order, skipping each marked value and leaving room for the allele
+    //(each of dad's values is written to the next open site, which only moves on if the value wasn't marked;
+    // so the writes of marked values are either overwritten or land in the allele, where mom's allele is copied next)
+    long long dadSite = 0;
+    for(long long childSite = 0; childSite < start; dadSite++) {
+        const auto value = static_cast<unsigned int>(dad[dadSite]);
+        child[childSite] = int(value);
+        childSite += 1 - ((inMomsAllele[value / 64] >> (value % 64)) & 1u);
+    }
+    for(long long childSite = end; childSite < genomeSize; dadSite++) {
+        const auto value = static_cast<unsigned int>(dad[dadSite]);
+        child[childSite] = int(value);
+        childSite += 1 - ((inMomsAllele[value / 64] >> (value % 64)) & 1u);
     }
 
-    //make room for mom's allele
-    std::move_backward(child + start, child + start + genomeSize - end, child + genomeSize);
+    //unmark (all of the bitmap's other words are already 0)
+    for(long long i = start; i < end; i++) {
+        inMomsAllele[static_cast<unsigned int>(mom[i]) / 64] = 0;
+    }
 
     //copy mom's allele into child
     std::copy(mom + start, mom + end, child + start);
+
+    return {int(startTeam), int(endTeam)};
 }
 
 
 //////////////////
 // Randomly swap two sites in given genome
 //////////////////
-void GA::mutate(int genome[], const long long genomeSize, std::mt19937 &pRNG)
+std::pair<long long, long long> GA::mutate(int genome[], const long long genomeSize, std::mt19937 &pRNG) const
 {
     std::uniform_int_distribution<unsigned long long> randSite(0, genomeSize-1);
-    std::swap(genome[randSite(pRNG)], genome[randSite(pRNG)]);
+    const auto siteA = static_cast<long long>(randSite(pRNG));
+    const auto siteB = static_cast<long long>(randSite(pRNG));
+    std::swap(genome[siteA], genome[siteB]);
+    return {siteA, siteB};
 }
 
 //////////////////
 // Swap a random student from the worst-scoring team with a random student from any other team
 //////////////////
-void GA::mutateWorstTeam(int genome[], const int teamStartPositions[], const int worstTeam, const long long genomeSize, std::mt19937 &pRNG)
+std::pair<long long, long long> GA::mutateWorstTeam(int genome[], const int teamStartPositions[], const int worstTeam, const long long genomeSize, std::mt19937 &pRNG) const
 {
     const int worstTeamStart = teamStartPositions[worstTeam];
     const int worstTeamEnd = teamStartPositions[worstTeam + 1];
@@ -195,7 +283,7 @@ void GA::mutateWorstTeam(int genome[], const int teamStartPositions[], const int
 
     // If the worst team is the only team, there is no other team to swap in to
     if(worstTeamSize >= genomeSize) {
-        return;
+        return {worstTeamStart, worstTeamStart};
     }
 
     // pick a random student in the worst team
@@ -210,6 +298,7 @@ void GA::mutateWorstTeam(int genome[], const int teamStartPositions[], const int
     }
 
     std::swap(genome[siteA], genome[siteB]);
+    return {siteA, siteB};
 }
 
 
@@ -278,12 +367,9 @@ void swap(GA::GenePool &a, GA::GenePool &b) noexcept
 // AncestorPool RAII wrapper
 //////////////////
 GA::AncestorPool::AncestorPool(const GA &ga)
-    : popSize(ga.populationsize), numAncest(2)   // always track mom & dad
+    : popSize(ga.populationsize), numAncest(ga.numAncestors())
     , dataVals(nullptr), rows(nullptr)
 {
-    for(int generation = 0; generation < ga.numgenerationsofancestors; ++generation) {
-        numAncest += (4 << generation);   // add 2^(n+1) for each level of (great)grandparents
-    }
     dataVals = new int[static_cast<size_t>(popSize) * numAncest];
     rows = new int*[popSize];
     for(int i = 0; i < popSize; ++i) {
@@ -338,3 +424,108 @@ void swap(GA::AncestorPool &a, GA::AncestorPool &b) noexcept
     std::swap(a.dataVals, b.dataVals);
     std::swap(a.rows, b.rows);
 }
+
+
+GA::ScoreRanker::ScoreRanker(const int maxNumGenomes)
+    : keys(maxNumGenomes), sortedKeys(maxNumGenomes), indexes(maxNumGenomes), sortedIndexes(maxNumGenomes)
+    , digitCounts(maxNumThreads()), topKeys(maxNumGenomes)
+{
+}
+
+uint32_t GA::ScoreRanker::rankKey(const float score)
+{
+    // as unsigned integers, the bits of positive floats are in the same order as the floats and the bits of negative floats in the opposite order,
+    // so flip all but the sign bit of the positive floats (and adding 0 makes -0 into +0)
+    const auto bits = std::bit_cast<uint32_t>(score + 0.0f);
+    return ((bits & 0x80000000u) != 0)? bits : (~bits & 0x7FFFFFFFu);
+}
+
+//////////////////
+// Rank the genomes by score with a radix sort of their keys, one digit per pass from least to most significant
+// Each thread counts the digits in its own part of the keys; from all of the counts, each thread gets where in the output each of its digits goes,
+// and then it moves its keys there, in order. A pass is skipped if every key has the same digit (as is common for the most significant digits).
+//////////////////
+void GA::ScoreRanker::rank(const float scores[], const int numGenomes, int orderedIndex[])
+{
+    const int numThreadsWanted = inParallelRegion()? 1 : std::clamp(numGenomes / MIN_GENOMES_PER_THREAD, 1, int(digitCounts.size()));
+    const auto &sharedNumGenomes = numGenomes;
+    auto &sharedDigitCounts = digitCounts;
+    uint32_t *const sharedKeys[2] = {keys.data(), sortedKeys.data()};
+    int *const sharedIndexes[2] = {indexes.data(), sortedIndexes.data()};
+    bool skipPass = false;
+
+#pragma omp parallel num_threads(numThreadsWanted) if(numThreadsWanted > 1) \
+        default(none) \
+        shared(scores, orderedIndex, sharedNumGenomes, sharedDigitCounts, sharedKeys, sharedIndexes, skipPass)
+    {
+        const int thread = threadNum();
+        const int numThreads = numThreadsInTeam();
+        const int first = int((static_cast<long long>(sharedNumGenomes) * thread) / numThreads);
+        const int end = int((static_cast<long long>(sharedNumGenomes) * (thread + 1)) / numThreads);
+        auto &counts = sharedDigitCounts[thread];
+
+        int from = 0;       // which of the two buffers holds this pass's input
+        for(int genome = first; genome < end; genome++) {
+            sharedKeys[from][genome] = rankKey(scores[genome]);
+            sharedIndexes[from][genome] = genome;
+        }
+
+        for(int pass = 0; pass < NUM_PASSES; pass++) {
+            const int shift = pass * RADIX_BITS;
+            const uint32_t *const keysIn = sharedKeys[from];
+            counts.fill(0);
+            for(int genome = first; genome < end; genome++) {
+                counts[(keysIn[genome] >> shift) & (RADIX - 1)]++;
+            }
+#pragma omp barrier
+#pragma omp single
+            {
+                // each digit goes after all of the smaller digits, and after the same digit from the earlier threads
+                skipPass = false;
+                int position = 0;
+                for(int digit = 0; digit < RADIX; digit++) {
+                    const int digitStart = position;
+                    for(int otherThread = 0; otherThread < numThreads; otherThread++) {
+                        const int count = sharedDigitCounts[otherThread][digit];
+                        sharedDigitCounts[otherThread][digit] = position;
+                        position += count;
+                    }
+                    skipPass = skipPass || ((position - digitStart) == sharedNumGenomes);
+                }
+            }
+            if(skipPass) {
+                continue;
+            }
+
+            const int *const indexesIn = sharedIndexes[from];
+            uint32_t *const keysOut = sharedKeys[1 - from];
+            int *const indexesOut = sharedIndexes[1 - from];
+            for(int genome = first; genome < end; genome++) {
+                const int position = counts[(keysIn[genome] >> shift) & (RADIX - 1)]++;
+                keysOut[position] = keysIn[genome];
+                indexesOut[position] = indexesIn[genome];
+            }
+            from = 1 - from;
+#pragma omp barrier
+        }
+
+        std::copy(sharedIndexes[from] + first, sharedIndexes[from] + end, orderedIndex + first);
+    }
+}
+
+//////////////////
+// Rank only the top genomes, by selecting them (in linear time) and then sorting just those
+// Each genome's key is followed by its index in a 64 bit value, so that the order--including of equal scores--is the same as from rank()
+//////////////////
+void GA::ScoreRanker::rankTop(const float scores[], const int numGenomes, const int topK, int orderedIndex[])
+{
+    const int numTop = std::clamp(topK, 0, numGenomes);
+    for(int genome = 0; genome < numGenomes; genome++) {
+        topKeys[genome] = (uint64_t(rankKey(scores[genome])) << 32) | uint32_t(genome);
+    }
+    std::nth_element(topKeys.begin(), topKeys.begin() + numTop, topKeys.begin() + numGenomes);
+    std::sort(topKeys.begin(), topKeys.begin() + numTop);
+    for(int genome = 0; genome < numGenomes; genome++) {
+        orderedIndex[genome] = int(topKeys[genome] & 0xFFFFFFFFu);
+    }
+}
@@ -3,25 +3,36 @@
 
 // Code related to the Genetic Algorithm used in gruepr
 
+#include <array>
+#include <cstdint>
 #include <random>
 #include <utility>
+#include <vector>
 
 class GA
 {
 public:
     void setGAParameters(int numRecords);
+    // shrink the working values down to a smaller population: in the island model, one island of the population,
+    // or when optimizing within a time budget, the population that fits in the budget
+    void setReducedPopulationSize(int reducedPopulationSize);
+    int numAncestors() const;               // the number of ancestors tracked for each genome
 
     void clone(const int *const parent, const int *const ancestors, const int parentsIndex,
-               int child[], int parentage[], const int genomeSize);
+               int child[], int parentage[], const int genomeSize) const;
 
     void tournamentSelectParents(const int *const *const genePool, const int *const orderedIndex, const int *const *const ancestors,
-                                 const int *&mom, const int *&dad, int parentage[], std::mt19937 &pRNG);
+                                 const int *&mom, const int *&dad, int parentage[], std::mt19937 &pRNG) const;
 
-    void mate(const int *const mom, const int *const dad, const int teamStartPositions[],
-              const int numTeams, int child[], const long long genomeSize, std::mt19937 &pRNG);
+    // returns the range of teams [first, second) that the child got unchanged from mom
+    // inMomsAllele is scratch space, a bitmap (all 0) with a bit for every value that can be in a genome; it is left all 0
+    std::pair<int, int> mate(const int *const mom, const int *const dad, const int teamStartPositions[],
+                             const int numTeams, int child[], const long long genomeSize, uint64_t inMomsAllele[], std::mt19937 &pRNG) const;
+    static constexpr long long alleleBitmapWords(const long long numValues) {return (numValues + 63) / 64;}   // size of mate's inMomsAllele
 
-    void mutate(int genome[], const long long genomeSize, std::mt19937 &pRNG);
-    void mutateWorstTeam(int genome[], const int teamStartPositions[], const int worstTeam, const long long genomeSize, std::mt19937 &pRNG);
+    // each returns the two sites in the genome that were swapped
+    std::pair<long long, long long> mutate(int genome[], const long long genomeSize, std::mt19937 &pRNG) const;
+    std::pair<long long, long long> mutateWorstTeam(int genome[], const int teamStartPositions[], const int worstTeam, const long long genomeSize, std::mt19937 &pRNG) const;
 
     class GenePool {
     public:
@@ -77,10 +88,47 @@ public:
         int **rows = nullptr;
     };
 
-    inline static const int MAX_RECORDS = 1000;             // maximum number of records to optimally partition (this might be changable, but algortihm gets pretty slow as value gets bigger)
+    // Ranks genomes by score, largest to smallest, using a least significant digit radix sort (in parallel for a large enough population).
+    // Each score is mapped to an unsigned integer key that sorts in the opposite order of the scores (see rankKey),
+    // and since the sort is stable, genomes with equal scores are ranked in order of their index.
+    class ScoreRanker {
+    public:
+        explicit ScoreRanker(int maxNumGenomes);
+
+        // puts the indexes of genomes [0, numGenomes) into orderedIndex in order of score, largest to smallest
+        void rank(const float scores[], int numGenomes, int orderedIndex[]);
+        // puts the indexes of only the topK highest scoring genomes into orderedIndex[0, topK), in the same order as rank();
+        // the rest of orderedIndex is the other genomes' indexes, in no particular order
+        void rankTop(const float scores[], int numGenomes, int topK, int orderedIndex[]);
+
+        // an integer that is smaller for a higher score (-0 and +0 are the same score)
+        static uint32_t rankKey(float score);
+
+    private:
+        inline static const int RADIX_BITS = 8;
+        inline static const int RADIX = 1 << RADIX_BITS;
+        inline static const int NUM_PASSES = 32 / RADIX_BITS;
+        inline static const int MIN_GENOMES_PER_THREAD = 4096;      // a smaller population is ranked on fewer threads, down to just one
+
+        std::vector<uint32_t> keys, sortedKeys;
+        std::vector<int> indexes, sortedIndexes;
+        std::vector<std::array<int, RADIX>> digitCounts;            // for each thread, the count of each digit in its part of the keys
+        std::vector<uint64_t> topKeys;                              // for rankTop, each genome's key followed by its index
+    };
+
+    inline static const int MAX_RECORDS = 10000;            // maximum number of records to optimally partition
+    inline static const int LARGE_COHORT_RECORDS = 1000;    // above this many records, the population shrinks as the genome grows so that each generation's memory and time grow ~linearly
+    inline static const int MIN_POPULATIONSIZE = 2500;      // the smallest population, for the largest genomes
+    inline static const int MIN_TOURNAMENTSIZE = 20;
+    inline static const int MIN_ISLAND_POPULATIONSIZE = 250;// in the island model, the smallest population of an island (fewer islands are used if needed)
+    inline static const int MIGRATION_INTERVAL = 10;        // in the island model, every this many generations, each island's best genomes migrate to the next island...
+    inline static const int NUM_MIGRANTS = 3;               // ...where this many of them replace that island's worst genomes
+    inline static const int MIN_TIMEBUDGET_POPULATIONSIZE = 500;   // when optimizing within a time budget, the smallest population it can reduce to
+    inline static const int TIMEBUDGET_GENERATIONS = 100;   // ...and the population is reduced so that about this many generations fit in the budget
 
     inline static const int NUM_ELITES = 3;                 // from each generation, this many highest scoring genomes are directly cloned into the next generation. Some suggest elitism helps speed genetic algorithms, but can lead to premature convergence. Having at least 1 elite stabilizes the high score to end optimization
     inline static const int TOURNAMENTSIZE = 100;           // most of the next generation is created by mating pairs of parent genomes, each time chosen from genomes in a randomly selected tournament in the genepool
+                                                            // (this is the largest tournament; a smaller population uses a proportionally smaller one so that selection pressure stays the same)
     inline static const int MIN_GENERATIONS = 40;           // will keep optimizing for at least minGenerations
     inline static const int MAX_GENERATIONS = 500;          // will keep optimizing for at most maxGenerations
     inline static const int GENERATIONS_OF_STABILITY = 25;  // after minGenerations, if score has not improved for generationsOfStability, stop optimizing
@@ -88,6 +136,7 @@ public:
 
     // working values of algorithm constants, set when beginning an optimization and the genome size is known
     int populationsize = POPULATIONSIZE[3];
+    int tournamentsize = TOURNAMENTSIZE;
     unsigned int topgenomelikelihood = TOPGENOMELIKELIHOOD[3];
     int numgenerationsofancestors = NUMGENERATIONSOFANCESTORS[3];
     unsigned int mutationlikelihood = MUTATIONLIKELIHOOD[3];
@@ -0,0 +1,59 @@
+#include "allocationCounter.h"
+#include <atomic>
+#include <cstdlib>
+
+namespace {
+std::atomic<long long> numAllocations{0};
+}   // namespace
+
+#if defined(__GLIBC__)
+
+// glibc's own implementations, which the replacements below forward to
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t num, size_t size);
+void *__libc_realloc(void *ptr, size_t size);
+void __libc_free(void *ptr);
+
+void *malloc(size_t size)
+{
+    numAllocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t num, size_t size)
+{
+    numAllocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_calloc(num, size);
+}
+
+void *realloc(void *ptr, size_t size)
+{
+    numAllocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_realloc(ptr, size);
+}
+
+void free(void *ptr)
+{
+    __libc_free(ptr);
+}
+}
+
+bool AllocationCounter::isAvailable()
+{
+    return true;
+}
+
+#else
+
+bool AllocationCounter::isAvailable()
+{
+    return false;
+}
+
+#endif
+
+long long AllocationCounter::count()
+{
+    return numAllocations.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,13 @@
+#ifndef ALLOCATIONCOUNTER_H
+#define ALLOCATIONCOUNTER_H
+
+// Counts every heap allocation made by the process (on any thread), so that the benchmark can check that
+// scoring genomes doesn't allocate. Counting works by replacing malloc and friends, which is only done with glibc.
+
+namespace AllocationCounter
+{
+    bool isAvailable();
+    long long count();      // number of heap allocations made so far
+}
+
+#endif // ALLOCATIONCOUNTER_H
@@ -0,0 +1,26 @@
+#-------------------------------------------------
+#
+# gruepr-benchmark: time the team optimization on synthetic classes of students
+#
+#-------------------------------------------------
+
+gruepr_version = $$fromfile(../gruepr.pro, gruepr_version)
+copyright_year = $$fromfile(../gruepr.pro, copyright_year)
+
+TARGET = gruepr-benchmark
+TEMPLATE = app
+CONFIG += console
+CONFIG -= app_bundle
+
+include(../gruepr.pri)
+
+win32: LIBS += -lpsapi
+
+SOURCES += \
+    allocationCounter.cpp \
+    main.cpp \
+    syntheticRoster.cpp
+
+HEADERS += \
+    allocationCounter.h \
+    syntheticRoster.h
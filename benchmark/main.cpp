@@ -0,0 +1,1052 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+// gruepr-benchmark
+//
+// Times the team optimization on reproducible, randomly generated classes of students
+// with every type of teaming criterion, so that optimization speed can be compared between versions
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "allocationCounter.h"
+#include "syntheticRoster.h"
+#include "teamOptimizer.h"
+#include "teamingOptions.h"
+#include "criteria/assignmentPreferenceCriterion.h"
+#include "criteria/attributeCriterion.h"
+#include "criteria/URMIdentityCriterion.h"
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMap>
+#include <QMetaEnum>
+#include <QSet>
+#include <QTextStream>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <vector>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#if defined(Q_OS_WIN)
+#include <windows.h>
+#include <psapi.h>
+#elif defined(Q_OS_UNIX)
+#include <sys/resource.h>
+#endif
+
+namespace {
+
+QTextStream &outStream()
+{
+    static QTextStream stream(stdout);
+    return stream;
+}
+
+//////////////////
+// The peak resident memory of this process so far, in MB (a high-water mark, so class sizes should be benchmarked smallest to largest)
+//////////////////
+double peakRSSinMB()
+{
+#if defined(Q_OS_WIN)
+    PROCESS_MEMORY_COUNTERS counters;
+    if(GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return double(counters.PeakWorkingSetSize) / (1024 * 1024);
+    }
+    return 0;
+#elif defined(Q_OS_UNIX)
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+#if defined(Q_OS_MACOS)
+    return double(usage.ru_maxrss) / (1024 * 1024);    // bytes on macOS
+#else
+    return double(usage.ru_maxrss) / 1024;             // kilobytes on linux
+#endif
+#else
+    return 0;
+#endif
+}
+
+//////////////////
+// Average time, in microseconds, of one call to the function, repeating it until at least minimumTime (in ms) has elapsed
+//////////////////
+template<typename Function>
+double microsecondsPerCall(Function &&function, const qint64 minimumTime)
+{
+    QElapsedTimer timer;
+    timer.start();
+    long long numCalls = 0;
+    do {
+        function(numCalls);
+        numCalls++;
+    } while(timer.elapsed() < minimumTime);
+    return double(timer.nsecsElapsed()) / 1000.0 / double(numCalls);
+}
+
+//////////////////
+// Average number of heap allocations per call of the function, over numCalls calls (the function should already have been called once, to warm up)
+//////////////////
+template<typename Function>
+double allocationsPerCall(Function &&function, const int numCalls)
+{
+    const long long allocationsBefore = AllocationCounter::count();
+    for(int call = 0; call < numCalls; call++) {
+        function(call);
+    }
+    return double(AllocationCounter::count() - allocationsBefore) / numCalls;
+}
+
+int maxNumThreads()
+{
+#ifdef _OPENMP
+    return omp_get_max_threads();
+#else
+    return 1;
+#endif
+}
+
+void setNumThreads(const int numThreads)
+{
+#ifdef _OPENMP
+    omp_set_num_threads(numThreads);
+#else
+    Q_UNUSED(numThreads)
+#endif
+}
+
+QString allocationsText(const double allocations)
+{
+    return AllocationCounter::isAvailable()? (", " + QString::number(allocations, 'f', 1) + QObject::tr(" allocations/genome")) : QString();
+}
+
+QString criterionName(const Criterion *const criterion, const DataOptions *const dataOptions)
+{
+    if(criterion->criteriaType == Criterion::CriteriaType::attributeQuestion) {
+        const int attribute = static_cast<const AttributeCriterion*>(criterion)->attributeIndex;
+        return "attribute " + QString::number(attribute + 1) + " (" +
+               QString(QMetaEnum::fromType<Criterion::AttributeDiversity>().valueToKey(int(static_cast<const AttributeCriterion*>(criterion)->diversity))) +
+               ", " + QStringList({"ordered", "timezone", "categorical", "multicategorical", "multiordered", "numerical"})
+                          .at(int(dataOptions->attributeType.at(attribute))) + ")";
+    }
+    return QMetaEnum::fromType<Criterion::CriteriaType>().valueToKey(int(criterion->criteriaType));
+}
+
+//////////////////
+// The assignment preference solver as AssignmentPreferenceCriterion formerly did it for every genome, building its utility and cost matrices
+// as lists of lists and solving with a textbook Hungarian algorithm that allocates as it goes, to check that the new solver finds
+// an equally good assignment and to compare its speed; returns the sum of each team's normalized score times its size
+//////////////////
+float referenceAssignmentSolve(const QList<StudentRecord> &students, const int teammates[], const int numTeams, const int teamSizes[],
+                               const QMap<QString, int> &optionNameToIndex, const int numRankedChoices)
+{
+    const int dim = std::max(numTeams, int(optionNameToIndex.size()));
+    QList<QList<float>> utilityMatrix(dim, QList<float>(dim, 0.0f));
+    int studentNum = 0;
+    for(int team = 0; team < numTeams; team++) {
+        for(int m = 0; m < teamSizes[team]; m++) {
+            const auto &prefs = students.at(teammates[studentNum]).assignmentPreferences;
+            for(int r = 0; r < prefs.size() && r < numRankedChoices; r++) {
+                const auto it = optionNameToIndex.find(prefs[r]);
+                if(it != optionNameToIndex.end()) {
+                    utilityMatrix[team][it.value()] += static_cast<float>(numRankedChoices - r);
+                }
+            }
+            studentNum++;
+        }
+    }
+    float maxUtility = 0.0f;
+    for(const auto &row : std::as_const(utilityMatrix)) {
+        maxUtility = std::max(maxUtility, *std::max_element(row.cbegin(), row.cend()));
+    }
+    QList<QList<float>> costMatrix(dim, QList<float>(dim, 0.0f));
+    for(int i = 0; i < dim; i++) {
+        for(int j = 0; j < dim; j++) {
+            costMatrix[i][j] = maxUtility - utilityMatrix[i][j];
+        }
+    }
+
+    const float INF = std::numeric_limits<float>::max();
+    QList<float> u(dim + 1, 0), v(dim + 1, 0);
+    QList<int> p(dim + 1, 0), way(dim + 1, 0);
+    for(int i = 1; i <= dim; i++) {
+        p[0] = i;
+        int j0 = 0;
+        QList<float> minv(dim + 1, INF);
+        QList<bool> used(dim + 1, false);
+        do {
+            used[j0] = true;
+            const int i0 = p[j0];
+            float delta = INF;
+            int j1 = -1;
+            for(int j = 1; j <= dim; j++) {
+                if(!used[j]) {
+                    const float cur = costMatrix[i0 - 1][j - 1] - u[i0] - v[j];
+                    if(cur < minv[j]) {
+                        minv[j] = cur;
+                        way[j] = j0;
+                    }
+                    if(minv[j] < delta) {
+                        delta = minv[j];
+                        j1 = j;
+                    }
+                }
+            }
+            for(int j = 0; j <= dim; j++) {
+                if(used[j]) {
+                    u[p[j]] += delta;
+                    v[j] -= delta;
+                }
+                else {
+                    minv[j] -= delta;
+                }
+            }
+            j0 = j1;
+        } while(p[j0] != 0);
+        do {
+            const int j1 = way[j0];
+            p[j0] = p[j1];
+            j0 = j1;
+        } while(j0 != 0);
+    }
+
+    float total = 0.0f;
+    for(int j = 1; j <= dim; j++) {
+        const int team = p[j] - 1;
+        if((team >= 0) && (team < numTeams) && (teamSizes[team] * numRankedChoices > 0)) {
+            total += utilityMatrix[team][j - 1] / float(teamSizes[team] * numRankedChoices) * float(teamSizes[team]);
+        }
+    }
+    return total;
+}
+
+//////////////////
+// Time the assignment preference solver on its own for a class with numTeams teams (and as many assignment options):
+// solving from scratch, as when scoring a genome for display, versus starting from the parent's solution, as in the optimization,
+// and versus the former solver, after checking that each child's assignment from the parent's solution is as good as from scratch and the former solver's
+//////////////////
+QJsonObject timeAssignmentSolver(const int numTeams, const int idealTeamSize, const std::mt19937::result_type seed, const qint64 minimumTime)
+{
+    auto &out = outStream();
+    const int numStudents = numTeams * idealTeamSize;
+    const SyntheticRoster roster(numStudents, idealTeamSize, seed);
+    AssignmentPreferenceCriterion criterion(&roster.dataOptions, Criterion::CriteriaType::assignmentPreference);
+    criterion.weight = 1;
+    criterion.penalizeNoOneRanked = true;
+    criterion.prepareForOptimization(roster.students.constData(), numStudents, &roster.dataOptions);
+    const StudentSnapshot snapshot(roster.students.constData(), numStudents, &roster.dataOptions);
+    const auto workspace = criterion.createWorkspace(snapshot, numTeams, roster.teamSizes.constData());
+    QList<float> criteriaScores(numTeams), penaltyPoints(numTeams);
+
+    // a parent genome, then children that differ from it by a mutation or that were made by mating it (as dad) with another genome
+    std::mt19937 pRNG(seed);
+    QList<int> parent = roster.studentIndexes;
+    std::shuffle(parent.begin(), parent.end(), pRNG);
+    QList<int> otherParent = roster.studentIndexes;
+    std::shuffle(otherParent.begin(), otherParent.end(), pRNG);
+    QList<int> teamStartPositions(numTeams + 1, 0);
+    for(int team = 0; team < numTeams; team++) {
+        teamStartPositions[team + 1] = teamStartPositions[team] + roster.teamSizes.at(team);
+    }
+    GA ga;
+    QList<QList<int>> mutants(16, parent), offspring(16, parent);
+    for(auto &mutant : mutants) {
+        ga.mutate(mutant.data(), numStudents, pRNG);
+    }
+    auto inMomsAllele = std::make_unique<uint64_t[]>(GA::alleleBitmapWords(numStudents));
+    for(auto &child : offspring) {
+        ga.mate(otherParent.constData(), parent.constData(), teamStartPositions.constData(), numTeams, child.data(), numStudents, inMomsAllele.get(), pRNG);
+    }
+
+    const auto memoryWords = size_t((criterion.genomeMemorySize(numTeams) + sizeof(uint64_t) - 1) / sizeof(uint64_t));
+    std::vector<uint64_t> parentMemory(memoryWords, 0), childMemory(memoryWords, 0);
+    const auto solve = [&](const QList<int> &genome, std::byte *const memory) {
+        workspace->genomeMemory = memory;
+        criterion.calculateScore(snapshot, genome.constData(), numTeams, roster.teamSizes.constData(), nullptr, &roster.dataOptions,
+                                 criteriaScores, penaltyPoints, workspace.get());
+    };
+    solve(parent, reinterpret_cast<std::byte*>(parentMemory.data()));
+
+    // the sum of each team's score times its size is the total utility of the assignment (over the number of ranked choices), the same for any optimal assignment
+    QSet<QString> optionNames;
+    int numRankedChoices = 0;
+    for(const auto &student : roster.students) {
+        numRankedChoices = std::max(numRankedChoices, int(student.assignmentPreferences.size()));
+        for(const auto &option : student.assignmentPreferences) {
+            if(!option.isEmpty()) {
+                optionNames.insert(option);
+            }
+        }
+    }
+    QMap<QString, int> optionNameToIndex;
+    for(const auto &option : std::as_const(optionNames)) {
+        optionNameToIndex.insert(option, int(optionNameToIndex.size()));
+    }
+    const auto totalScore = [&]() {
+        float total = 0.0f;
+        for(int team = 0; team < numTeams; team++) {
+            total += criteriaScores.at(team) * float(roster.teamSizes.at(team));
+        }
+        return total;
+    };
+    QList<QList<int>> children = mutants;
+    children << offspring;
+    int numMismatches = 0;
+    for(const auto &child : std::as_const(children)) {
+        solve(child, nullptr);
+        const float fullSolveTotal = totalScore();
+        childMemory = parentMemory;
+        solve(child, reinterpret_cast<std::byte*>(childMemory.data()));
+        const float fromParentTotal = totalScore();
+        const float referenceTotal = referenceAssignmentSolve(roster.students, child.constData(), numTeams, roster.teamSizes.constData(),
+                                                              optionNameToIndex, numRankedChoices);
+        const float tolerance = 1.0E-4f * std::max(1.0f, std::abs(fullSolveTotal));
+        if((std::abs(fromParentTotal - fullSolveTotal) > tolerance) || (std::abs(referenceTotal - fullSolveTotal) > tolerance)) {
+            numMismatches++;
+        }
+    }
+
+    const double fullSolveTime = microsecondsPerCall([&](const long long call) {
+        solve(mutants.at(call % mutants.size()), nullptr);
+    }, minimumTime);
+    const double afterMutationTime = microsecondsPerCall([&](const long long call) {
+        childMemory = parentMemory;
+        solve(mutants.at(call % mutants.size()), reinterpret_cast<std::byte*>(childMemory.data()));
+    }, minimumTime);
+    const double afterMatingTime = microsecondsPerCall([&](const long long call) {
+        childMemory = parentMemory;
+        solve(offspring.at(call % offspring.size()), reinterpret_cast<std::byte*>(childMemory.data()));
+    }, minimumTime);
+    const double formerSolveTime = microsecondsPerCall([&](const long long call) {
+        referenceAssignmentSolve(roster.students, mutants.at(call % mutants.size()).constData(), numTeams, roster.teamSizes.constData(),
+                                 optionNameToIndex, numRankedChoices);
+    }, minimumTime);
+
+    out << "\n" << QObject::tr("assignment preference solver, ") << numTeams << QObject::tr(" teams and options") << Qt::endl;
+    out << "    " << QObject::tr("formerly").leftJustified(36, ' ') << qSetRealNumberPrecision(1) << formerSolveTime << QObject::tr(" us/genome") << Qt::endl;
+    out << "    " << QObject::tr("solved from scratch").leftJustified(36, ' ') << qSetRealNumberPrecision(1) << fullSolveTime << QObject::tr(" us/genome") << Qt::endl;
+    out << "    " << QObject::tr("from parent, after a mutation").leftJustified(36, ' ') << qSetRealNumberPrecision(1) << afterMutationTime << QObject::tr(" us/genome")
+        << " (" << (fullSolveTime / afterMutationTime) << QObject::tr("x faster)") << Qt::endl;
+    out << "    " << QObject::tr("from parent, after mating").leftJustified(36, ' ') << qSetRealNumberPrecision(1) << afterMatingTime << QObject::tr(" us/genome")
+        << " (" << (fullSolveTime / afterMatingTime) << QObject::tr("x faster)") << Qt::endl;
+    out << "    " << (children.size() - numMismatches) << " / " << children.size()
+        << QObject::tr(" children assigned as well from the parent's solution as from scratch and by the former solver") << Qt::endl;
+
+    return {{"teams", numTeams}, {"formerMicroseconds", formerSolveTime}, {"fullSolveMicroseconds", fullSolveTime},
+            {"afterMutationMicroseconds", afterMutationTime}, {"afterMatingMicroseconds", afterMatingTime},
+            {"childrenChecked", int(children.size())}, {"childrenMismatched", numMismatches}};
+}
+
+//////////////////
+// The ordered crossover as GA::mate formerly did it, removing each of the values in mom's allele from a copy of dad one by one
+// (O(genome size x allele length)), to check that GA::mate makes exactly the same children and to compare its speed
+//////////////////
+void referenceCrossover(const int *const mom, const int *const dad, const int start, const int end, int child[], const int genomeSize)
+{
+    std::copy(dad, dad + genomeSize, child);
+    for(int i = start; i < end; i++) {
+        (void)std::remove(child, child + genomeSize, mom[i]);
+    }
+    std::move_backward(child + start, child + start + genomeSize - end, child + genomeSize);
+    std::copy(mom + start, mom + end, child + start);
+}
+
+//////////////////
+// Time GA::mate for a genome of numStudents students, against the reference crossover, after checking on numChecks children
+// that each child is a permutation of the students and is identical to the reference crossover's child
+//////////////////
+QJsonObject timeCrossover(const int numStudents, const int idealTeamSize, const std::mt19937::result_type seed, const qint64 minimumTime)
+{
+    auto &out = outStream();
+    const int numTeams = std::max(1, numStudents / idealTeamSize) + (((numStudents % idealTeamSize) != 0)? 1 : 0);
+    QList<int> teamStartPositions(numTeams + 1, 0);
+    for(int team = 0; team < numTeams; team++) {
+        teamStartPositions[team + 1] = teamStartPositions[team] + (numStudents / numTeams) + ((team < (numStudents % numTeams))? 1 : 0);
+    }
+
+    std::mt19937 pRNG(seed);
+    QList<QList<int>> parents(16, QList<int>(numStudents));
+    for(auto &parent : parents) {
+        std::iota(parent.begin(), parent.end(), 0);
+        std::shuffle(parent.begin(), parent.end(), pRNG);
+    }
+    GA ga;
+    auto inMomsAllele = std::make_unique<uint64_t[]>(GA::alleleBitmapWords(numStudents));
+    QList<int> child(numStudents), referenceChild(numStudents), sortedChild(numStudents), students(numStudents);
+    std::iota(students.begin(), students.end(), 0);
+
+    const int numChecks = std::max(10, 200000 / numStudents);
+    int numMismatches = 0;
+    for(int check = 0; check < numChecks; check++) {
+        const auto &mom = parents.at(check % parents.size());
+        const auto &dad = parents.at((check + 1 + (check / parents.size())) % parents.size());
+        const auto [startTeam, endTeam] = ga.mate(mom.constData(), dad.constData(), teamStartPositions.constData(), numTeams, child.data(), numStudents,
+                                                  inMomsAllele.get(), pRNG);
+        referenceCrossover(mom.constData(), dad.constData(), teamStartPositions.at(startTeam), teamStartPositions.at(endTeam), referenceChild.data(), numStudents);
+        sortedChild = child;
+        std::sort(sortedChild.begin(), sortedChild.end());
+        if((child != referenceChild) || (sortedChild != students)) {
+            numMismatches++;
+        }
+    }
+
+    const double crossoverTime = microsecondsPerCall([&](const long long call) {
+        ga.mate(parents.at(call % parents.size()).constData(), parents.at((call + 1) % parents.size()).constData(), teamStartPositions.constData(), numTeams,
+                child.data(), numStudents, inMomsAllele.get(), pRNG);
+    }, minimumTime);
+    std::uniform_int_distribution<int> randTeam(0, numTeams);
+    const double referenceTime = microsecondsPerCall([&](const long long call) {
+        const int teamA = randTeam(pRNG);
+        const int teamB = randTeam(pRNG);
+        referenceCrossover(parents.at(call % parents.size()).constData(), parents.at((call + 1) % parents.size()).constData(),
+                           teamStartPositions.at(std::min(teamA, teamB)), teamStartPositions.at(std::max(teamA, teamB)), child.data(), numStudents);
+    }, minimumTime);
+
+    out << "    " << (QString::number(numStudents) + QObject::tr(" students: ")).leftJustified(18, ' ') << qSetRealNumberPrecision(2) << crossoverTime
+        << QObject::tr(" us/child (") << (crossoverTime * 1000 / numStudents) << QObject::tr(" ns per student; formerly ") << referenceTime
+        << QObject::tr(" us/child); ") << (numChecks - numMismatches) << " / " << numChecks << QObject::tr(" children identical to the former crossover") << Qt::endl;
+
+    return {{"students", numStudents}, {"microsecondsPerChild", crossoverTime}, {"formerMicrosecondsPerChild", referenceTime},
+            {"childrenChecked", numChecks}, {"childrenMismatched", numMismatches}};
+}
+
+//////////////////
+// Time the ranking of a generation of populationSize genome scores by GA::ScoreRanker--all of them, and only the top NUM_ELITES--
+// against the std::sort of the genome indexes that was formerly used, after checking that each ranking is the same as a stable sort's
+//////////////////
+QJsonObject timeRanking(const int populationSize, const std::mt19937::result_type seed, const qint64 minimumTime)
+{
+    auto &out = outStream();
+
+    // scores like those of a generation: mostly spread around a typical score, with some repeats and some heavily penalized genomes
+    std::mt19937 pRNG(seed);
+    std::normal_distribution<float> randScore(60.0f, 15.0f);
+    std::uniform_int_distribution<int> randPercent(1, 100);
+    QList<QList<float>> generations(8, QList<float>(populationSize));
+    for(auto &scores : generations) {
+        for(auto &score : scores) {
+            const int roll = randPercent(pRNG);
+            score = (roll <= 5)? -100.0f : ((roll <= 15)? std::round(randScore(pRNG)) : randScore(pRNG));
+        }
+    }
+    GA::ScoreRanker ranker(populationSize);
+    QList<int> orderedIndex(populationSize), referenceIndex(populationSize);
+
+    int numMismatches = 0;
+    for(const auto &scores : std::as_const(generations)) {
+        std::iota(referenceIndex.begin(), referenceIndex.end(), 0);
+        std::stable_sort(referenceIndex.begin(), referenceIndex.end(), [&scores](const int i, const int j){return (scores[i] > scores[j]);});
+        ranker.rank(scores.constData(), populationSize, orderedIndex.data());
+        numMismatches += (orderedIndex != referenceIndex)? 1 : 0;
+        ranker.rankTop(scores.constData(), populationSize, GA::NUM_ELITES, orderedIndex.data());
+        numMismatches += std::equal(orderedIndex.cbegin(), orderedIndex.cbegin() + GA::NUM_ELITES, referenceIndex.cbegin())? 0 : 1;
+    }
+
+    const double rankTime = microsecondsPerCall([&](const long long call) {
+        ranker.rank(generations.at(call % generations.size()).constData(), populationSize, orderedIndex.data());
+    }, minimumTime);
+    const double rankTopTime = microsecondsPerCall([&](const long long call) {
+        ranker.rankTop(generations.at(call % generations.size()).constData(), populationSize, GA::NUM_ELITES, orderedIndex.data());
+    }, minimumTime);
+    const double sortTime = microsecondsPerCall([&](const long long call) {
+        const auto &scores = generations.at(call % generations.size());
+        std::sort(orderedIndex.begin(), orderedIndex.end(), [&scores](const int i, const int j){return (scores[i] > scores[j]);});
+    }, minimumTime);
+
+    out << "    " << (QString::number(populationSize) + QObject::tr(" genomes: ")).leftJustified(18, ' ') << qSetRealNumberPrecision(1) << rankTime
+        << QObject::tr(" us/generation (top ") << GA::NUM_ELITES << QObject::tr(" only: ") << rankTopTime << QObject::tr(" us; formerly ") << sortTime
+        << QObject::tr(" us); ") << ((2 * generations.size()) - numMismatches) << " / " << (2 * generations.size())
+        << QObject::tr(" rankings identical to a stable sort") << Qt::endl;
+
+    return {{"populationSize", populationSize}, {"microsecondsPerGeneration", rankTime}, {"topElitesMicrosecondsPerGeneration", rankTopTime},
+            {"formerMicrosecondsPerGeneration", sortTime}, {"rankingsChecked", 2 * generations.size()}, {"rankingsMismatched", numMismatches}};
+}
+
+//////////////////
+// Check the compiled identity rules of URMIdentityCriterion, with rules naming more identities than fit in a rule's bitmask,
+// against the comparison of the response strings that was formerly used, on numTeamSets random team sets
+//////////////////
+QJsonObject checkIdentityRules(const int numIdentities, const int numTeamSets, const int idealTeamSize, const std::mt19937::result_type seed)
+{
+    auto &out = outStream();
+
+    DataOptions dataOptions;
+    for(int identity = 1; identity <= numIdentities; identity++) {
+        dataOptions.URMResponses << "Identity " + QString::number(identity);
+    }
+    dataOptions.URMResponses << "--";
+    URMIdentityCriterion criterion(&dataOptions, Criterion::CriteriaType::urmIdentity, 1, true);
+    for(int identity = 1; identity <= numIdentities; identity++) {
+        criterion.identityRules["Identity " + QString::number(identity)]["!="] << 1;
+    }
+    // rules with identities on both sides of the bitmask, and with several values
+    criterion.identityRules["Identity 2|Identity " + QString::number(numIdentities)]["<"] << 3;
+    criterion.identityRules["Identity " + QString::number(numIdentities - 1) + "|Identity " + QString::number(numIdentities)][">"] << 0;
+    criterion.identityRules["Identity " + QString::number(numIdentities - 2)]["!="] << 2 << 3;
+
+    std::mt19937 pRNG(seed);
+    const int numStudents = 2 * numIdentities * idealTeamSize;
+    std::uniform_int_distribution<int> randURM(0, int(dataOptions.URMResponses.size()) - 1);
+    // half of the students share a few identities, so that the teams often have more than one of them
+    std::uniform_int_distribution<int> randCommonURM(int(dataOptions.URMResponses.size()) - 6, int(dataOptions.URMResponses.size()) - 1);
+    QList<StudentRecord> students(numStudents);
+    for(int student = 0; student < numStudents; student++) {
+        students[student].ID = student;
+        students[student].URMResponse = dataOptions.URMResponses.at(((student % 2) == 0)? randURM(pRNG) : randCommonURM(pRNG));
+    }
+    const StudentSnapshot snapshot(students.constData(), numStudents, &dataOptions);
+
+    const int numTeams = numStudents / idealTeamSize;
+    const QList<int> teamSizes(numTeams, idealTeamSize);
+    const auto workspace = criterion.createWorkspace(snapshot, numTeams, teamSizes.constData());
+    QList<int> teammates(numStudents);
+    std::iota(teammates.begin(), teammates.end(), 0);
+    QList<float> criteriaScores(numTeams), penaltyPoints(numTeams);
+
+    int numMismatches = 0;
+    for(int teamSet = 0; teamSet < numTeamSets; teamSet++) {
+        std::shuffle(teammates.begin(), teammates.end(), pRNG);
+        penaltyPoints.fill(0);
+        criterion.calculateScore(snapshot, teammates.constData(), numTeams, teamSizes.constData(), nullptr, &dataOptions,
+                                 criteriaScores, penaltyPoints, workspace.get());
+
+        bool identical = true;
+        for(int team = 0; team < numTeams; team++) {
+            QMap<QString, int> urmResponseCounts;
+            for(int teammate = 0; teammate < idealTeamSize; teammate++) {
+                const QString &response = students.at(teammates.at((team * idealTeamSize) + teammate)).URMResponse;
+                if(!response.isEmpty() && response != "--") {
+                    urmResponseCounts[response]++;
+                }
+            }
+            int numViolations = 0;
+            for(const auto [ruleKey, valMap] : criterion.identityRules.asKeyValueRange()) {
+                int count = 0;
+                for(const QString &identity : ruleKey.split('|')) {
+                    count += urmResponseCounts.value(identity, 0);
+                }
+                for(const auto [operation, values] : valMap.asKeyValueRange()) {
+                    for(const int val : values) {
+                        if((operation == "!=" && count == val) || (operation == "<" && count >= val) || (operation == ">" && count <= val)) {
+                            numViolations++;
+                            break;
+                        }
+                    }
+                }
+            }
+            identical = identical && (penaltyPoints.at(team) == float(numViolations)) && (criteriaScores.at(team) == ((numViolations > 0)? 0.0f : 1.0f));
+        }
+        numMismatches += identical? 0 : 1;
+    }
+
+    out << "    " << (QString::number(numIdentities) + QObject::tr(" identities: ")).leftJustified(18, ' ') << (numTeamSets - numMismatches) << " / "
+        << numTeamSets << QObject::tr(" team sets scored identically to the former comparison of responses") << Qt::endl;
+
+    return {{"identities", numIdentities}, {"rules", int(criterion.identityRules.size())},
+            {"teamSetsChecked", numTeamSets}, {"teamSetsMismatched", numMismatches}};
+}
+
+//////////////////
+// Time the optimization of one class on each number of threads, both as a single population (where only the scoring is parallel)
+// and split into one island per thread (where the breeding is parallel too), with speedups relative to a single population on the first number of threads
+//////////////////
+QJsonObject timeIslandModel(const int numStudents, const int idealTeamSize, const std::mt19937::result_type seed, const int scheduleMinutesPerBlock,
+                            const bool includeAssignment, const QList<int> &threadCounts, const int maxGenerations)
+{
+    auto &out = outStream();
+    const SyntheticRoster roster(numStudents, idealTeamSize, seed, scheduleMinutesPerBlock);
+    TeamingOptions teamingOptions;
+    teamingOptions.idealTeamSize = idealTeamSize;
+    teamingOptions.teamSizesDesired = roster.teamSizes;
+    teamingOptions.numTeamsDesired = int(roster.teamSizes.size());
+    teamingOptions.criteria = roster.createCriteria(includeAssignment);
+    TeamOptimizer::setCriteriaWeights(teamingOptions.criteria);
+    for(auto *const criterion : std::as_const(teamingOptions.criteria)) {
+        criterion->prepareForOptimization(roster.students.constData(), numStudents, &roster.dataOptions);
+    }
+
+    struct Run {double generationsPerSecond; float teamSetScore;};
+    const auto optimize = [&](const int numIslands) {
+        TeamOptimizer optimizer(roster.students, roster.studentIndexes, roster.teamSizes, &teamingOptions, &roster.dataOptions);
+        optimizer.seed = seed;
+        optimizer.numIslands = numIslands;
+        QObject::connect(&optimizer, &TeamOptimizer::generationComplete, &optimizer,
+                         [&optimizer, maxGenerations](const float *const /*allScores*/, const int *const /*orderedIndex*/, const int generation,
+                                                      const float /*scoreStability*/, const bool /*unpenalizedGenomePresent*/) {
+                             if((maxGenerations > 0) && (generation >= maxGenerations)) {
+                                 optimizer.stop();
+                             }
+                         });
+        QElapsedTimer timer;
+        timer.start();
+        optimizer.optimize();
+        return Run{optimizer.finalGeneration / (double(timer.nsecsElapsed()) / 1.0E9), optimizer.teamSetScore};
+    };
+
+    out << "\n" << QObject::tr("island model, ") << numStudents << QObject::tr(" students") << Qt::endl;
+    QJsonArray runs;
+    double baseline = 0;
+    const int originalNumThreads = maxNumThreads();
+    for(const int numThreads : threadCounts) {
+        setNumThreads(numThreads);
+        const Run onePopulation = optimize(1);
+        const Run islands = optimize(numThreads);
+        if(baseline == 0) {
+            baseline = onePopulation.generationsPerSecond;
+        }
+        out << "    " << (QString::number(numThreads) + QObject::tr(" threads: ")).leftJustified(14, ' ')
+            << QObject::tr("one population ") << qSetRealNumberPrecision(2) << onePopulation.generationsPerSecond << QObject::tr(" generations/s (")
+            << (onePopulation.generationsPerSecond / baseline) << QObject::tr("x, final score ") << onePopulation.teamSetScore << QObject::tr("); ")
+            << numThreads << QObject::tr(" islands ") << islands.generationsPerSecond << QObject::tr(" generations/s (")
+            << (islands.generationsPerSecond / baseline) << QObject::tr("x, final score ") << islands.teamSetScore << ")" << Qt::endl;
+        runs.append(QJsonObject{{"threads", numThreads},
+                                {"onePopulationGenerationsPerSecond", onePopulation.generationsPerSecond},
+                                {"onePopulationSpeedup", onePopulation.generationsPerSecond / baseline},
+                                {"onePopulationTeamSetScore", onePopulation.teamSetScore},
+                                {"islandsGenerationsPerSecond", islands.generationsPerSecond},
+                                {"islandsSpeedup", islands.generationsPerSecond / baseline},
+                                {"islandsTeamSetScore", islands.teamSetScore}});
+    }
+    setNumThreads(originalNumThreads);
+
+    qDeleteAll(teamingOptions.criteria);
+    return {{"students", numStudents}, {"assignmentPreferenceIncluded", includeAssignment}, {"runs", runs}};
+}
+
+//////////////////
+// Optimize the class again starting from entirely random team sets, for comparing how soon a team set breaking none of the hard rules
+// is found with and without greedy seeding
+//////////////////
+QJsonObject timeRandomSeeding(const SyntheticRoster &roster, const TeamingOptions &teamingOptions, const int greedyFirstUnpenalizedGeneration,
+                              const std::mt19937::result_type seed, const int maxGenerations)
+{
+    TeamOptimizer optimizer(roster.students, roster.studentIndexes, roster.teamSizes, &teamingOptions, &roster.dataOptions);
+    optimizer.seed = seed;
+    optimizer.greedySeeding = false;
+    QObject::connect(&optimizer, &TeamOptimizer::generationComplete, &optimizer,
+                     [&optimizer, maxGenerations](const float *const /*allScores*/, const int *const /*orderedIndex*/, const int generation,
+                                                  const float /*scoreStability*/, const bool /*unpenalizedGenomePresent*/) {
+                         if((maxGenerations > 0) && (generation >= maxGenerations)) {
+                             optimizer.stop();
+                         }
+                     });
+    QElapsedTimer timer;
+    timer.start();
+    optimizer.optimize();
+    const double seconds = double(timer.nsecsElapsed()) / 1.0E9;
+
+    auto &out = outStream();
+    out << "    " << QObject::tr("random seeding: ") << optimizer.finalGeneration << QObject::tr(" generations in ") << qSetRealNumberPrecision(2)
+        << seconds << QObject::tr(" s, final score ") << optimizer.teamSetScore << Qt::endl;
+    out << "    " << QObject::tr("first team set without penalties in generation ");
+    if(optimizer.firstUnpenalizedGeneration == -1) {
+        out << QObject::tr("(none)");
+    }
+    else {
+        out << optimizer.firstUnpenalizedGeneration;
+    }
+    out << QObject::tr(" with random seeding, ");
+    if(greedyFirstUnpenalizedGeneration == -1) {
+        out << QObject::tr("(none)");
+    }
+    else {
+        out << greedyFirstUnpenalizedGeneration;
+    }
+    out << QObject::tr(" with greedy seeding") << Qt::endl;
+
+    return {{"firstUnpenalizedGeneration", optimizer.firstUnpenalizedGeneration}, {"generations", optimizer.finalGeneration},
+            {"seconds", seconds}, {"teamSetScore", optimizer.teamSetScore}};
+}
+
+//////////////////
+// Refine a team set that is a few random swaps away from an optimized one (as if it had been edited by hand), with the optimized set's first team pinned,
+// counting the generations needed to get back to the optimized score, for comparison with the generations the cold start needed to find it
+//////////////////
+QJsonObject timeWarmStart(const SyntheticRoster &roster, const TeamingOptions &teamingOptions, const QList<int> &optimizedTeamSet, const float optimizedScore,
+                          const int coldGenerations, const int numSwaps, const std::mt19937::result_type seed, const int maxGenerations)
+{
+    auto &out = outStream();
+    const int firstTeamSize = roster.teamSizes.constFirst();
+    QList<int> startingTeamSet = optimizedTeamSet;
+    std::mt19937 pRNG(seed);
+    std::uniform_int_distribution<int> unpinnedPosition(firstTeamSize, int(startingTeamSet.size()) - 1);
+    for(int swap = 0; swap < numSwaps; swap++) {
+        std::swap(startingTeamSet[unpinnedPosition(pRNG)], startingTeamSet[unpinnedPosition(pRNG)]);
+    }
+
+    TeamOptimizer optimizer(roster.students, roster.studentIndexes, roster.teamSizes, &teamingOptions, &roster.dataOptions);
+    optimizer.seed = seed;
+    optimizer.startingTeamSet = startingTeamSet;
+    optimizer.pinnedStudents = startingTeamSet.mid(0, firstTeamSize);
+    int generationsToOptimizedScore = -1;
+    QObject::connect(&optimizer, &TeamOptimizer::generationComplete, &optimizer,
+                     [&optimizer, &generationsToOptimizedScore, optimizedScore, maxGenerations]
+                     (const float *const allScores, const int *const orderedIndex, const int generation,
+                      const float /*scoreStability*/, const bool /*unpenalizedGenomePresent*/) {
+                         if((generationsToOptimizedScore == -1) && (allScores[orderedIndex[0]] >= optimizedScore)) {
+                             generationsToOptimizedScore = generation;
+                         }
+                         if((maxGenerations > 0) && (generation >= maxGenerations)) {
+                             optimizer.stop();
+                         }
+                     });
+    QElapsedTimer timer;
+    timer.start();
+    optimizer.optimize();
+    const double seconds = double(timer.nsecsElapsed()) / 1.0E9;
+
+    out << "    " << QObject::tr("warm start, ") << numSwaps << QObject::tr(" swaps away with the first team pinned: ") << optimizer.finalGeneration
+        << QObject::tr(" generations in ") << qSetRealNumberPrecision(2) << seconds << QObject::tr(" s, final score ") << optimizer.teamSetScore << Qt::endl;
+    out << "    " << QObject::tr("optimized score ") << optimizedScore;
+    if(generationsToOptimizedScore == -1) {
+        out << QObject::tr(" not reached");
+    }
+    else {
+        out << QObject::tr(" reached after ") << generationsToOptimizedScore << QObject::tr(" generations");
+    }
+    out << QObject::tr(" (the cold start took ") << coldGenerations << ")" << Qt::endl;
+
+    return {{"swaps", numSwaps}, {"pinnedStudents", firstTeamSize}, {"generations", optimizer.finalGeneration}, {"seconds", seconds},
+            {"teamSetScore", optimizer.teamSetScore}, {"generationsToOptimizedScore", generationsToOptimizedScore},
+            {"coldStartGenerations", coldGenerations}};
+}
+
+}   // namespace
+
+
+int main(int argc, char *argv[])
+{
+    const QCoreApplication a(argc, argv);
+    QCoreApplication::setOrganizationName("gruepr");
+    QCoreApplication::setApplicationName("gruepr-benchmark");
+    QCoreApplication::setApplicationVersion(GRUEPR_VERSION_NUMBER);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QObject::tr("Benchmark the team optimization on reproducible synthetic classes of students."));
+    parser.addHelpOption();
+    parser.addVersionOption();
+    const QCommandLineOption sizesOption("sizes", QObject::tr("Comma-separated list of class sizes (default: 50,200,1000,5000,10000)."), "sizes",
+                                         "50,200,1000,5000,10000");
+    const QCommandLineOption teamSizeOption("team-size", QObject::tr("Ideal team size (default: 4)."), "size", "4");
+    const QCommandLineOption seedOption("seed", QObject::tr("Seed for generating the students and for the optimization (default: 20190101)."), "number", "20190101");
+    const QCommandLineOption generationsOption("generations", QObject::tr("Stop each optimization after this many generations; "
+                                                                          "0 runs until the usual stopping point (default: 25)."), "number", "25");
+    const QCommandLineOption assignmentOption("assignment-max-students", QObject::tr("Largest class size to include the assignment preference criterion in the "
+                                                                                     "optimization; its scoring grows with the cube of the number of teams (default: 200)."),
+                                              "number", "200");
+    const QCommandLineOption assignmentSolverOption("assignment-solver-teams", QObject::tr("Comma-separated list of numbers of teams for which to time "
+                                                                                           "the assignment preference solver on its own (default: 100,250)."),
+                                                    "teams", "100,250");
+    const QCommandLineOption crossoverOption("crossover-sizes", QObject::tr("Comma-separated list of class sizes for which to time and check "
+                                                                            "the ordered crossover on its own (default: 50,200,1000,5000,10000)."),
+                                             "sizes", "50,200,1000,5000,10000");
+    const QCommandLineOption rankingOption("ranking-sizes", QObject::tr("Comma-separated list of population sizes for which to time and check "
+                                                                        "the ranking of genome scores on its own (default: 2500,15000,60000)."),
+                                           "sizes", "2500,15000,60000");
+    const QCommandLineOption resolutionOption("schedule-resolution", QObject::tr("Length (in minutes) of each time block in the students' schedules: "
+                                                                             "60, 30, or 15 (default: 60)."), "minutes", "60");
+    QStringList defaultIslandThreads;
+    for(int numThreads = 1; numThreads < maxNumThreads(); numThreads *= 2) {
+        defaultIslandThreads << QString::number(numThreads);
+    }
+    defaultIslandThreads << QString::number(maxNumThreads());
+    const QCommandLineOption islandStudentsOption("island-students", QObject::tr("Class size for timing the island model on different numbers of threads; "
+                                                                                 "0 skips it (default: 1000)."), "number", "1000");
+    const QCommandLineOption islandThreadsOption("island-threads", QObject::tr("Comma-separated list of numbers of threads for timing the island model "
+                                                                               "(default: ") + defaultIslandThreads.join(',') + ").",
+                                                 "threads", defaultIslandThreads.join(','));
+    const QCommandLineOption localSearchOption("local-search", QObject::tr("Each generation, improve this many of the top team sets by local search, "
+                                                                           "and the best one at the end; 0 skips it (default: 0)."), "number", "0");
+    const QCommandLineOption warmStartOption("warm-start", QObject::tr("After each optimization, refine its team set after this many random swaps "
+                                                                       "(as if edited by hand), with one team pinned; 0 skips it (default: 0)."), "swaps", "0");
+    const QCommandLineOption seedingOption("compare-seeding", QObject::tr("After each optimization, optimize again from entirely random team sets, "
+                                                                          "comparing how soon a team set without penalties is found."));
+    const QCommandLineOption timingOption("criterion-time", QObject::tr("Minimum time (in ms) spent timing each criterion (default: 250)."), "ms", "250");
+    const QCommandLineOption outputOption({"o", "output"}, QObject::tr("Also write the results to this JSON file."), "file");
+    parser.addOptions({sizesOption, teamSizeOption, seedOption, generationsOption, assignmentOption, assignmentSolverOption, crossoverOption, rankingOption,
+                       resolutionOption, islandStudentsOption, islandThreadsOption, localSearchOption, warmStartOption, seedingOption, timingOption, outputOption});
+    parser.process(a);
+
+    QList<int> classSizes;
+    const QStringList sizes = parser.value(sizesOption).split(',', Qt::SkipEmptyParts);
+    for(const auto &size : sizes) {
+        classSizes << size.trimmed().toInt();
+    }
+    const int idealTeamSize = std::max(2, parser.value(teamSizeOption).toInt());
+    const auto seed = std::mt19937::result_type(parser.value(seedOption).toUInt());
+    const int maxGenerations = std::max(0, parser.value(generationsOption).toInt());
+    const int assignmentMaxStudents = parser.value(assignmentOption).toInt();
+    const int scheduleMinutesPerBlock = std::clamp(parser.value(resolutionOption).toInt(), 15, 60);
+    const qint64 criterionTime = std::max(1, parser.value(timingOption).toInt());
+    const int localSearchElites = std::max(0, parser.value(localSearchOption).toInt());
+    const int warmStartSwaps = std::max(0, parser.value(warmStartOption).toInt());
+    auto &out = outStream();
+    out.setRealNumberNotation(QTextStream::FixedNotation);
+
+    QJsonArray results;
+    QStringList allocatingScorings;     // the scorings of a genome that allocated once warmed up, which they should never do
+    for(const int numStudents : std::as_const(classSizes)) {
+        if(numStudents < idealTeamSize) {
+            continue;
+        }
+        const SyntheticRoster roster(numStudents, idealTeamSize, seed, scheduleMinutesPerBlock);
+        const int numTeams = int(roster.teamSizes.size());
+        TeamingOptions teamingOptions;
+        teamingOptions.idealTeamSize = idealTeamSize;
+        teamingOptions.teamSizesDesired = roster.teamSizes;
+        teamingOptions.numTeamsDesired = numTeams;
+        const bool includeAssignment = (numStudents <= assignmentMaxStudents);
+        teamingOptions.criteria = roster.createCriteria(includeAssignment);
+        TeamOptimizer::setCriteriaWeights(teamingOptions.criteria);
+        for(auto *const criterion : std::as_const(teamingOptions.criteria)) {
+            criterion->prepareForOptimization(roster.students.constData(), numStudents, &roster.dataOptions);
+        }
+        const StudentSnapshot snapshot(roster.students.constData(), numStudents, &roster.dataOptions);
+        const double snapshotKB = double(snapshot.sizeInBytes()) / 1024;
+
+        out << "\n" << numStudents << QObject::tr(" students, ") << numTeams << QObject::tr(" teams (scoring data: ")
+            << qSetRealNumberPrecision(1) << snapshotKB << " KB)" << Qt::endl;
+
+        // time each criterion, and the whole score, on a fixed set of random genomes
+        std::mt19937 pRNG(seed);
+        QList<QList<int>> sampleGenomes(16, roster.studentIndexes);
+        for(auto &genome : sampleGenomes) {
+            std::shuffle(genome.begin(), genome.end(), pRNG);
+        }
+        // (after the timing has warmed up the workspace, count any allocations made while scoring the sample genomes again)
+        TeamOptimizer::ScoringWorkspace workspace(snapshot, numTeams, roster.teamSizes.constData(), &teamingOptions);
+        QJsonObject criterionTimes, criterionAllocations;
+        for(int criterion = 0; criterion < teamingOptions.criteria.size(); criterion++) {
+            const auto *const thisCriterion = teamingOptions.criteria.at(criterion);
+            const auto scoreSampleGenome = [&](const long long call) {
+                thisCriterion->calculateScore(snapshot, sampleGenomes.at(call % sampleGenomes.size()).constData(), numTeams,
+                                              roster.teamSizes.constData(), &teamingOptions, &roster.dataOptions, workspace.criteriaScores[criterion],
+                                              workspace.penaltyPoints, workspace.criterionWorkspaces[criterion].get());
+            };
+            const double time = microsecondsPerCall(scoreSampleGenome, criterionTime);
+            const double allocations = allocationsPerCall(scoreSampleGenome, int(sampleGenomes.size()));
+            const QString name = criterionName(thisCriterion, &roster.dataOptions);
+            criterionTimes[name] = time;
+            criterionAllocations[name] = allocations;
+            if(AllocationCounter::isAvailable() && (allocations > 0)) {
+                allocatingScorings << QString::number(numStudents) + QObject::tr(" students, ") + name;
+            }
+            out << "    " << name.leftJustified(36, ' ') << qSetRealNumberPrecision(1) << time << QObject::tr(" us/genome")
+                << allocationsText(allocations) << Qt::endl;
+        }
+        const auto scoreSampleGenome = [&](const long long call) {
+            TeamOptimizer::getGenomeScore(snapshot, sampleGenomes.at(call % sampleGenomes.size()).constData(), numTeams,
+                                          roster.teamSizes.constData(), &teamingOptions, &roster.dataOptions, workspace);
+        };
+        const double genomeScoreTime = microsecondsPerCall(scoreSampleGenome, criterionTime);
+        const double genomeScoreAllocations = allocationsPerCall(scoreSampleGenome, int(sampleGenomes.size()));
+        if(AllocationCounter::isAvailable() && (genomeScoreAllocations > 0)) {
+            allocatingScorings << QString::number(numStudents) + QObject::tr(" students, getGenomeScore");
+        }
+        out << "    " << QString("getGenomeScore").leftJustified(36, ' ') << qSetRealNumberPrecision(1) << genomeScoreTime << QObject::tr(" us/genome")
+            << allocationsText(genomeScoreAllocations) << Qt::endl;
+        // and again one criterion at a time over all of the teams, for comparison with the default scoring of one team at a time on all of the criteria
+        workspace.teamMajor = false;
+        const double criterionMajorGenomeScoreTime = microsecondsPerCall(scoreSampleGenome, criterionTime);
+        workspace.teamMajor = true;
+        out << "    " << QString("getGenomeScore (criterion-major)").leftJustified(36, ' ') << qSetRealNumberPrecision(1) << criterionMajorGenomeScoreTime
+            << QObject::tr(" us/genome") << Qt::endl;
+        // and again with every team scored by the kernels for any team size, for comparison with those for fixed team sizes
+        Criterion::useFixedTeamSizeKernels = false;
+        const double anyTeamSizeGenomeScoreTime = microsecondsPerCall(scoreSampleGenome, criterionTime);
+        Criterion::useFixedTeamSizeKernels = true;
+        out << "    " << QString("getGenomeScore (any team size)").leftJustified(36, ' ') << qSetRealNumberPrecision(1) << anyTeamSizeGenomeScoreTime
+            << QObject::tr(" us/genome") << Qt::endl;
+
+        // run the optimization
+        TeamOptimizer optimizer(roster.students, roster.studentIndexes, roster.teamSizes, &teamingOptions, &roster.dataOptions);
+        optimizer.seed = seed;
+        optimizer.localSearchElites = localSearchElites;
+        optimizer.localSearchAtEnd = (localSearchElites > 0);
+        // count the allocations from the end of the first generation onwards, once all of the optimization's memory has been set up
+        long long allocationsAtFirstGeneration = 0;
+        QObject::connect(&optimizer, &TeamOptimizer::generationComplete, &optimizer,
+                         [&optimizer, &allocationsAtFirstGeneration, maxGenerations]
+                         (const float *const /*allScores*/, const int *const /*orderedIndex*/, const int generation,
+                          const float /*scoreStability*/, const bool /*unpenalizedGenomePresent*/) {
+                             if(generation == 1) {
+                                 allocationsAtFirstGeneration = AllocationCounter::count();
+                             }
+                             if((maxGenerations > 0) && (generation >= maxGenerations)) {
+                                 optimizer.stop();
+                             }
+                         });
+        QElapsedTimer timer;
+        timer.start();
+        const QList<int> optimizedTeamSet = optimizer.optimize();
+        const double seconds = double(timer.nsecsElapsed()) / 1.0E9;
+        const long long allocationsAtEnd = AllocationCounter::count();
+        const int generations = optimizer.finalGeneration;
+        const double allocationsPerGeneration = (generations > 1)? double(allocationsAtEnd - allocationsAtFirstGeneration) / (generations - 1) : 0;
+        const double generationsPerSecond = generations / seconds;
+        const double genomesPerSecond = double(generations + 1) * optimizer.ga.populationsize / seconds;   // generation 0 is scored too
+        // (per student, to show how the time for a generation grows with class size)
+        const double millisecondsPerGeneration = 1000 * seconds / (generations + 1);
+        const double microsecondsPerGenerationPerStudent = 1000 * millisecondsPerGeneration / numStudents;
+        const double peakRSS = peakRSSinMB();
+
+        out << "    " << QObject::tr("optimization: ") << generations << QObject::tr(" generations of ") << optimizer.ga.populationsize
+            << QObject::tr(" genomes in ") << qSetRealNumberPrecision(2) << seconds << " s"
+            << (includeAssignment? "" : QObject::tr(" (without assignment preference)")) << Qt::endl;
+        out << "    " << qSetRealNumberPrecision(2) << generationsPerSecond << QObject::tr(" generations/s, ")
+            << qSetRealNumberPrecision(0) << genomesPerSecond << QObject::tr(" genomes scored/s, final score ")
+            << qSetRealNumberPrecision(2) << optimizer.teamSetScore << Qt::endl;
+        out << "    " << qSetRealNumberPrecision(1) << millisecondsPerGeneration << QObject::tr(" ms/generation, ")
+            << qSetRealNumberPrecision(2) << microsecondsPerGenerationPerStudent << QObject::tr(" us/generation per student (tournament size ")
+            << optimizer.ga.tournamentsize << ")" << Qt::endl;
+        out << "    " << qSetRealNumberPrecision(1) << (100 * optimizer.fractionOfTeamsRescored)
+            << QObject::tr("% of teams needed rescoring after the first generation, ") << (100 * optimizer.scoreCacheHitRate)
+            << QObject::tr("% of team sets found in the score cache, ") << (100 * optimizer.teamScoreCacheHitRate)
+            << QObject::tr("% of teams needing a score found in the team score cache") << Qt::endl;
+        if(localSearchElites > 0) {
+            out << "    " << QObject::tr("local search: ") << optimizer.localSearchSwaps << QObject::tr(" swaps, score gain ") << qSetRealNumberPrecision(2)
+                << optimizer.localSearchGain << QObject::tr(" in ") << optimizer.localSearchSeconds << " s ("
+                << qSetRealNumberPrecision(1) << (100 * optimizer.localSearchSeconds / seconds) << QObject::tr("% of the optimization)") << Qt::endl;
+        }
+        if(AllocationCounter::isAvailable()) {
+            out << "    " << qSetRealNumberPrecision(1) << allocationsPerGeneration << QObject::tr(" allocations/generation after the first") << Qt::endl;
+        }
+        out << "    " << QObject::tr("peak RSS: ") << qSetRealNumberPrecision(1) << peakRSS << " MB" << Qt::endl;
+        const QJsonObject randomSeedingResult = parser.isSet(seedingOption)?
+                                                timeRandomSeeding(roster, teamingOptions, optimizer.firstUnpenalizedGeneration, seed, maxGenerations) : QJsonObject();
+        const QJsonObject warmStartResult = ((warmStartSwaps > 0) && (numTeams > 1))?
+                                            timeWarmStart(roster, teamingOptions, optimizedTeamSet, optimizer.teamSetScore, generations, warmStartSwaps,
+                                                          seed, maxGenerations) : QJsonObject();
+
+        QJsonObject result{{"students", numStudents}, {"teams", numTeams}, {"populationSize", optimizer.ga.populationsize},
+                           {"generations", generations}, {"seconds", seconds}, {"generationsPerSecond", generationsPerSecond},
+                           {"genomesPerSecond", genomesPerSecond}, {"teamSetScore", optimizer.teamSetScore},
+                           {"assignmentPreferenceIncluded", includeAssignment}, {"genomeScoreMicroseconds", genomeScoreTime},
+                           {"criterionMajorGenomeScoreMicroseconds", criterionMajorGenomeScoreTime},
+                           {"anyTeamSizeGenomeScoreMicroseconds", anyTeamSizeGenomeScoreTime},
+                           {"criterionMicroseconds", criterionTimes}, {"peakRSSMB", peakRSS}, {"snapshotKB", snapshotKB},
+                           {"fractionOfTeamsRescored", optimizer.fractionOfTeamsRescored}, {"scoreCacheHitRate", optimizer.scoreCacheHitRate},
+                           {"teamScoreCacheHitRate", optimizer.teamScoreCacheHitRate},
+                           {"localSearchElites", localSearchElites}, {"localSearchSwaps", optimizer.localSearchSwaps},
+                           {"localSearchGain", optimizer.localSearchGain}, {"localSearchSeconds", optimizer.localSearchSeconds},
+                           {"tournamentSize", optimizer.ga.tournamentsize}, {"firstUnpenalizedGeneration", optimizer.firstUnpenalizedGeneration},
+                           {"millisecondsPerGeneration", millisecondsPerGeneration},
+                           {"microsecondsPerGenerationPerStudent", microsecondsPerGenerationPerStudent}};
+        if(AllocationCounter::isAvailable()) {
+            result["genomeScoreAllocations"] = genomeScoreAllocations;
+            result["criterionAllocations"] = criterionAllocations;
+            result["allocationsPerGeneration"] = allocationsPerGeneration;
+        }
+        if(!randomSeedingResult.isEmpty()) {
+            result["randomSeeding"] = randomSeedingResult;
+        }
+        if(!warmStartResult.isEmpty()) {
+            result["warmStart"] = warmStartResult;
+        }
+        results.append(result);
+
+        qDeleteAll(teamingOptions.criteria);
+    }
+
+    QJsonArray assignmentSolverResults;
+    const QStringList assignmentSolverTeams = parser.value(assignmentSolverOption).split(',', Qt::SkipEmptyParts);
+    int numAssignmentMismatches = 0;
+    for(const auto &teams : assignmentSolverTeams) {
+        const int numTeams = teams.trimmed().toInt();
+        if(numTeams > 1) {
+            const QJsonObject result = timeAssignmentSolver(numTeams, idealTeamSize, seed, criterionTime);
+            numAssignmentMismatches += result["childrenMismatched"].toInt();
+            assignmentSolverResults.append(result);
+        }
+    }
+
+    QJsonArray crossoverResults;
+    const QStringList crossoverSizes = parser.value(crossoverOption).split(',', Qt::SkipEmptyParts);
+    if(!crossoverSizes.isEmpty()) {
+        out << "\n" << QObject::tr("ordered crossover") << Qt::endl;
+    }
+    int numCrossoverMismatches = 0;
+    for(const auto &size : crossoverSizes) {
+        const int numStudents = size.trimmed().toInt();
+        if(numStudents >= idealTeamSize) {
+            const QJsonObject result = timeCrossover(numStudents, idealTeamSize, seed, criterionTime);
+            numCrossoverMismatches += result["childrenMismatched"].toInt();
+            crossoverResults.append(result);
+        }
+    }
+
+    QJsonArray rankingResults;
+    const QStringList rankingSizes = parser.value(rankingOption).split(',', Qt::SkipEmptyParts);
+    if(!rankingSizes.isEmpty()) {
+        out << "\n" << QObject::tr("genome ranking") << Qt::endl;
+    }
+    int numRankingMismatches = 0;
+    for(const auto &size : rankingSizes) {
+        const int populationSize = size.trimmed().toInt();
+        if(populationSize > GA::NUM_ELITES) {
+            const QJsonObject result = timeRanking(populationSize, seed, criterionTime);
+            numRankingMismatches += result["rankingsMismatched"].toInt();
+            rankingResults.append(result);
+        }
+    }
+
+    // identity rules naming more identities than fit in the bitmask of a compiled rule
+    out << "\n" << QObject::tr("identity rules") << Qt::endl;
+    const QJsonObject identityRuleResult = checkIdentityRules(90, 200, idealTeamSize, seed);
+    const int numIdentityRuleMismatches = identityRuleResult["teamSetsMismatched"].toInt();
+
+    QJsonObject islandModelResults;
+    const int islandStudents = parser.value(islandStudentsOption).toInt();
+    QList<int> islandThreads;
+    const QStringList islandThreadCounts = parser.value(islandThreadsOption).split(',', Qt::SkipEmptyParts);
+    for(const auto &threads : islandThreadCounts) {
+        islandThreads << std::max(1, threads.trimmed().toInt());
+    }
+    if((islandStudents >= idealTeamSize) && !islandThreads.isEmpty()) {
+        islandModelResults = timeIslandModel(islandStudents, idealTeamSize, seed, scheduleMinutesPerBlock, (islandStudents <= assignmentMaxStudents),
+                                             islandThreads, maxGenerations);
+    }
+
+    if(parser.isSet(outputOption)) {
+        QFile outputFile(parser.value(outputOption));
+        if(!outputFile.open(QIODeviceBase::WriteOnly | QIODeviceBase::Text)) {
+            QTextStream(stderr) << QObject::tr("Could not write to ") << parser.value(outputOption) << Qt::endl;
+            return 1;
+        }
+        const QJsonObject content{{"version", GRUEPR_VERSION_NUMBER}, {"seed", qint64(seed)}, {"teamSize", idealTeamSize}, {"scheduleMinutesPerBlock", scheduleMinutesPerBlock},
+                                  {"maxGenerations", maxGenerations}, {"results", results},
+                                  {"assignmentSolver", assignmentSolverResults}, {"crossover", crossoverResults},
+                                  {"ranking", rankingResults}, {"identityRules", identityRuleResult},
+                                  {"islandModel", islandModelResults}};
+        outputFile.write(QJsonDocument(content).toJson(QJsonDocument::Indented));
+        outputFile.close();
+    }
+
+    if(!allocatingScorings.isEmpty()) {
+        QTextStream(stderr) << QObject::tr("Scoring a genome allocated memory after warming up: ") << allocatingScorings.join("; ") << Qt::endl;
+    }
+    if(numAssignmentMismatches > 0) {
+        QTextStream(stderr) << numAssignmentMismatches << QObject::tr(" children were assigned differently from the parent's solution or by the former solver than from scratch")
+                            << Qt::endl;
+    }
+    if(numCrossoverMismatches > 0) {
+        QTextStream(stderr) << numCrossoverMismatches << QObject::tr(" children from the ordered crossover differed from the former crossover") << Qt::endl;
+    }
+    if(numRankingMismatches > 0) {
+        QTextStream(stderr) << numRankingMismatches << QObject::tr(" rankings of genome scores differed from a stable sort") << Qt::endl;
+    }
+    if(numIdentityRuleMismatches > 0) {
+        QTextStream(stderr) << numIdentityRuleMismatches << QObject::tr(" team sets scored by the identity rules differed from the former comparison of responses")
+                            << Qt::endl;
+    }
+    if(!allocatingScorings.isEmpty() || (numAssignmentMismatches > 0) || (numCrossoverMismatches > 0) || (numRankingMismatches > 0) ||
+       (numIdentityRuleMismatches > 0)) {
+        return 2;
+    }
+    return 0;
+}
@@ -0,0 +1,220 @@
+#include "syntheticRoster.h"
+#include "criteria/assignmentPreferenceCriterion.h"
+#include "criteria/attributeCriterion.h"
+#include "criteria/genderCriterion.h"
+#include "criteria/scheduleCriterion.h"
+#include "criteria/teammatesCriterion.h"
+#include "criteria/URMIdentityCriterion.h"
+#include <algorithm>
+
+SyntheticRoster::SyntheticRoster(const int numStudents, const int idealTeamSize, const std::mt19937::result_type seed, const int scheduleMinutesPerBlock)
+{
+    std::mt19937 pRNG(seed);
+    std::uniform_int_distribution<int> randPercent(1, 100);
+
+    // team sizes: if students can't be evenly divided, one more team of smaller size(s)
+    int numTeams = std::max(1, numStudents/idealTeamSize);
+    if(numStudents % idealTeamSize != 0) {
+        numTeams++;
+    }
+    teamSizes.fill(0, numTeams);
+    for(int student = 0; student < numStudents; student++) {
+        teamSizes[student % numTeams]++;
+    }
+
+    // the survey: gender, racial/ethnic identity, schedule, assignment preference, and one of each kind of attribute question
+    dataOptions.dataSourceName = "synthetic roster";
+    dataOptions.genderIncluded = true;
+    dataOptions.genderType = GenderType::adult;
+    dataOptions.genderValues = {Gender::woman, Gender::man, Gender::nonbinary, Gender::unknown};
+    dataOptions.URMIncluded = true;
+    dataOptions.URMResponses = {"Asian", "Black", "Hispanic", "Native American", "White", "--"};
+    dataOptions.dayNames = {"Monday", "Tuesday", "Wednesday", "Thursday", "Friday"};
+    const int blocksPerHour = std::max(1, 60 / std::clamp(scheduleMinutesPerBlock, 1, 60));
+    const int numTimes = NUM_HOURS * blocksPerHour;
+    for(int time = 0; time < numTimes; time++) {
+        const int hour = 8 + (time / blocksPerHour);
+        const int minute = (time % blocksPerHour) * (60 / blocksPerHour);
+        dataOptions.timeNames << QString::number(((hour - 1) % 12) + 1) + ((minute == 0)? "" : ":" + QString::number(minute).rightJustified(2, '0')) +
+                                     ((hour < 12)? "am" : "pm");
+    }
+    dataOptions.scheduleResolution = 1.0f / float(blocksPerHour);
+    dataOptions.earlyTimeAsked = 8;
+    dataOptions.lateTimeAsked = 8 + NUM_HOURS - 1;
+    dataOptions.attributeQuestionText = {"How much programming experience do you have?",
+                                         "Which role do you prefer to take on a team?",
+                                         "What is your current GPA?",
+                                         "What time zone will you be in this semester?"};
+    dataOptions.attributeType = {DataOptions::AttributeType::ordered, DataOptions::AttributeType::categorical,
+                                 DataOptions::AttributeType::numerical, DataOptions::AttributeType::timezone};
+    dataOptions.attributeQuestionResponses = {{"1. None", "2. A little", "3. Some", "4. A lot", "5. Expert"},
+                                              {"Analysis", "Design", "Presenting", "Writing"},
+                                              {},
+                                              {"Pacific Time [GMT-08:00]", "Mountain Time [GMT-07:00]", "Central Time [GMT-06:00]",
+                                               "Eastern Time [GMT-05:00]", "Greenwich Mean Time [GMT+00:00]"}};
+    const QList<float> timezones = {-8, -7, -6, -5, 0};
+    dataOptions.numAttributes = int(dataOptions.attributeQuestionText.size());
+    dataOptions.attributeField = {0, 1, 2, 3};
+    dataOptions.timezoneIncluded = true;
+    dataOptions.timezoneField = 3;
+    dataOptions.attributeQuestionResponseCounts.resize(dataOptions.numAttributes);
+    dataOptions.attributeVals_discrete.resize(dataOptions.numAttributes);
+    dataOptions.attributeVals_continuous.resize(dataOptions.numAttributes);
+    for(int attribute = 0; attribute < dataOptions.numAttributes; attribute++) {
+        const auto &responses = dataOptions.attributeQuestionResponses.at(attribute);
+        for(int response = 0; response < responses.size(); response++) {
+            dataOptions.attributeVals_discrete[attribute].insert(response + 1);
+            dataOptions.attributeQuestionResponseCounts[attribute].insert({responses.at(response), 0});
+        }
+    }
+    QStringList assignmentOptions;
+    for(int option = 1; option <= numTeams; option++) {
+        assignmentOptions << "Project " + QString::number(option);
+    }
+
+    // the students
+    std::uniform_int_distribution<int> randStudent(0, numStudents - 1);
+    std::uniform_int_distribution<int> randURM(0, int(dataOptions.URMResponses.size()) - 1);
+    std::uniform_int_distribution<int> randOrdered(1, 5);
+    std::uniform_int_distribution<int> randCategorical(1, 4);
+    std::normal_distribution<float> randGPA(3.2f, 0.4f);
+    std::discrete_distribution<int> randTimezone({20, 10, 20, 45, 5});
+    std::bernoulli_distribution randBusy(0.45);
+    std::uniform_int_distribution<int> randOption(0, numTeams - 1);
+    students.reserve(numStudents);
+    studentIndexes.reserve(numStudents);
+    for(int index = 0; index < numStudents; index++) {
+        StudentRecord student;
+        student.ID = index;
+        student.firstname = "Student";
+        student.lastname = QString::number(index + 1);
+        student.email = "student" + QString::number(index + 1) + "@example.edu";
+        student.section = "1";
+
+        const int genderRoll = randPercent(pRNG);
+        student.gender = {(genderRoll <= 45)? Gender::woman : ((genderRoll <= 90)? Gender::man : ((genderRoll <= 95)? Gender::nonbinary : Gender::unknown))};
+        student.URMResponse = dataOptions.URMResponses.at(randURM(pRNG));
+
+        student.numScheduleDays = NUM_DAYS;
+        student.numScheduleTimesPerDay = numTimes;
+        student.unavailable.fill(false, NUM_DAYS * numTimes);
+        student.ambiguousSchedule = (randPercent(pRNG) <= PERCENT_AMBIGUOUS_SCHEDULE);
+        if(!student.ambiguousSchedule) {
+            // busy or free for a whole hour at a time, so that the same seed gives the same students at any resolution
+            for(int hour = 0; hour < NUM_DAYS * NUM_HOURS; hour++) {
+                const bool busy = randBusy(pRNG);
+                for(int block = 0; block < blocksPerHour; block++) {
+                    student.unavailable[(hour * blocksPerHour) + block] = busy;
+                }
+            }
+        }
+
+        const int experience = randOrdered(pRNG);
+        const int role = randCategorical(pRNG);
+        const float GPA = std::clamp(randGPA(pRNG), 0.0f, 4.0f);
+        const int timezone = randTimezone(pRNG);
+        student.attributeResponse = {dataOptions.attributeQuestionResponses.at(0).at(experience - 1),
+                                     dataOptions.attributeQuestionResponses.at(1).at(role - 1),
+                                     QString::number(GPA, 'f', 2),
+                                     dataOptions.attributeQuestionResponses.at(3).at(timezone)};
+        student.attributeVals_discrete = {{experience}, {role}, {}, {timezone + 1}};
+        student.attributeVals_continuous = {{}, {}, {GPA}, {}};
+        student.timezone = timezones.at(timezone);
+        dataOptions.attributeVals_continuous[2].insert(GPA);
+        for(int attribute = 0; attribute < dataOptions.numAttributes; attribute++) {
+            dataOptions.attributeQuestionResponseCounts[attribute][student.attributeResponse.at(attribute)]++;
+        }
+
+        while(student.assignmentPreferences.size() < std::min(NUM_RANKED_ASSIGNMENTS, numTeams)) {
+            const QString &option = assignmentOptions.at(randOption(pRNG));
+            if(!student.assignmentPreferences.contains(option)) {
+                student.assignmentPreferences << option;
+            }
+        }
+
+        students << student;
+        studentIndexes << index;
+    }
+
+    // teammate requests and preventions, always reciprocal
+    for(auto &student : students) {
+        if(randPercent(pRNG) <= PERCENT_GROUPTOGETHER) {
+            const int other = randStudent(pRNG);
+            if(other != student.ID) {
+                student.groupTogether << other;
+                students[other].groupTogether << student.ID;
+            }
+        }
+        if(randPercent(pRNG) <= PERCENT_SPLITAPART) {
+            const int other = randStudent(pRNG);
+            if(other != student.ID) {
+                student.splitApart << other;
+                students[other].splitApart << student.ID;
+            }
+        }
+    }
+
+    for(const auto &student : std::as_const(students)) {
+        const Gender studentGender = student.gender.values().at(0);
+        dataOptions.countOfGenderIdentities[studentGender]++;
+        dataOptions.countOfURMIdentities[student.URMResponse]++;
+    }
+}
+
+
+QList<Criterion*> SyntheticRoster::createCriteria(const bool includeAssignmentPreference) const
+{
+    QList<Criterion*> criteria;
+
+    // no isolated women
+    auto *gender = new GenderCriterion(&dataOptions, Criterion::CriteriaType::genderIdentity);
+    gender->identityRules[gender->womanKey]["!="] << 1;
+    gender->penaltyStatus = true;
+    criteria << gender;
+
+    // no isolated Black or Hispanic students
+    auto *URM = new URMIdentityCriterion(&dataOptions, Criterion::CriteriaType::urmIdentity);
+    URM->identityRules["Black|Hispanic"]["!="] << 1;
+    URM->penaltyStatus = true;
+    criteria << URM;
+
+    // a range of experience with no two novices together, similar roles, GPA near the class average, and similar timezones
+    auto *experience = new AttributeCriterion(&dataOptions, Criterion::CriteriaType::attributeQuestion, 0, false, nullptr, 0);
+    experience->diversity = Criterion::AttributeDiversity::diverse;
+    experience->incompatibleValues = {{1, 1}};
+    experience->haveAnyIncompatible = true;
+    criteria << experience;
+    auto *role = new AttributeCriterion(&dataOptions, Criterion::CriteriaType::attributeQuestion, 0, false, nullptr, 1);
+    role->diversity = Criterion::AttributeDiversity::similar;
+    criteria << role;
+    auto *GPA = new AttributeCriterion(&dataOptions, Criterion::CriteriaType::attributeQuestion, 0, false, nullptr, 2);
+    GPA->diversity = Criterion::AttributeDiversity::average;
+    criteria << GPA;
+    auto *timezone = new AttributeCriterion(&dataOptions, Criterion::CriteriaType::attributeQuestion, 0, false, nullptr, 3);
+    timezone->diversity = Criterion::AttributeDiversity::similar;
+    criteria << timezone;
+
+    auto *schedule = new ScheduleCriterion(&dataOptions, Criterion::CriteriaType::scheduleMeetingTimes);
+    schedule->minTimeBlocksOverlap = 4;
+    schedule->desiredTimeBlocksOverlap = 8;
+    schedule->meetingBlockSize = 1;
+    schedule->penaltyStatus = true;
+    criteria << schedule;
+
+    auto *groupTogether = new TeammatesCriterion(Criterion::CriteriaType::groupTogether);
+    groupTogether->haveAnyTeammates = true;
+    groupTogether->penaltyStatus = true;
+    criteria << groupTogether;
+    auto *splitApart = new TeammatesCriterion(Criterion::CriteriaType::splitApart);
+    splitApart->haveAnyTeammates = true;
+    splitApart->penaltyStatus = true;
+    criteria << splitApart;
+
+    if(includeAssignmentPreference) {
+        auto *assignment = new AssignmentPreferenceCriterion(&dataOptions, Criterion::CriteriaType::assignmentPreference);
+        assignment->penalizeNoOneRanked = true;
+        criteria << assignment;
+    }
+
+    return criteria;
+}
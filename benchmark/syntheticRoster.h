@@ -0,0 +1,38 @@
+#ifndef SYNTHETICROSTER_H
+#define SYNTHETICROSTER_H
+
+// A class of randomly generated students with every type of survey data that gruepr can team with,
+// created from a seed so that the same roster (and thus the same optimization) can be reproduced
+
+#include "dataOptions.h"
+#include "studentRecord.h"
+#include "criteria/criterion.h"
+#include <QList>
+#include <random>
+
+class SyntheticRoster
+{
+public:
+    SyntheticRoster(int numStudents, int idealTeamSize, std::mt19937::result_type seed, int scheduleMinutesPerBlock = 60);
+    SyntheticRoster(const SyntheticRoster&) = delete;
+    SyntheticRoster operator= (const SyntheticRoster&) = delete;
+    SyntheticRoster(SyntheticRoster&&) = delete;
+    SyntheticRoster& operator= (SyntheticRoster&&) = delete;
+
+    // one of each type of criterion, in priority order; caller takes ownership
+    QList<Criterion*> createCriteria(bool includeAssignmentPreference = true) const;
+
+    QList<StudentRecord> students;
+    DataOptions dataOptions;
+    QList<int> studentIndexes;
+    QList<int> teamSizes;
+
+    inline static const int NUM_DAYS = 5;
+    inline static const int NUM_HOURS = 10;                         // 8am - 6pm
+    inline static const int NUM_RANKED_ASSIGNMENTS = 3;
+    inline static const int PERCENT_GROUPTOGETHER = 4;              // percent of students that request a teammate
+    inline static const int PERCENT_SPLITAPART = 4;                 // percent of students that are prevented from being with a teammate
+    inline static const int PERCENT_AMBIGUOUS_SCHEDULE = 3;
+};
+
+#endif // SYNTHETICROSTER_H
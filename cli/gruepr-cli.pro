@@ -0,0 +1,18 @@
+#-------------------------------------------------
+#
+# gruepr-cli: form teams from the command line, without the gruepr window
+#
+#-------------------------------------------------
+
+gruepr_version = $$fromfile(../gruepr.pro, gruepr_version)
+copyright_year = $$fromfile(../gruepr.pro, copyright_year)
+
+TARGET = gruepr-cli
+TEMPLATE = app
+CONFIG += console
+CONFIG -= app_bundle
+
+include(../gruepr.pri)
+
+SOURCES += \
+    main.cpp
@@ -0,0 +1,578 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+// gruepr-cli
+//
+// Forms teams without any GUI: loads a survey data file (.csv) or a saved gruepr work file,
+// applies the teaming criteria, optimizes with the same genetic algorithm used in gruepr,
+// and writes the resulting teams and their scores as .csv or .json
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "csvfile.h"
+#include "dataOptions.h"
+#include "gruepr_globals.h"
+#include "studentRecord.h"
+#include "surveyReader.h"
+#include "teamOptimizer.h"
+#include "teamRecord.h"
+#include "teamingOptions.h"
+#include "criteria/assignmentPreferenceCriterion.h"
+#include "criteria/attributeCriterion.h"
+#include "criteria/genderCriterion.h"
+#include "criteria/scheduleCriterion.h"
+#include "criteria/teammatesCriterion.h"
+#include "criteria/URMIdentityCriterion.h"
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QMetaEnum>
+#include <QTextStream>
+#include <QThread>
+#include <numeric>
+
+namespace {
+
+QTextStream &errStream()
+{
+    static QTextStream stream(stderr);
+    return stream;
+}
+
+//////////////////
+// Determine the meaning of each column from its header text, the same way the load data dialog preloads its selections
+// (without a user to review them, any field beyond the maximum allowed for a meaning is left unused)
+//////////////////
+bool readQuestionsFromHeader(CsvFile &surveyFile, QString &error)
+{
+    if(!surveyFile.readHeader() || (surveyFile.headerValues.size() < 2)) {
+        error = QObject::tr("This file is empty or there is an error in its format.");
+        return false;
+    }
+
+    SurveyReader::preloadFieldMeanings(surveyFile, DataOptions::DataSource::fromUploadFile);
+
+    // enforce the maximum number of fields allowed to have each meaning
+    QHash<QString, int> numFieldsWithMeaning;
+    for(int i = 0; i < surveyFile.numFields; i++) {
+        for(const auto &option : SurveyReader::surveyFieldOptions()) {
+            if(option.nameShownToUser == surveyFile.fieldMeanings.at(i)) {
+                if(++numFieldsWithMeaning[option.nameShownToUser] > option.maxNumOfFields) {
+                    surveyFile.fieldMeanings[i] = SurveyReader::UNUSEDTEXT;
+                }
+                break;
+            }
+        }
+    }
+
+    return true;
+}
+
+//////////////////
+// Read the survey data file into the students and dataOptions, following the same process as the load data dialog
+//////////////////
+bool readSurveyFile(const QString &fileName, const float baseTimezone, QList<StudentRecord> &students, DataOptions &dataOptions, QString &error)
+{
+    CsvFile surveyFile;
+    if(!surveyFile.openExistingFile(fileName)) {
+        error = QObject::tr("Could not open ") + fileName;
+        return false;
+    }
+    if(!readQuestionsFromHeader(surveyFile, error)) {
+        surveyFile.close();
+        return false;
+    }
+
+    dataOptions.dataSource = DataOptions::DataSource::fromUploadFile;
+    dataOptions.dataSourceName = QFileInfo(fileName).fileName();
+    SurveyReader::setFieldsFromMeanings(surveyFile, dataOptions, dataOptions.dataSource);
+
+    if(!surveyFile.readDataRow()) {
+        error = QObject::tr("There are no survey responses in this file.");
+        surveyFile.close();
+        return false;
+    }
+
+    SurveyReader::compileTimeNames(surveyFile, dataOptions);
+    if(!dataOptions.dayNames.isEmpty() && dataOptions.homeTimezoneUsed) {
+        // no one to ask, so the base timezone comes from the command line
+        dataOptions.baseTimezone = baseTimezone;
+    }
+
+    // Read each remaining row as a student record
+    surveyFile.readDataRow(CsvFile::ReadLocation::beginningOfFile);
+    if(surveyFile.hasHeaderRow) {
+        surveyFile.readDataRow();
+    }
+    students.reserve(surveyFile.estimatedNumberRows);
+    int numStudents = 0;
+    StudentRecord currStudent;
+    do {
+        // skip rows where every field is empty
+        if(std::all_of(surveyFile.fieldValues.constBegin(), surveyFile.fieldValues.constEnd(), [](const QString &field){return field.trimmed().isEmpty();})) {
+            continue;
+        }
+
+        currStudent.clear();
+        currStudent.parseRecordFromStringList(surveyFile.fieldValues, dataOptions);
+        currStudent.ID = students.size();
+        SurveyReader::updateGenderType(surveyFile.fieldValues, dataOptions);
+
+        numStudents++;
+        students << currStudent;
+    } while(surveyFile.readDataRow() && numStudents < MAX_STUDENTS);
+    surveyFile.close();
+
+    if(numStudents < MIN_STUDENTS) {
+        error = QObject::tr("There are only ") + QString::number(numStudents) + QObject::tr(" survey responses.\n") +
+                QString::number(MIN_STUDENTS) + QObject::tr(" is the minimum.");
+        return false;
+    }
+    if(numStudents == MAX_STUDENTS) {
+        errStream() << QObject::tr("Reached maximum number of students; only the first ") << MAX_STUDENTS << QObject::tr(" were read.") << Qt::endl;
+    }
+
+    // Set the attribute question options and numerical values for each student
+    SurveyReader::sizeAttributeResponses(dataOptions);
+    for(int attribute = 0; attribute < dataOptions.numAttributes; attribute++) {
+        SurveyReader::processAttributeResponses(attribute, students, dataOptions);
+    }
+
+    // gather all unique URM, section, and gender responses
+    SurveyReader::gatherIdentityResponses(students, dataOptions);
+
+    return true;
+}
+
+//////////////////
+// Read the students, dataOptions, teamingOptions, and criteria from a saved gruepr work file
+//////////////////
+bool readSavedWork(const QString &fileName, QList<StudentRecord> &students, DataOptions &dataOptions,
+                   QJsonObject &teamingOptionsJson, QJsonArray &criteriaJson, QString &error)
+{
+    QFile savedFile(fileName);
+    if(!savedFile.open(QIODeviceBase::ReadOnly | QIODeviceBase::Text)) {
+        error = QObject::tr("Could not open ") + fileName;
+        return false;
+    }
+    const QJsonDocument doc = QJsonDocument::fromJson(savedFile.readAll());
+    savedFile.close();
+    const QJsonObject content = doc.object();
+    if(!content.contains("students") || !content.contains("dataoptions")) {
+        error = fileName + QObject::tr(" is not a gruepr work file.");
+        return false;
+    }
+
+    const QJsonArray studentjsons = content["students"].toArray();
+    students.reserve(studentjsons.size());
+    for(const auto &studentjson : studentjsons) {
+        students.emplaceBack(studentjson.toObject());
+    }
+    dataOptions = DataOptions(content["dataoptions"].toObject());
+    dataOptions.dataSource = DataOptions::DataSource::fromPrevWork;
+    dataOptions.saveStateFileName = fileName;
+    const int numDays = int(dataOptions.dayNames.size());
+    const int numTimes = int(dataOptions.timeNames.size());
+    for(auto &student : students) {
+        student.reconcileScheduleDimensions(numDays, numTimes);
+    }
+
+    teamingOptionsJson = content["teamingoptions"].toObject();
+    criteriaJson = content["criteriaCards"].toArray();
+    return true;
+}
+
+//////////////////
+// Create the scoring criteria from their saved settings, in priority order (as in the teams tab's restoreCriteria)
+// Accepts a list of criteria cards or an object holding one under "criteriaCards" (saved work file) or "criteria" (saved team set)
+//////////////////
+QList<Criterion*> createCriteria(const QJsonValue &criteriaJson, const DataOptions *const dataOptions, QString &error)
+{
+    QJsonArray entries;
+    if(criteriaJson.isArray()) {
+        entries = criteriaJson.toArray();
+    }
+    else if(criteriaJson.toObject().contains("criteriaCards")) {
+        entries = criteriaJson["criteriaCards"].toArray();
+    }
+    else {
+        entries = criteriaJson["criteria"].toArray();
+    }
+
+    QList<Criterion*> criteria;
+    const auto criteriaTypeEnum = QMetaEnum::fromType<Criterion::CriteriaType>();
+    for(const auto &val : std::as_const(entries)) {
+        const QJsonObject entry = val.toObject();
+        const int typeInt = Criterion::resolveCriteriaTypeKey(criteriaTypeEnum, entry["criteriaType"].toString());
+        if(typeInt == -1) {
+            error = QObject::tr("Unknown criterion type: ") + entry["criteriaType"].toString();
+            qDeleteAll(criteria);
+            return {};
+        }
+        const auto type = static_cast<Criterion::CriteriaType>(typeInt);
+
+        Criterion *criterion = nullptr;
+        switch(type) {
+        case Criterion::CriteriaType::genderIdentity:
+            criterion = new GenderCriterion(dataOptions, type);
+            break;
+        case Criterion::CriteriaType::urmIdentity:
+            criterion = new URMIdentityCriterion(dataOptions, type);
+            break;
+        case Criterion::CriteriaType::attributeQuestion: {
+            const int attrIdx = entry["attributeIndex"].toInt();
+            if(attrIdx < 0 || attrIdx >= dataOptions->numAttributes) {
+                error = QObject::tr("There is no attribute question number ") + QString::number(attrIdx + 1) + QObject::tr(" in this data.");
+                qDeleteAll(criteria);
+                return {};
+            }
+            criterion = new AttributeCriterion(dataOptions, type, 0, false, nullptr, attrIdx);
+            break;
+        }
+        case Criterion::CriteriaType::assignmentPreference:
+            criterion = new AssignmentPreferenceCriterion(dataOptions, type);
+            break;
+        case Criterion::CriteriaType::scheduleMeetingTimes:
+            criterion = new ScheduleCriterion(dataOptions, type);
+            break;
+        case Criterion::CriteriaType::groupTogether:
+        case Criterion::CriteriaType::splitApart:
+            criterion = new TeammatesCriterion(type);
+            break;
+        default:
+            break;      // section and team size are not scoring criteria; they are set from the command line
+        }
+
+        if(criterion != nullptr) {
+            if(entry.contains("settings")) {
+                criterion->settingsFromJson(entry["settings"].toObject());
+            }
+            criteria << criterion;
+        }
+    }
+    return criteria;
+}
+
+QString csvField(const QString &value)
+{
+    if(value.contains(',') || value.contains('"') || value.contains('\n')) {
+        return "\"" + QString(value).replace("\"", "\"\"") + "\"";
+    }
+    return value;
+}
+
+QJsonValue jsonScore(const float score)
+{
+    return Criterion::IS_NO_SCORE(score) ? QJsonValue() : QJsonValue(score);
+}
+
+}   // namespace
+
+
+int main(int argc, char *argv[])
+{
+    const QCoreApplication a(argc, argv);
+    QCoreApplication::setOrganizationName("gruepr");
+    QCoreApplication::setApplicationName("gruepr-cli");
+    QCoreApplication::setApplicationVersion(GRUEPR_VERSION_NUMBER);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QObject::tr("Form optimized teams from survey data without the gruepr window."));
+    parser.addHelpOption();
+    parser.addVersionOption();
+    parser.addPositionalArgument("input", QObject::tr("Survey data file (.csv or .txt) or saved gruepr work file."));
+    const QCommandLineOption criteriaOption({"c", "criteria"}, QObject::tr("JSON file with the teaming criteria, in priority order, "
+                                                                           "in the format gruepr saves its criteria cards. "
+                                                                           "Defaults to the criteria in the saved work file, if given."), "file");
+    const QCommandLineOption outputOption({"o", "output"}, QObject::tr("Output file for the teams; a .json extension writes JSON, "
+                                                                       "anything else writes CSV. Defaults to CSV on standard output."), "file");
+    const QCommandLineOption teamSizeOption({"s", "team-size"}, QObject::tr("Ideal team size (default: 4, or the size in the saved work file)."), "size");
+    const QCommandLineOption largerTeamsOption("larger-teams", QObject::tr("If students cannot be evenly divided, make fewer, larger teams instead of more, smaller teams."));
+    const QCommandLineOption teamSizesOption("team-sizes", QObject::tr("Comma-separated list of the exact size of every team."), "sizes");
+    const QCommandLineOption sectionOption("section", QObject::tr("Only team the students in this section."), "name");
+    const QCommandLineOption baseTimezoneOption("base-timezone", QObject::tr("Offset from GMT (in hours) to which schedules are adjusted "
+                                                                             "when students answered in their home timezone (default: 0)."), "hours", "0");
+    const QCommandLineOption seedOption("seed", QObject::tr("Seed for the random number generator, to make the teams reproducible."), "number");
+    const QCommandLineOption islandsOption("islands", QObject::tr("Split the optimization into this many independently breeding populations, run in parallel, "
+                                                                  "that exchange their best team sets every few generations; 0 uses one per processor core (default: 1)."),
+                                           "number", "1");
+    const QCommandLineOption localSearchOption("local-search", QObject::tr("Each generation, improve this many of the top team sets by swapping students "
+                                                                           "between teams, and do the same to the best team set at the end; 0 skips it "
+                                                                           "(default: 0). Not done if any criterion compares the teams to each other."),
+                                               "number", "0");
+    const QCommandLineOption timeLimitOption("time-limit", QObject::tr("The most time (in seconds) to spend optimizing, after which the best teams found so far "
+                                                                       "are used; the number of team sets in each generation is reduced, if needed, "
+                                                                       "so that enough generations fit (default: no limit, or the limit in the saved work file)."),
+                                             "seconds");
+    const QCommandLineOption checkpointOption("checkpoint", QObject::tr("Periodically save the optimization's progress to this file, so that an interrupted "
+                                                                        "run can be resumed: if the file holds the progress of an earlier run with the same "
+                                                                        "students and team sizes, the optimization continues from it. "
+                                                                        "The file is deleted once the teams are written."), "file");
+    const QCommandLineOption randomSeedingOption("random-seeding", QObject::tr("Start from entirely random team sets, instead of building half of them "
+                                                                               "to follow any penalized teammates and identity rules."));
+    const QCommandLineOption quietOption({"q", "quiet"}, QObject::tr("Do not report optimization progress."));
+    parser.addOptions({criteriaOption, outputOption, teamSizeOption, largerTeamsOption, teamSizesOption, sectionOption, baseTimezoneOption,
+                       seedOption, islandsOption, localSearchOption, timeLimitOption, checkpointOption, randomSeedingOption, quietOption});
+    parser.process(a);
+
+    if(parser.positionalArguments().size() != 1) {
+        parser.showHelp(1);
+    }
+    const QString inputFileName = parser.positionalArguments().constFirst();
+
+    // Load the students
+    QList<StudentRecord> students;
+    DataOptions dataOptions;
+    QJsonObject teamingOptionsJson;
+    QJsonArray savedCriteriaJson;
+    QString error;
+    const QString inputSuffix = QFileInfo(inputFileName).suffix().toLower();
+    const bool loaded = ((inputSuffix == "csv") || (inputSuffix == "txt"))?
+                            readSurveyFile(inputFileName, parser.value(baseTimezoneOption).toFloat(), students, dataOptions, error) :
+                            readSavedWork(inputFileName, students, dataOptions, teamingOptionsJson, savedCriteriaJson, error);
+    if(!loaded) {
+        errStream() << error << Qt::endl;
+        return 1;
+    }
+
+    TeamingOptions teamingOptions(teamingOptionsJson);
+
+    // Load the criteria
+    QJsonValue criteriaJson = savedCriteriaJson;
+    if(parser.isSet(criteriaOption)) {
+        QFile criteriaFile(parser.value(criteriaOption));
+        if(!criteriaFile.open(QIODeviceBase::ReadOnly | QIODeviceBase::Text)) {
+            errStream() << QObject::tr("Could not open ") << parser.value(criteriaOption) << Qt::endl;
+            return 1;
+        }
+        const QJsonDocument doc = QJsonDocument::fromJson(criteriaFile.readAll());
+        criteriaFile.close();
+        criteriaJson = doc.isArray()? QJsonValue(doc.array()) : QJsonValue(doc.object());
+    }
+    teamingOptions.criteria = createCriteria(criteriaJson, &dataOptions, error);
+    if(!error.isEmpty()) {
+        errStream() << error << Qt::endl;
+        return 1;
+    }
+
+    // Get the indexes of non-deleted students from the desired section(s)
+    if(parser.isSet(sectionOption)) {
+        teamingOptions.sectionType = TeamingOptions::SectionType::oneSection;
+        teamingOptions.sectionName = parser.value(sectionOption);
+    }
+    else {
+        teamingOptions.sectionType = dataOptions.sectionIncluded? TeamingOptions::SectionType::allTogether : TeamingOptions::SectionType::noSections;
+        teamingOptions.sectionName.clear();
+    }
+    QList<int> studentIndexes;
+    studentIndexes.reserve(students.size());
+    for(int index = 0; index < students.size(); index++) {
+        if(!students[index].deleted &&
+            ((teamingOptions.sectionType != TeamingOptions::SectionType::oneSection) || (teamingOptions.sectionName == students[index].section))) {
+            studentIndexes << index;
+        }
+    }
+    const int numStudents = int(studentIndexes.size());
+    if(numStudents < MIN_STUDENTS) {
+        errStream() << QObject::tr("There are only ") << numStudents << QObject::tr(" students to place on teams. ")
+                    << MIN_STUDENTS << QObject::tr(" is the minimum.") << Qt::endl;
+        return 1;
+    }
+
+    // Determine the team sizes
+    QList<int> teamSizes;
+    if(parser.isSet(teamSizesOption)) {
+        const QStringList sizes = parser.value(teamSizesOption).split(',', Qt::SkipEmptyParts);
+        for(const auto &size : sizes) {
+            teamSizes << size.trimmed().toInt();
+        }
+        if(std::any_of(teamSizes.constBegin(), teamSizes.constEnd(), [](const int size){return size < 1;}) ||
+           (std::accumulate(teamSizes.constBegin(), teamSizes.constEnd(), 0) != numStudents)) {
+            errStream() << QObject::tr("The team sizes must be positive and add up to the number of students (") << numStudents << ")." << Qt::endl;
+            return 1;
+        }
+    }
+    else {
+        const int idealSize = parser.isSet(teamSizeOption)? parser.value(teamSizeOption).toInt() : teamingOptions.idealTeamSize;
+        if(idealSize < 2 || idealSize > numStudents) {
+            errStream() << QObject::tr("The team size must be between 2 and the number of students (") << numStudents << ")." << Qt::endl;
+            return 1;
+        }
+        teamingOptions.idealTeamSize = idealSize;
+        teamSizes = TeamingOptions::calculateTeamSizes(numStudents, idealSize, parser.isSet(largerTeamsOption));
+    }
+    teamingOptions.teamSizesDesired = teamSizes;
+    teamingOptions.numTeamsDesired = int(teamSizes.size());
+
+    // Optimize
+    TeamOptimizer::setCriteriaWeights(teamingOptions.criteria);
+    for(auto *const criterion : std::as_const(teamingOptions.criteria)) {
+        criterion->prepareForOptimization(students.constData(), int(students.size()), &dataOptions);
+    }
+    TeamOptimizer optimizer(students, studentIndexes, teamSizes, &teamingOptions, &dataOptions);
+    if(parser.isSet(seedOption)) {
+        optimizer.seed = parser.value(seedOption).toUInt();
+    }
+    const int numIslands = parser.value(islandsOption).toInt();
+    optimizer.numIslands = (numIslands > 0)? numIslands : QThread::idealThreadCount();
+    optimizer.localSearchElites = std::max(0, parser.value(localSearchOption).toInt());
+    optimizer.localSearchAtEnd = (optimizer.localSearchElites > 0);
+    optimizer.greedySeeding = !parser.isSet(randomSeedingOption);
+    if(parser.isSet(timeLimitOption)) {
+        teamingOptions.timeLimitPerSection = std::max(0, parser.value(timeLimitOption).toInt());
+    }
+    optimizer.timeBudget = teamingOptions.timeLimitPerSection * 1000;
+    if(parser.isSet(checkpointOption)) {
+        optimizer.checkpointFileName = parser.value(checkpointOption);
+        optimizer.resumeFromCheckpoint = true;
+    }
+    if(!parser.isSet(quietOption)) {
+        QObject::connect(&optimizer, &TeamOptimizer::generationComplete, &optimizer,
+                         [](const float *const allScores, const int *const orderedIndex, const int generation, const float scoreStability,
+                                      const bool unpenalizedGenomePresent) {
+                             if((generation % 10) == 0) {
+                                 errStream() << QObject::tr("Generation ") << generation << QObject::tr(": best score ") << allScores[orderedIndex[0]]
+                                             << QObject::tr(", stability ") << scoreStability
+                                             << (unpenalizedGenomePresent? "" : QObject::tr(" (all team sets penalized)")) << Qt::endl;
+                             }
+                         });
+    }
+    const QList<int> bestTeamSet = optimizer.optimize();
+
+    // Load students into teams, sorting teammates alphabetically by lastname,firstname
+    QHash<long long, int> indexFromID;
+    for(int index = 0; index < students.size(); index++) {
+        indexFromID.insert(students.at(index).ID, index);
+    }
+    const auto nameKey = [&students, &indexFromID](const long long ID) {
+        const StudentRecord &student = students.at(indexFromID.value(ID));
+        return student.lastname + student.firstname;
+    };
+    TeamSet teams;
+    teams.dataOptions = dataOptions;
+    teams.reserve(teamSizes.size());
+    int indexInTeamset = 0;
+    for(const auto teamSize : std::as_const(teamSizes)) {
+        teams.emplaceBack(&teams.dataOptions, teamSize);
+        auto &IDList = teams.last().studentIDs;
+        for(int studentNum = 0; studentNum < teamSize; studentNum++) {
+            IDList << students.at(bestTeamSet.at(indexInTeamset)).ID;
+            indexInTeamset++;
+        }
+        std::sort(IDList.begin(), IDList.end(), [&nameKey](const long long a, const long long b) {return nameKey(a) < nameKey(b);});
+    }
+
+    // Load scores and info into the teams, then sort teams by 1st student's name
+    TeamOptimizer::calcTeamScores(students, teams, &teamingOptions);
+    for(auto &team : teams) {
+        team.refreshTeamInfo(students, ScheduleCriterion::getNumBlocksForOneMeeting(&teamingOptions));
+    }
+    std::sort(teams.begin(), teams.end(), [&nameKey](const TeamRecord &a, const TeamRecord &b) {
+        return (a.studentIDs.isEmpty()? QString() : nameKey(a.studentIDs.constFirst())) < (b.studentIDs.isEmpty()? QString() : nameKey(b.studentIDs.constFirst()));
+    });
+    for(int team = 0; team < teams.size(); team++) {
+        teams[team].name = QString::number(team+1);
+    }
+
+    // Per-criterion score of each team, as shown in the teams tab
+    QSet<long long> IDsBeingTeamed;
+    for(const int index : std::as_const(studentIndexes)) {
+        IDsBeingTeamed.insert(students.at(index).ID);
+    }
+    QStringList criteriaLabels;
+    QList<QList<float>> criteriaScores(teams.size());
+    for(auto *const criterion : std::as_const(teamingOptions.criteria)) {
+        criteriaLabels << criterion->headerLabel(&dataOptions).simplified();
+        criterion->prepareForDisplay(students, teams);
+        for(int team = 0; team < teams.size(); team++) {
+            criteriaScores[team] << criterion->scoreForOneTeamInDisplay(students, teams.at(team), &teamingOptions, &dataOptions, IDsBeingTeamed);
+        }
+    }
+
+    // Write the results
+    QFile outputFile;
+    const QString outputFileName = parser.value(outputOption);
+    const bool outputToFile = !outputFileName.isEmpty();
+    if(outputToFile) {
+        outputFile.setFileName(outputFileName);
+        if(!outputFile.open(QIODeviceBase::WriteOnly | QIODeviceBase::Text)) {
+            errStream() << QObject::tr("Could not write to ") << outputFileName << Qt::endl;
+            return 1;
+        }
+    }
+    else if(!outputFile.open(stdout, QIODeviceBase::WriteOnly | QIODeviceBase::Text)) {
+        return 1;
+    }
+    QTextStream out(&outputFile);
+
+    if(outputToFile && (QFileInfo(outputFileName).suffix().compare("json", Qt::CaseInsensitive) == 0)) {
+        QJsonArray teamsArray;
+        for(int team = 0; team < teams.size(); team++) {
+            QJsonObject criteriaScoresObject;
+            for(int criterion = 0; criterion < criteriaLabels.size(); criterion++) {
+                criteriaScoresObject[criteriaLabels.at(criterion)] = jsonScore(criteriaScores.at(team).at(criterion));
+            }
+            QJsonArray studentsArray;
+            for(const auto ID : std::as_const(teams.at(team).studentIDs)) {
+                const StudentRecord &student = students.at(indexFromID.value(ID));
+                studentsArray.append(QJsonObject{{"ID", student.ID}, {"firstname", student.firstname}, {"lastname", student.lastname},
+                                                 {"email", student.email}, {"section", student.section}});
+            }
+            teamsArray.append(QJsonObject{{"name", teams.at(team).name}, {"score", jsonScore(teams.at(team).score)},
+                                          {"criteriaScores", criteriaScoresObject}, {"students", studentsArray}});
+        }
+        const QJsonObject content{{"teams", teamsArray}, {"teamSetScore", optimizer.teamSetScore}, {"generations", optimizer.finalGeneration}};
+        out << QJsonDocument(content).toJson(QJsonDocument::Indented);
+    }
+    else {
+        QStringList header = {"Team", "Team score"};
+        header << criteriaLabels << "First name" << "Last name" << "Email" << "Section";
+        for(auto &field : header) {
+            field = csvField(field);
+        }
+        out << header.join(',') << Qt::endl;
+        for(int team = 0; team < teams.size(); team++) {
+            QStringList teamFields = {teams.at(team).name, QString::number(teams.at(team).score)};
+            for(const auto score : std::as_const(criteriaScores.at(team))) {
+                teamFields << (Criterion::IS_NO_SCORE(score)? QString() : QString::number(score));
+            }
+            for(const auto ID : std::as_const(teams.at(team).studentIDs)) {
+                const StudentRecord &student = students.at(indexFromID.value(ID));
+                QStringList fields = teamFields;
+                fields << csvField(student.firstname) << csvField(student.lastname) << csvField(student.email) << csvField(student.section);
+                out << fields.join(',') << Qt::endl;
+            }
+        }
+    }
+    out.flush();
+    outputFile.close();
+    GACheckpoint::remove(optimizer.checkpointFileName);
+
+    if(!parser.isSet(quietOption)) {
+        errStream() << QObject::tr("Formed ") << teams.size() << QObject::tr(" teams after ") << optimizer.finalGeneration
+                    << QObject::tr(" generations; team set score ") << optimizer.teamSetScore << Qt::endl;
+        if(optimizer.firstUnpenalizedGeneration == -1) {
+            errStream() << QObject::tr("Every team set was penalized") << Qt::endl;
+        }
+        else if(!optimizer.resumedFromCheckpoint) {
+            errStream() << QObject::tr("First team set without penalties in generation ") << optimizer.firstUnpenalizedGeneration
+                        << (optimizer.greedySeeding? "" : QObject::tr(" (random seeding)")) << Qt::endl;
+        }
+        if(optimizer.resumedFromCheckpoint) {
+            errStream() << QObject::tr("Continued from the checkpoint in ") << optimizer.checkpointFileName << Qt::endl;
+        }
+        if(optimizer.timeBudget > 0) {
+            errStream() << QObject::tr("Time limit of ") << teamingOptions.timeLimitPerSection << QObject::tr(" s: scored ")
+                        << qRound64(optimizer.calibratedGenomesPerSecond) << QObject::tr(" team sets per second, so used ")
+                        << optimizer.ga.populationsize << QObject::tr(" team sets per generation") << Qt::endl;
+        }
+        if(optimizer.localSearchSwaps > 0) {
+            errStream() << QObject::tr("Local search made ") << optimizer.localSearchSwaps << QObject::tr(" swaps, improving scores by ")
+                        << optimizer.localSearchGain << QObject::tr(" in ") << optimizer.localSearchSeconds << " s" << Qt::endl;
+        }
+    }
+
+    qDeleteAll(teamingOptions.criteria);
+    return 0;
+}
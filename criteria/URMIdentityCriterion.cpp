@@ -4,6 +4,7 @@
 #include "dialogs/identityRulesDialog.h"
 #include "widgets/groupingCriteriaCardWidget.h"
 #include <QJsonArray>
+#include <algorithm>
 
 Criterion* URMIdentityCriterion::clone() const {
     auto *copy = new URMIdentityCriterion(dataOptions, criteriaType, weight, penaltyStatus);
@@ -97,66 +98,79 @@ void URMIdentityCriterion::generateCriteriaCard(TeamingOptions *const /*teamingO
     });
 }
 
-void URMIdentityCriterion::calculateScore(const StudentRecord *const students, const int teammates[], const int numTeams, const int teamSizes[],
+std::unique_ptr<Criterion::Workspace> URMIdentityCriterion::createWorkspace(const StudentSnapshot &students, const int /*numTeams*/, const int /*teamSizes*/[]) const
+{
+    auto workspace = std::make_unique<URMWorkspace>();
+    QStringList identityNames;
+    workspace->ruleChecks = compileIdentityRules(identityRules, identityNames);
+    workspace->numIdentities = int(identityNames.size());
+    workspace->identityCounts.fill(0, workspace->numIdentities);
+
+    QList<int> identityOfResponse;
+    identityOfResponse.reserve(students.URMResponses.size());
+    for (const auto &response : students.URMResponses) {
+        identityOfResponse << int(identityNames.indexOf(response));
+    }
+    workspace->identityOfStudent.reserve(students.URMResponseIndex.size());
+    for (const int response : students.URMResponseIndex) {
+        workspace->identityOfStudent << ((response == -1)? -1 : identityOfResponse.at(response));
+    }
+    return workspace;
+}
+
+void URMIdentityCriterion::calculateScore(const StudentSnapshot &students, const int teammates[], const int numTeams, const int teamSizes[],
                                           const TeamingOptions *const /*teamingOptions*/, const DataOptions *const /*dataOptions*/,
-                                          QList<float> &criteriaScores, QList<float> &penaltyPoints) const
+                                          QList<float> &criteriaScores, QList<float> &penaltyPoints, Workspace *const workspace) const
 {
-    int studentNum = 0;
-    for(int team = 0; team < numTeams; team++) {
-        criteriaScores[team] = 1;
+    auto *const urmWorkspace = static_cast<URMWorkspace*>(workspace);
+    forEachTeam(teammates, numTeams, teamSizes, [&](const int teamStudents[], const int teamSize, const int team, const auto fixedTeamSize)
+                {scoreTeam<decltype(fixedTeamSize)::value>(students, teamStudents, teamSize, team, criteriaScores, penaltyPoints, urmWorkspace);});
+}
 
-        if(teamSizes[team] == 1) {
-            studentNum++;
-            continue;
-        }
+void URMIdentityCriterion::calculateTeamScore(const StudentSnapshot &students, const int teammates[], const int teamSize, const int team,
+                                              const TeamingOptions *const /*teamingOptions*/, const DataOptions *const /*dataOptions*/,
+                                              QList<float> &criteriaScores, QList<float> &penaltyPoints, Workspace *const workspace) const
+{
+    auto *const urmWorkspace = static_cast<URMWorkspace*>(workspace);
+    withFixedTeamSize(teamSize, [&](const auto fixedTeamSize)
+                      {scoreTeam<decltype(fixedTeamSize)::value>(students, teammates, teamSize, team, criteriaScores, penaltyPoints, urmWorkspace);});
+}
 
-        bool penaltyApplied = false;
+template<int FixedTeamSize>
+void URMIdentityCriterion::scoreTeam(const StudentSnapshot &/*students*/, const int teamStudents[], const int runtimeTeamSize, const int team,
+                                     QList<float> &criteriaScores, QList<float> &penaltyPoints, URMWorkspace *const urmWorkspace) const
+{
+    const int teamSize = (FixedTeamSize > 0)? FixedTeamSize : runtimeTeamSize;
 
-        // Count how many URM students on the team
-        QMap<QString, int> urmResponseCounts;
-        for(int teammate = 0; teammate < teamSizes[team]; teammate++) {
-            const QString &response = students[teammates[studentNum]].URMResponse;
-            if (!response.isEmpty() && response != "--") {
-                urmResponseCounts[response]++;
-            }
-            studentNum++;
-        }
+    criteriaScores[team] = 1;
 
-        // Apply per-response identity rules from urmIdentityRules
-        // First check responses that are present on the team.
-        auto applyRule = [&](const QString &ruleKey) {
-            const QStringList identities = ruleKey.split('|');
-            int count = 0;
-            for (const QString &identity : identities) {
-                count += urmResponseCounts.value(identity, 0);
-            }
-            const auto &valMap = identityRules.value(ruleKey);
-            for (const auto [operation, values] : valMap.asKeyValueRange()) {
-                for (const int val : values) {
-                    if ((operation == "!=" && count == val) ||
-                        (operation == "<"  && count >= val) ||
-                        (operation == ">"  && count <= val)) {
-                        penaltyApplied = true;
-                        if (penaltyStatus) {
-                            penaltyPoints[team] += 1.0f;
-                        }
-                        break;
-                    }
-                }
-            }
-        };
+    if(teamSize == 1) {
+        return;
+    }
 
-        for (const auto &ruleKey : identityRules.keys()) {
-            applyRule(ruleKey);
+    // Count how many students on the team gave each response named in the rules
+    const int *const identityOfStudent = urmWorkspace->identityOfStudent.constData();
+    int *const urmResponseCounts = urmWorkspace->identityCounts.data();
+    std::fill_n(urmResponseCounts, urmWorkspace->numIdentities, 0);
+    for(int teammate = 0; teammate < teamSize; teammate++) {
+        const int identity = identityOfStudent[teamStudents[teammate]];
+        if (identity != -1) {
+            urmResponseCounts[identity]++;
         }
+    }
 
-        if (penaltyApplied) {
-            criteriaScores[team] = 0;
-        }
+    // Apply per-response identity rules from urmIdentityRules
+    const int numViolations = numIdentityRulesViolated(urmWorkspace->ruleChecks, urmResponseCounts);
+    if (penaltyStatus) {
+        penaltyPoints[team] += float(numViolations);
+    }
 
-        criteriaScores[team] *= weight;
-        penaltyPoints[team] *= weight;
+    if (numViolations > 0) {
+        criteriaScores[team] = 0;
     }
+
+    criteriaScores[team] *= weight;
+    penaltyPoints[team] *= weight;
 }
 
 float URMIdentityCriterion::scoreForOneTeamInDisplay(const QList<StudentRecord> &allStudents, const TeamRecord &team,
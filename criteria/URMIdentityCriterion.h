@@ -17,9 +17,13 @@ public:
     void settingsFromJson(const QJsonObject &json) override;
 
     void generateCriteriaCard(TeamingOptions *const teamingOptions) override;
-    void calculateScore(const StudentRecord *const students, const int teammates[], const int numTeams, const int teamSizes[],
+    std::unique_ptr<Workspace> createWorkspace(const StudentSnapshot &students, const int numTeams, const int teamSizes[]) const override;
+    void calculateScore(const StudentSnapshot &students, const int teammates[], const int numTeams, const int teamSizes[],
                         const TeamingOptions *const teamingOptions, const DataOptions *const dataOptions,
-                        QList<float> &criteriaScores, QList<float> &penaltyPoints) const override;
+                        QList<float> &criteriaScores, QList<float> &penaltyPoints, Workspace *const workspace) const override;
+    void calculateTeamScore(const StudentSnapshot &students, const int teammates[], const int teamSize, const int team,
+                            const TeamingOptions *const teamingOptions, const DataOptions *const dataOptions,
+                            QList<float> &criteriaScores, QList<float> &penaltyPoints, Workspace *const workspace) const override;
 
     // Need to override this one, because this criterion needs to see all teams for scoring any one team
     float scoreForOneTeamInDisplay(const QList<StudentRecord> &allStudents, const TeamRecord &team, const TeamingOptions *teamingOptions,
@@ -39,6 +43,20 @@ public:
     QLabel *ruleCountLabel = nullptr;
 
     QMap<QString, IdentityRule> identityRules;
+
+private:
+    class URMWorkspace : public Workspace {
+    public:
+        QList<IdentityRuleCheck> ruleChecks;
+        QList<int> identityOfStudent;       // index into identityCounts of each student's response, or -1 if no rule names that response
+        QList<int> identityCounts;          // one for each identity named in the rules
+        int numIdentities = 0;
+    };
+
+    // the score of one team, shared by calculateScore and calculateTeamScore (FixedTeamSize is 0 unless the team size is known at compile time)
+    template<int FixedTeamSize>
+    void scoreTeam(const StudentSnapshot &students, const int teamStudents[], const int runtimeTeamSize, const int team,
+                   QList<float> &criteriaScores, QList<float> &penaltyPoints, URMWorkspace *const urmWorkspace) const;
 };
 
 #endif // URMIDENTITYCRITERION_H
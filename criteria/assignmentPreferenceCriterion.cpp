@@ -7,6 +7,7 @@
 #include <QJsonArray>
 #include <QVBoxLayout>
 #include <algorithm>
+#include <cstddef>
 #include <limits>
 
 
@@ -135,142 +136,286 @@ void AssignmentPreferenceCriterion::prepareForOptimization(const StudentRecord *
 QList<int> AssignmentPreferenceCriterion::hungarianAlgorithm(const QList<QList<float>> &costMatrix)
 {
     const int n = static_cast<int>(costMatrix.size());
+    QList<float> flatCostMatrix;
+    flatCostMatrix.reserve(qsizetype(n) * n);
+    for(const auto &row : costMatrix) {
+        flatCostMatrix << row;
+    }
+    HungarianScratch scratch;
+    scratch.resize(n);
+    hungarianAlgorithm(flatCostMatrix.constData(), n, scratch);
+    return scratch.result;
+}
+
+void AssignmentPreferenceCriterion::hungarianAlgorithm(const float costMatrix[], const int n, HungarianScratch &scratch)
+{
     if(n == 0) {
-        return {};
+        return;
     }
 
     // Uses 1-indexed arrays for clarity (standard textbook formulation)
-    const float INF = std::numeric_limits<float>::max();
-
-    QList<float> u(n + 1, 0), v(n + 1, 0);  // potentials for rows and columns
-    QList<int> p(n + 1, 0);                   // p[j] = row assigned to column j (0 = unassigned)
-    QList<int> way(n + 1, 0);                 // way[j] = column preceding j in the augmenting path
+    std::fill(scratch.u.begin(), scratch.u.end(), 0.0f);
+    std::fill(scratch.v.begin(), scratch.v.end(), 0.0f);
+    std::fill(scratch.p.begin(), scratch.p.end(), 0);
+    std::fill(scratch.way.begin(), scratch.way.end(), 0);
 
     for(int i = 1; i <= n; i++) {
-        // Try to assign row i
-        p[0] = i;
-        int j0 = 0;  // virtual column 0
-        QList<float> minv(n + 1, INF);
-        QList<bool> used(n + 1, false);
-
-        do {
-            used[j0] = true;
-            const int i0 = p[j0];
-            float delta = INF;
-            int j1 = -1;
-
-            for(int j = 1; j <= n; j++) {
-                if(!used[j]) {
-                    const float cur = costMatrix[i0 - 1][j - 1] - u[i0] - v[j];
-                    if(cur < minv[j]) {
-                        minv[j] = cur;
-                        way[j] = j0;
-                    }
-                    if(minv[j] < delta) {
-                        delta = minv[j];
-                        j1 = j;
-                    }
-                }
-            }
+        assignRow(costMatrix, n, i, scratch);
+    }
+
+    storeResult(n, scratch);
+}
+
+void AssignmentPreferenceCriterion::assignRow(const float costMatrix[], const int n, const int row, HungarianScratch &scratch)
+{
+    const float INF = std::numeric_limits<float>::max();
 
-            for(int j = 0; j <= n; j++) {
-                if(used[j]) {
-                    u[p[j]] += delta;
-                    v[j] -= delta;
+    auto &u = scratch.u, &v = scratch.v, &minv = scratch.minv;
+    auto &p = scratch.p, &way = scratch.way;
+    auto &used = scratch.used;
+
+    // Try to assign row
+    p[0] = row;
+    int j0 = 0;  // virtual column 0
+    std::fill(minv.begin(), minv.end(), INF);
+    std::fill(used.begin(), used.end(), false);
+
+    do {
+        used[j0] = true;
+        const int i0 = p[j0];
+        const float *const costRow = costMatrix + (qsizetype(i0 - 1) * n);
+        float delta = INF;
+        int j1 = -1;
+
+        for(int j = 1; j <= n; j++) {
+            if(!used[j]) {
+                const float cur = costRow[j - 1] - u[i0] - v[j];
+                if(cur < minv[j]) {
+                    minv[j] = cur;
+                    way[j] = j0;
                 }
-                else {
-                    minv[j] -= delta;
+                if(minv[j] < delta) {
+                    delta = minv[j];
+                    j1 = j;
                 }
             }
+        }
+
+        for(int j = 0; j <= n; j++) {
+            if(used[j]) {
+                u[p[j]] += delta;
+                v[j] -= delta;
+            }
+            else {
+                minv[j] -= delta;
+            }
+        }
 
-            j0 = j1;
-        } while(p[j0] != 0);
+        j0 = j1;
+    } while(p[j0] != 0);
 
-        // Update assignment along the augmenting path
-        do {
-            const int j1 = way[j0];
-            p[j0] = p[j1];
-            j0 = j1;
-        } while(j0 != 0);
-    }
+    // Update assignment along the augmenting path
+    do {
+        const int j1 = way[j0];
+        p[j0] = p[j1];
+        j0 = j1;
+    } while(j0 != 0);
+}
 
+void AssignmentPreferenceCriterion::storeResult(const int n, HungarianScratch &scratch)
+{
     // Convert to 0-indexed: result[row] = column
-    QList<int> result(n);
+    auto &result = scratch.result;
+    std::fill(result.begin(), result.end(), 0);
     for(int j = 1; j <= n; j++) {
-        if(p[j] != 0) {
-            result[p[j] - 1] = j - 1;
+        if(scratch.p[j] != 0) {
+            result[scratch.p[j] - 1] = j - 1;
         }
     }
+}
+
+
+/////////////////////////////////////////////////////////////////////
+// Create the scoring workspace — look up each student's ranked options
+// and size the matrices for max(numTeams, numOptions)
+/////////////////////////////////////////////////////////////////////
+
+std::unique_ptr<Criterion::Workspace> AssignmentPreferenceCriterion::createWorkspace(const StudentSnapshot &students, const int numTeams, const int /*teamSizes*/[]) const
+{
+    auto workspace = std::make_unique<AssignmentWorkspace>();
+    workspace->assignment.fill(-1, numTeams);
+    workspace->teamScores.fill(0.0f, numTeams);
+    if(numOptions == 0 || numRankedChoices == 0) {
+        return workspace;
+    }
+
+    workspace->rankedOptions.fill(-1, qsizetype(students.numStudents) * numRankedChoices);
+    for(int student = 0; student < students.numStudents; student++) {
+        const auto &prefs = students.records[student].assignmentPreferences;
+        for(int r = 0; r < prefs.size() && r < numRankedChoices; r++) {
+            workspace->rankedOptions[qsizetype(student) * numRankedChoices + r] = optionNameToIndex.value(prefs[r], -1);
+        }
+    }
+
+    const int dim = std::max(numTeams, numOptions);
+    workspace->utilityMatrix.fill(0.0f, qsizetype(dim) * dim);
+    workspace->costMatrix.fill(0.0f, qsizetype(dim) * dim);
+    workspace->hungarian.resize(dim);
+    workspace->teamFingerprints.fill(0, numTeams);
+    workspace->changedRows.reserve(numTeams);
+    return workspace;
+}
 
-    return result;
+
+/////////////////////////////////////////////////////////////////////
+// Genome memory: a SolvedAssignmentHeader, numTeams fingerprints, then u, v, and p (each dim + 1 long)
+/////////////////////////////////////////////////////////////////////
+
+int AssignmentPreferenceCriterion::genomeMemorySize(const int numTeams) const
+{
+    if(numOptions == 0 || numRankedChoices == 0) {
+        return 0;
+    }
+    const int dim = std::max(numTeams, numOptions);
+    return int(sizeof(SolvedAssignmentHeader) + (numTeams * sizeof(uint64_t)) + ((dim + 1) * (sizeof(float) + sizeof(float) + sizeof(int))));
 }
 
 
 /////////////////////////////////////////////////////////////////////
 // Build utility matrix and solve assignment
-// Returns assignment[team] = option index
-// Fills teamScores with per-team normalized scores (0 to 1)
+// Fills workspace.assignment[team] = option index
+// Fills workspace.teamScores with per-team normalized scores (0 to 1)
+// If there is a genome memory holding a solved assignment (from a parent), only the teams that differ from the parent's are reassigned
 /////////////////////////////////////////////////////////////////////
 
-QList<int> AssignmentPreferenceCriterion::solveAssignment(const StudentRecord *const students, const int teammates[],
-                                                                const int numTeams, const int teamSizes[],
-                                                                QList<float> &teamScores) const
+void AssignmentPreferenceCriterion::solveAssignment(const int teammates[], const int numTeams, const int teamSizes[],
+                                                    AssignmentWorkspace &workspace) const
 {
     if(numOptions == 0 || numRankedChoices == 0) {
-        teamScores.assign(numTeams, 0.0f);
-        return {numTeams, -1};
+        std::fill(workspace.teamScores.begin(), workspace.teamScores.end(), 0.0f);
+        std::fill(workspace.assignment.begin(), workspace.assignment.end(), -1);
+        return;
     }
 
     // Build square matrix of size max(numTeams, numOptions)
     // We maximize utility, but Hungarian minimizes cost, so we use cost = maxUtility - utility
     const int dim = std::max(numTeams, numOptions);
+    float *const utilityMatrix = workspace.utilityMatrix.data();
+    float *const costMatrix = workspace.costMatrix.data();
+    uint64_t *const teamFingerprints = workspace.teamFingerprints.data();
 
-    // First pass: compute utility matrix and find max utility for cost conversion
-    QList<QList<float>> utilityMatrix(dim, QList<float>(dim, 0.0f));
+    // First pass: compute utility matrix (and a fingerprint of each team's students) and find max utility for cost conversion
+    std::fill(workspace.utilityMatrix.begin(), workspace.utilityMatrix.end(), 0.0f);
 
     int studentNum = 0;
     for(int team = 0; team < numTeams; team++) {
+        float *const utilityRow = utilityMatrix + (qsizetype(team) * dim);
+        uint64_t fingerprint = 0;
         for(int m = 0; m < teamSizes[team]; m++) {
-            const auto &prefs = students[teammates[studentNum]].assignmentPreferences;
-            for(int r = 0; r < prefs.size() && r < numRankedChoices; r++) {
-                auto it = optionNameToIndex.find(prefs[r]);
-                if(it != optionNameToIndex.end()) {
-                    utilityMatrix[team][it.value()] += static_cast<float>(numRankedChoices - r);
+            const int *const rankedOptions = workspace.rankedOptions.constData() + qsizetype(teammates[studentNum]) * numRankedChoices;
+            for(int r = 0; r < numRankedChoices; r++) {
+                if(rankedOptions[r] != -1) {
+                    utilityRow[rankedOptions[r]] += static_cast<float>(numRankedChoices - r);
                 }
             }
+            // (splitmix64 of each student, summed so that the order of students within the team doesn't matter)
+            uint64_t hash = uint64_t(teammates[studentNum]) + 0x9E3779B97F4A7C15ULL;
+            hash = (hash ^ (hash >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            hash = (hash ^ (hash >> 27)) * 0x94D049BB133111EBULL;
+            fingerprint += hash ^ (hash >> 31);
             studentNum++;
         }
+        teamFingerprints[team] = fingerprint;
     }
     // Dummy rows (teams beyond numTeams) and dummy columns (options beyond numOptions) stay at 0 utility
 
-    float maxUtility = 0.0f;
-    for(int i = 0; i < dim; i++) {
-        for(int j = 0; j < dim; j++) {
-            maxUtility = std::max(maxUtility, utilityMatrix[i][j]);
-        }
-    }
+    const float maxUtility = *std::max_element(workspace.utilityMatrix.cbegin(), workspace.utilityMatrix.cend());
 
     // Convert to cost matrix: cost = maxUtility - utility
-    QList<QList<float>> costMatrix(dim, QList<float>(dim, 0.0f));
-    for(int i = 0; i < dim; i++) {
-        for(int j = 0; j < dim; j++) {
-            costMatrix[i][j] = maxUtility - utilityMatrix[i][j];
+    for(qsizetype element = 0; element < qsizetype(dim) * dim; element++) {
+        costMatrix[element] = maxUtility - utilityMatrix[element];
+    }
+
+    // Solve, starting from the memory's solution if there is one and it doesn't need too much repair
+    auto &hungarian = workspace.hungarian;
+    std::byte *const memory = workspace.genomeMemory;
+    SolvedAssignmentHeader *header = nullptr;
+    uint64_t *storedFingerprints = nullptr;
+    float *storedU = nullptr, *storedV = nullptr;
+    int *storedP = nullptr;
+    if(memory != nullptr) {
+        header = reinterpret_cast<SolvedAssignmentHeader*>(memory);
+        storedFingerprints = reinterpret_cast<uint64_t*>(memory + sizeof(SolvedAssignmentHeader));
+        storedU = reinterpret_cast<float*>(storedFingerprints + numTeams);
+        storedV = storedU + (dim + 1);
+        storedP = reinterpret_cast<int*>(storedV + (dim + 1));
+    }
+    bool solved = false;
+    if((header != nullptr) && (header->solved != 0)) {
+        auto &changedRows = workspace.changedRows;
+        changedRows.clear();
+        for(int team = 0; team < numTeams; team++) {
+            if(teamFingerprints[team] != storedFingerprints[team]) {
+                changedRows << (team + 1);
+            }
+        }
+
+        // reassigning a row costs about as much as one row of a full solve
+        if(changedRows.size() <= dim / 2) {
+            std::copy(storedU, storedU + (dim + 1), hungarian.u.begin());
+            std::copy(storedV, storedV + (dim + 1), hungarian.v.begin());
+            std::copy(storedP, storedP + (dim + 1), hungarian.p.begin());
+
+            // costs of unchanged rows all shifted by the change in maxUtility, so shift their potentials to match
+            const float shift = maxUtility - header->maxUtility;
+            for(int i = 1; i <= dim; i++) {
+                hungarian.u[i] += shift;
+            }
+
+            // unassign each changed row, and lower its potential so that none of its reduced costs are negative
+            for(int j = 1; j <= dim; j++) {
+                const int row = hungarian.p[j];
+                if((row != 0) && (row <= numTeams) && (teamFingerprints[row - 1] != storedFingerprints[row - 1])) {
+                    hungarian.p[j] = 0;
+                }
+            }
+            for(const int row : std::as_const(changedRows)) {
+                const float *const costRow = costMatrix + (qsizetype(row - 1) * dim);
+                float minReducedCost = std::numeric_limits<float>::max();
+                for(int j = 1; j <= dim; j++) {
+                    minReducedCost = std::min(minReducedCost, costRow[j - 1] - hungarian.v[j]);
+                }
+                hungarian.u[row] = minReducedCost;
+            }
+
+            for(const int row : std::as_const(changedRows)) {
+                assignRow(costMatrix, dim, row, hungarian);
+            }
+            storeResult(dim, hungarian);
+            solved = true;
         }
     }
+    if(!solved) {
+        hungarianAlgorithm(costMatrix, dim, hungarian);
+    }
 
-    // Solve
-    const QList<int> assignment = hungarianAlgorithm(costMatrix);
+    if(header != nullptr) {
+        header->solved = 1;
+        header->maxUtility = maxUtility;
+        std::copy(teamFingerprints, teamFingerprints + numTeams, storedFingerprints);
+        std::copy(hungarian.u.cbegin(), hungarian.u.cend(), storedU);
+        std::copy(hungarian.v.cbegin(), hungarian.v.cend(), storedV);
+        std::copy(hungarian.p.cbegin(), hungarian.p.cend(), storedP);
+    }
 
     // Extract per-team scores
-    teamScores.resize(numTeams);
     for(int team = 0; team < numTeams; team++) {
-        const int assignedOption = assignment[team];
-        const float utility = utilityMatrix[team][assignedOption];
+        const int assignedOption = hungarian.result[team];
+        workspace.assignment[team] = assignedOption;
+        const float utility = utilityMatrix[(qsizetype(team) * dim) + assignedOption];
         const auto maxPossible = static_cast<float>(teamSizes[team] * numRankedChoices);
-        teamScores[team] = (maxPossible > 0.0f) ? (utility / maxPossible) : 0.0f;
+        workspace.teamScores[team] = (maxPossible > 0.0f) ? (utility / maxPossible) : 0.0f;
     }
-
-    return assignment;
 }
 
 
@@ -278,26 +423,25 @@ QList<int> AssignmentPreferenceCriterion::solveAssignment(const StudentRecord *c
 // calculateScore — called by the GA for every genome
 /////////////////////////////////////////////////////////////////////
 
-void AssignmentPreferenceCriterion::calculateScore(const StudentRecord *const students, const int teammates[], const int numTeams, const int teamSizes[],
+void AssignmentPreferenceCriterion::calculateScore(const StudentSnapshot &/*students*/, const int teammates[], const int numTeams, const int teamSizes[],
                                                    const TeamingOptions *const /*teamingOptions*/, const DataOptions *const /*dataOptions*/,
-                                                   QList<float> &criteriaScores, QList<float> &penaltyPoints) const
+                                                   QList<float> &criteriaScores, QList<float> &penaltyPoints, Workspace *const workspace) const
 {
-    QList<float> teamScores;
-    const QList<int> assignment = solveAssignment(students, teammates, numTeams, teamSizes, teamScores);
+    auto &assignmentWorkspace = *static_cast<AssignmentWorkspace*>(workspace);
+    solveAssignment(teammates, numTeams, teamSizes, assignmentWorkspace);
+    const QList<int> &assignment = assignmentWorkspace.assignment;
+    const QList<float> &teamScores = assignmentWorkspace.teamScores;
 
+    int studentNum = 0;
     for(int team = 0; team < numTeams; team++) {
 
         // Penalty: if enabled and the assigned option was left unranked by any or all team members
         if((penalizeNoOneRanked || penalizeAnyOneUnranked) && assignment[team] >= 0 && assignment[team] < numOptions) {
-            const QString &assignedName = allOptionNames[assignment[team]];
-            int studentNum = 0;
-            for(int t = 0; t < team; t++) {
-                studentNum += teamSizes[t];
-            }
             bool anyoneRanked = false;
             bool everyoneRanked = true;
             for(int m = 0; m < teamSizes[team]; m++) {
-                if(students[teammates[studentNum + m]].assignmentPreferences.contains(assignedName)) {
+                const int *const rankedOptions = assignmentWorkspace.rankedOptions.constData() + qsizetype(teammates[studentNum + m]) * numRankedChoices;
+                if(std::find(rankedOptions, rankedOptions + numRankedChoices, assignment[team]) != rankedOptions + numRankedChoices) {
                     anyoneRanked = true;
                 }
                 else {
@@ -311,6 +455,7 @@ void AssignmentPreferenceCriterion::calculateScore(const StudentRecord *const st
                 penaltyPoints[team] += 1.0f;
             }
         }
+        studentNum += teamSizes[team];
 
         criteriaScores[team] = teamScores[team] * weight;
         penaltyPoints[team] *= weight;
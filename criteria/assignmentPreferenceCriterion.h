@@ -20,9 +20,12 @@ public:
 
     void generateCriteriaCard(TeamingOptions *const teamingOptions) override;
     void prepareForOptimization(const StudentRecord *students, int numStudents, const DataOptions *dataOptions) override;
-    void calculateScore(const StudentRecord *const students, const int teammates[], const int numTeams, const int teamSizes[],
+    std::unique_ptr<Workspace> createWorkspace(const StudentSnapshot &students, const int numTeams, const int teamSizes[]) const override;
+    void calculateScore(const StudentSnapshot &students, const int teammates[], const int numTeams, const int teamSizes[],
                         const TeamingOptions *const teamingOptions, const DataOptions *const dataOptions,
-                        QList<float> &criteriaScores, QList<float> &penaltyPoints) const override;
+                        QList<float> &criteriaScores, QList<float> &penaltyPoints, Workspace *const workspace) const override;
+    bool scoresTeamsIndependently() const override { return false; }     // assignments are made across all teams at once
+    int genomeMemorySize(const int numTeams) const override;               // the genome's solved assignment, to warm-start its children's
 
     // Must override: assignment is inherently multi-team, so single-team display scoring needs the full assignment
     float scoreForOneTeamInDisplay(const QList<StudentRecord> &allStudents, const TeamRecord &team, const TeamingOptions *teamingOptions,
@@ -59,15 +62,48 @@ private:
     int numOptions = 0;
     int numRankedChoices = 0;                        // k: how many choices each student ranked
 
+    // Scratch arrays for the Hungarian algorithm on an NxN matrix (all 1-indexed, so N+1 long)
+    struct HungarianScratch {
+        QList<float> u, v, minv;    // potentials for rows and columns, and the slack of each column
+        QList<int> p, way;          // p[j] = row assigned to column j (0 = unassigned); way[j] = column preceding j in the augmenting path
+        QList<bool> used;
+        QList<int> result;          // result[row] = column (0-indexed, N long)
+        void resize(int n) {u.resize(n + 1); v.resize(n + 1); minv.resize(n + 1); p.resize(n + 1); way.resize(n + 1); used.resize(n + 1); result.resize(n);}
+    };
+
     // Hungarian algorithm: solves min-cost assignment on a square cost matrix
     // Returns the column assigned to each row (result[row] = col)
     static QList<int> hungarianAlgorithm(const QList<QList<float>> &costMatrix);
+    // Same, but on an n x n row-major matrix, using (already sized) scratch arrays and leaving the result in scratch.result
+    static void hungarianAlgorithm(const float costMatrix[], const int n, HungarianScratch &scratch);
+    // One step of the Hungarian algorithm: assign (1-indexed) row to a column, reassigning other rows along the cheapest augmenting path
+    // and updating the potentials; requires all reduced costs (cost - u - v) to be >= 0, and 0 for every assigned row/column pair
+    static void assignRow(const float costMatrix[], const int n, const int row, HungarianScratch &scratch);
+    static void storeResult(const int n, HungarianScratch &scratch);
+
+    // What each genome keeps from its solved assignment (in its genome memory), so that its children can start from it:
+    // a header, then each team's fingerprint, then the potentials and the row assigned to each column (p) from the Hungarian algorithm
+    struct SolvedAssignmentHeader {
+        int solved;                             // 0 until the genome's assignment has been solved
+        float maxUtility;                       // the value used to convert utilities into costs
+    };
+
+    class AssignmentWorkspace : public Workspace {
+    public:
+        QList<int> rankedOptions;               // numStudents x numRankedChoices: option index of each student's ranked choices (-1 if none)
+        QList<float> utilityMatrix;             // dim x dim (row-major), dim = max(numTeams, numOptions)
+        QList<float> costMatrix;
+        HungarianScratch hungarian;
+        QList<uint64_t> teamFingerprints;       // for spotting which teams differ from those of the genome that the genome memory came from
+        QList<int> changedRows;
+        QList<int> assignment;                  // assignment[team] = option index
+        QList<float> teamScores;                // per-team normalized score
+    };
 
     // Build utility matrix and solve assignment for a given set of teams
-    // Returns a map from team index -> assigned option index
-    // Also fills teamScores with the per-team normalized score
-    QList<int> solveAssignment(const StudentRecord *const students, const int teammates[], const int numTeams, const int teamSizes[],
-                                     QList<float> &teamScores) const;
+    // Fills workspace.assignment with team index -> assigned option index
+    // Also fills workspace.teamScores with the per-team normalized score
+    void solveAssignment(const int teammates[], const int numTeams, const int teamSizes[], AssignmentWorkspace &workspace) const;
 
     // Cache for display: last solved assignment (team studentIDs hash -> option name)
     // Mutable because scoreForOneTeamInDisplay needs to cache results from a const-like context
@@ -4,6 +4,7 @@
 #include <QJsonArray>
 #include <QLabel>
 #include <QVBoxLayout>
+#include <algorithm>
 
 Criterion* AttributeCriterion::clone() const {
     auto *copy = new AttributeCriterion(dataOptions, criteriaType, weight, penaltyStatus, nullptr, attributeIndex);
@@ -120,222 +121,270 @@ void AttributeCriterion::prepareForOptimization(const StudentRecord */*students*
     }
 }
 
-void AttributeCriterion::calculateScore(const StudentRecord *const students, const int teammates[], const int numTeams, const int teamSizes[],
+std::unique_ptr<Criterion::Workspace> AttributeCriterion::createWorkspace(const StudentSnapshot &students, const int numTeams, const int teamSizes[]) const
+{
+    // room for every value of the largest team, so that gathering a team's values never has to grow the vectors
+    const int largestTeamSize = (numTeams > 0) ? *std::max_element(teamSizes, teamSizes + numTeams) : 0;
+    int maxContinuousValsPerStudent = 1;   // timezone always has one continuous value
+    auto workspace = std::make_unique<AttributeWorkspace>();
+    if(attributeIndex < students.attributeVals_discrete.size()) {
+        maxContinuousValsPerStudent = std::max(maxContinuousValsPerStudent, students.attributeVals_continuous[attributeIndex].maxSize());
+
+        // a count for every discrete value that any student has (including the unknown sentinel)
+        const auto &discreteVals = students.attributeVals_discrete[attributeIndex];
+        if(students.numStudents > 0) {
+            const auto [lowest, highest] = std::minmax_element(discreteVals.begin(0), discreteVals.end(students.numStudents - 1));
+            if(lowest != discreteVals.end(students.numStudents - 1)) {
+                workspace->lowestValue = *lowest;
+                workspace->valueCounts.assign(*highest - *lowest + 1, 0);
+            }
+        }
+    }
+    workspace->continuousLevels.reserve(largestTeamSize * maxContinuousValsPerStudent);
+    workspace->gaps.reserve(largestTeamSize * maxContinuousValsPerStudent);
+    return workspace;
+}
+
+void AttributeCriterion::calculateScore(const StudentSnapshot &students, const int teammates[], const int numTeams, const int teamSizes[],
                                         const TeamingOptions *const /*teamingOptions*/, const DataOptions *const dataOptions,
-                                        QList<float> &criteriaScores, QList<float> &penaltyPoints) const
+                                        QList<float> &criteriaScores, QList<float> &penaltyPoints, Workspace *const workspace) const
 {
+    auto *const attributeWorkspace = static_cast<AttributeWorkspace*>(workspace);
+    forEachTeam(teammates, numTeams, teamSizes, [&](const int teamStudents[], const int teamSize, const int team, const auto fixedTeamSize)
+                {scoreTeam<decltype(fixedTeamSize)::value>(students, teamStudents, teamSize, team, dataOptions, criteriaScores, penaltyPoints, attributeWorkspace);});
+}
+
+void AttributeCriterion::calculateTeamScore(const StudentSnapshot &students, const int teammates[], const int teamSize, const int team,
+                                            const TeamingOptions *const /*teamingOptions*/, const DataOptions *const dataOptions,
+                                            QList<float> &criteriaScores, QList<float> &penaltyPoints, Workspace *const workspace) const
+{
+    auto *const attributeWorkspace = static_cast<AttributeWorkspace*>(workspace);
+    withFixedTeamSize(teamSize, [&](const auto fixedTeamSize)
+                      {scoreTeam<decltype(fixedTeamSize)::value>(students, teammates, teamSize, team, dataOptions, criteriaScores, penaltyPoints, attributeWorkspace);});
+}
+
+template<int FixedTeamSize>
+void AttributeCriterion::scoreTeam(const StudentSnapshot &students, const int teamStudents[], const int runtimeTeamSize, const int team,
+                                   const DataOptions *const dataOptions, QList<float> &criteriaScores, QList<float> &penaltyPoints,
+                                   AttributeWorkspace *const attributeWorkspace) const
+{
+    const int teamSize = (FixedTeamSize > 0)? FixedTeamSize : runtimeTeamSize;
+
+    auto &continuousLevels = attributeWorkspace->continuousLevels;
+    int *const valueCounts = attributeWorkspace->valueCounts.data();
+    const int lowestValue = attributeWorkspace->lowestValue;
+    const int numValueCounts = int(attributeWorkspace->valueCounts.size());
+    const auto countOf = [valueCounts, lowestValue, numValueCounts](const int value)
+                         {return ((value >= lowestValue) && (value - lowestValue < numValueCounts))? valueCounts[value - lowestValue] : 0;};
+
     const auto type = dataOptions->attributeType[attributeIndex];
     const bool thisIsNumerical = (type == DataOptions::AttributeType::numerical);
     const bool thisIsTimezone  = (type == DataOptions::AttributeType::timezone);
 
     const bool doPenalty = penaltyStatus || haveAnyRequired || haveAnyIncompatible;
 
-    int studentNum = 0;
-    for(int team = 0; team < numTeams; team++) {
-        if(diversity == Criterion::AttributeDiversity::ignored) {
-            criteriaScores[team] = 0.0f;
-            continue;
-        }
-
-        // Gather values for this team
-        std::multiset<int>   discreteLevels;
-        std::multiset<float> continuousLevels;
-
-        for(int teammate = 0; teammate < teamSizes[team]; teammate++) {
-            const auto &student = students[teammates[studentNum]];
-            if(thisIsTimezone) {
-                // discrete sentinel still used for unknown-detection
-                discreteLevels.insert(student.attributeVals_discrete[attributeIndex].constBegin(),
-                                      student.attributeVals_discrete[attributeIndex].constEnd());
-                continuousLevels.insert(student.timezone);
-            }
-            else if(thisIsNumerical) {
-                continuousLevels.insert(student.attributeVals_continuous[attributeIndex].constBegin(),
-                                        student.attributeVals_continuous[attributeIndex].constEnd());
-            }
-            else {
-                discreteLevels.insert(student.attributeVals_discrete[attributeIndex].constBegin(),
-                                      student.attributeVals_discrete[attributeIndex].constEnd());
+    const auto &discreteVals = students.attributeVals_discrete[attributeIndex];
+    const auto &continuousVals = students.attributeVals_continuous[attributeIndex];
+
+    if(diversity == Criterion::AttributeDiversity::ignored) {
+        criteriaScores[team] = 0.0f;
+        return;
+    }
+
+    // Gather values for this team: discrete values are counted (along with the lowest, highest, and number of distinct known values),
+    // and continuous values are listed
+    int numUniqueVals = 0, lowestVal = 0, highestVal = 0;
+    continuousLevels.clear();
+    for(int teammate = 0; teammate < teamSize; teammate++) {
+        const int student = teamStudents[teammate];
+        if(!thisIsNumerical) {
+            // (for timezone, the discrete sentinel is still used for the penalties)
+            for(const int *value = discreteVals.begin(student); value != discreteVals.end(student); value++) {
+                if((valueCounts[*value - lowestValue]++ == 0) && (*value != -1)) {
+                    lowestVal = (numUniqueVals == 0)? *value : std::min(lowestVal, *value);
+                    highestVal = (numUniqueVals == 0)? *value : std::max(highestVal, *value);
+                    numUniqueVals++;
+                }
             }
-            studentNum++;
         }
+        if(thisIsTimezone) {
+            continuousLevels.push_back(students.timezone[student]);
+        }
+        else if(thisIsNumerical) {
+            continuousLevels.insert(continuousLevels.end(), continuousVals.begin(student), continuousVals.end(student));
+        }
+    }
 
-        // ── Penalties ──────────────────────────────────────────────────────
-        if(doPenalty && !thisIsNumerical) {
-            if(haveAnyIncompatible) {
-                for(const auto &pair : std::as_const(incompatibleValues)) {
-                    const int n = static_cast<int>(discreteLevels.count(pair.first));
-                    if(pair.first == pair.second) {
-                        penaltyPoints[team] += (n * (n - 1)) / 2.0f;
-                    }
-                    else {
-                        const int m = static_cast<int>(discreteLevels.count(pair.second));
-                        penaltyPoints[team] += n * m;
-                    }
+    // ── Penalties ──────────────────────────────────────────────────────
+    if(doPenalty && !thisIsNumerical) {
+        if(haveAnyIncompatible) {
+            for(const auto &pair : std::as_const(incompatibleValues)) {
+                const int n = countOf(pair.first);
+                if(pair.first == pair.second) {
+                    penaltyPoints[team] += (n * (n - 1)) / 2.0f;
+                }
+                else {
+                    const int m = countOf(pair.second);
+                    penaltyPoints[team] += n * m;
                 }
             }
-            if(haveAnyRequired) {
-                for(const auto value : std::as_const(requiredValues)) {
-                    if(discreteLevels.count(value) == 0) {
-                        penaltyPoints[team] += 1.0f;
-                    }
+        }
+        if(haveAnyRequired) {
+            for(const auto value : std::as_const(requiredValues)) {
+                if(countOf(value) == 0) {
+                    penaltyPoints[team] += 1.0f;
                 }
             }
         }
+    }
 
-        // Remove the unknown sentinel before scoring
-        discreteLevels.erase(-1);
-
-        // ── Scoring ────────────────────────────────────────────────────────
-        if(thisIsNumerical) {
-            if(continuousLevels.empty()) {
-                criteriaScores[team] = 0.0f;
+    // Reset the counts for the next team
+    if(!thisIsNumerical) {
+        for(int teammate = 0; teammate < teamSize; teammate++) {
+            const int student = teamStudents[teammate];
+            for(const int *value = discreteVals.begin(student); value != discreteVals.end(student); value++) {
+                valueCounts[*value - lowestValue] = 0;
             }
-            else {
-                if(diversity == Criterion::AttributeDiversity::average) {
-                    // Score = how close the team mean is to the overall mean, normalised over the observed data range.
-                    float teamSum = 0.0f;
-                    for(const float v : continuousLevels) {
-                        teamSum += v;
-                    }
-                    const float teamMean = teamSum / static_cast<float>(continuousLevels.size());
-
-                    // Determine the range to normalise against:
-                    // prefer the observed range stored in DataOptions; fall back to targetMin/Max.
-                    float rangeSpan = 1.0f;
-                    const auto &contRange = dataOptions->attributeVals_continuous[attributeIndex];
-                    if(contRange.size() >= 2) {
-                        rangeSpan = *contRange.crbegin() - *contRange.cbegin();
-                    }
-                    else if(targetMax > targetMin) {
-                        rangeSpan = targetMax - targetMin;
-                    }
-                    if(rangeSpan < 1e-6f) {
-                        rangeSpan = 1.0f;  // guard against zero-range data
-                    }
+        }
+    }
 
-                    const float deviation = std::abs(teamMean - cachedOverallMean);
-                    criteriaScores[team] = std::max(0.0f, 1.0f - (deviation / (rangeSpan * 0.5f)));
+    // ── Scoring ────────────────────────────────────────────────────────
+    if(thisIsNumerical) {
+        if(continuousLevels.empty()) {
+            criteriaScores[team] = 0.0f;
+        }
+        else {
+            if(diversity == Criterion::AttributeDiversity::average) {
+                // Score = how close the team mean is to the overall mean, normalised over the observed data range.
+                float teamSum = 0.0f;
+                for(const float v : continuousLevels) {
+                    teamSum += v;
+                }
+                const float teamMean = teamSum / static_cast<float>(continuousLevels.size());
+
+                // Determine the range to normalise against:
+                // prefer the observed range stored in DataOptions; fall back to targetMin/Max.
+                float rangeSpan = 1.0f;
+                const auto &contRange = dataOptions->attributeVals_continuous[attributeIndex];
+                if(contRange.size() >= 2) {
+                    rangeSpan = *contRange.crbegin() - *contRange.cbegin();
+                }
+                else if(targetMax > targetMin) {
+                    rangeSpan = targetMax - targetMin;
+                }
+                if(rangeSpan < 1e-6f) {
+                    rangeSpan = 1.0f;  // guard against zero-range data
                 }
-                else if(diversity == Criterion::AttributeDiversity::similar || diversity == Criterion::AttributeDiversity::diverse) {
-                    if(cachedRangeAttributeLevels <= 0.0f || continuousLevels.size() < 2) {
-                        criteriaScores[team] = 0.0f;
+
+                const float deviation = std::abs(teamMean - cachedOverallMean);
+                criteriaScores[team] = std::max(0.0f, 1.0f - (deviation / (rangeSpan * 0.5f)));
+            }
+            else if(diversity == Criterion::AttributeDiversity::similar || diversity == Criterion::AttributeDiversity::diverse) {
+                if(cachedRangeAttributeLevels <= 0.0f || continuousLevels.size() < 2) {
+                    criteriaScores[team] = 0.0f;
+                }
+                else {
+                    std::sort(continuousLevels.begin(), continuousLevels.end());
+                    // spread: fraction of population range covered by the sample
+                    const float spread = (*continuousLevels.crbegin() - *continuousLevels.cbegin()) / cachedRangeAttributeLevels;
+                    if(continuousLevels.size() == 2) {
+                        criteriaScores[team] = spread;
                     }
                     else {
-                        // spread: fraction of population range covered by the sample
-                        const float spread = (*continuousLevels.crbegin() - *continuousLevels.cbegin()) / cachedRangeAttributeLevels;
-                        if(continuousLevels.size() == 2) {
-                            criteriaScores[team] = spread;
+                        // uniformity: 1 - Gini coefficient of gaps between consecutive sorted values
+                        auto &gaps = attributeWorkspace->gaps;
+                        gaps.clear();
+                        auto prev = continuousLevels.cbegin();
+                        for(auto it = std::next(prev); it != continuousLevels.cend(); ++it) {
+                            gaps.push_back(*it - *prev);
+                            prev = it;
                         }
-                        else {
-                            // uniformity: 1 - Gini coefficient of gaps between consecutive sorted values
-                            // compute the gaps (sample is already sorted via multiset)
-                            QList<float> gaps;
-                            gaps.reserve(continuousLevels.size() - 1);
-                            auto prev = continuousLevels.cbegin();
-                            for(auto it = std::next(prev); it != continuousLevels.cend(); ++it) {
-                                gaps.push_back(*it - *prev);
-                                prev = it;
-                            }
-
-                            // Gini = sum of |g_i - g_j| / (2 * numGaps * sumOfGaps)
-                            float sumOfGaps = 0.0f;
-                            for(const float g : gaps) {
-                                sumOfGaps += g;
-                            }
-                            if(sumOfGaps <= 0.0f) {
-                                // all values identical
-                                criteriaScores[team] = 0.0f;
-                                continue;
-                            }
-
-                            float sumAbsDiffs = 0.0f;
-                            const int numGaps = static_cast<int>(gaps.size());
-                            for(int i = 0; i < numGaps; i++) {
-                                for(int j = i + 1; j < numGaps; j++) {
-                                    sumAbsDiffs += std::abs(gaps[i] - gaps[j]);
-                                }
-                            }
-                            sumAbsDiffs *= 2.0f;  // account for both (i,j) and (j,i)
-
-                            const float gini = sumAbsDiffs / (2.0f * numGaps * sumOfGaps);
-
-                            criteriaScores[team] = spread * (1.0f - gini);
+
+                        // Gini = sum of |g_i - g_j| / (2 * numGaps * sumOfGaps)
+                        float sumOfGaps = 0.0f;
+                        for(const float g : gaps) {
+                            sumOfGaps += g;
+                        }
+                        if(sumOfGaps <= 0.0f) {
+                            // all values identical
+                            criteriaScores[team] = 0.0f;
+                            return;
                         }
 
-                        if(diversity == Criterion::AttributeDiversity::similar) {
-                            criteriaScores[team] = 1.0f - criteriaScores[team];
+                        // with the gaps sorted, each one is larger than all the gaps before it and smaller than all the gaps after it,
+                        // so the sum of |g_i - g_j| over all pairs i < j is the sum of g_i * (i - (numGaps - 1 - i))
+                        std::sort(gaps.begin(), gaps.end());
+                        float sumAbsDiffs = 0.0f;
+                        const int numGaps = static_cast<int>(gaps.size());
+                        for(int i = 0; i < numGaps; i++) {
+                            sumAbsDiffs += gaps[i] * static_cast<float>((2 * i) - numGaps + 1);
                         }
+                        sumAbsDiffs *= 2.0f;  // account for both (i,j) and (j,i)
+
+                        const float gini = sumAbsDiffs / (2.0f * numGaps * sumOfGaps);
+
+                        criteriaScores[team] = spread * (1.0f - gini);
+                    }
+
+                    if(diversity == Criterion::AttributeDiversity::similar) {
+                        criteriaScores[team] = 1.0f - criteriaScores[team];
                     }
                 }
             }
         }
-        else if(thisIsTimezone) {
-            if((weight > 0) && !continuousLevels.empty()) {
-                const float tzRange = *continuousLevels.crbegin() - *continuousLevels.cbegin();
-                // totRangeAttributeLevels is 0 for timezone — use the actual observed tz span
-                // (kept consistent with pre-refactor behaviour: score = range / totRange)
-                const float totTzRange = dataOptions->attributeVals_continuous[attributeIndex].size() >= 2
-                                             ? *dataOptions->attributeVals_continuous[attributeIndex].crbegin()
-                                                   - *dataOptions->attributeVals_continuous[attributeIndex].cbegin()
-                                             : 24.0f;  // fallback: 24-hour span
-                const float span = totTzRange > 0.0f ? totTzRange : 24.0f;
-                criteriaScores[team] = tzRange / span;
-                if(diversity == Criterion::AttributeDiversity::similar) {
-                    criteriaScores[team] = 1.0f - criteriaScores[team];
-                }
-            }
-            else {
-                criteriaScores[team] = 0.0f;
+    }
+    else if(thisIsTimezone) {
+        if((weight > 0) && !continuousLevels.empty()) {
+            const auto [lowestTz, highestTz] = std::minmax_element(continuousLevels.cbegin(), continuousLevels.cend());
+            const float tzRange = *highestTz - *lowestTz;
+            // totRangeAttributeLevels is 0 for timezone — use the actual observed tz span
+            // (kept consistent with pre-refactor behaviour: score = range / totRange)
+            const float totTzRange = dataOptions->attributeVals_continuous[attributeIndex].size() >= 2
+                                         ? *dataOptions->attributeVals_continuous[attributeIndex].crbegin()
+                                               - *dataOptions->attributeVals_continuous[attributeIndex].cbegin()
+                                         : 24.0f;  // fallback: 24-hour span
+            const float span = totTzRange > 0.0f ? totTzRange : 24.0f;
+            criteriaScores[team] = tzRange / span;
+            if(diversity == Criterion::AttributeDiversity::similar) {
+                criteriaScores[team] = 1.0f - criteriaScores[team];
             }
         }
         else {
-            // Discrete types: ordered/multiordered, categorical/multicategorical
-            if((weight > 0) && !discreteLevels.empty()) {
-                if((type == DataOptions::AttributeType::ordered) ||
-                    (type == DataOptions::AttributeType::multiordered)) {
-                    // Score weighted toward range, with a lesser contribution from unique-value count
-                    const int rangeOfVals = *discreteLevels.crbegin() - *discreteLevels.cbegin();
-                    int numUniqueVals = 0, prevVal = -1;
-                    for(const auto v : discreteLevels) {
-                        if(v != prevVal) {
-                            numUniqueVals++;
-                        }
-                        prevVal = v;
-                    }
-                    const float rangePart = cachedRangeAttributeLevels > 0 ?
-                                                static_cast<float>(rangeOfVals) / cachedRangeAttributeLevels : 0.0f;
-                    const float uniquePart = cachedNumAttributeLevels > 1 ?
-                                                static_cast<float>(numUniqueVals - 1) / (cachedNumAttributeLevels - 1) : 0.0f;
-                    criteriaScores[team] = 0.75f * rangePart + 0.25f * uniquePart;
-                }
-                else {
-                    // categorical / multicategorical: maximise unique values
-                    int numUniqueVals = 0, prevVal = -1;
-                    for(const auto v : discreteLevels) {
-                        if(v != prevVal) {
-                            numUniqueVals++;
-                        }
-                        prevVal = v;
-                    }
-                    criteriaScores[team] = cachedNumAttributeLevels > 1
-                                               ? static_cast<float>(numUniqueVals - 1) / (cachedNumAttributeLevels - 1)
-                                               : 0.0f;
-                }
-
-                // Calculation above assumes diverse = +1, similar = 0; flip if needed
-                if(diversity == Criterion::AttributeDiversity::similar) {
-                    criteriaScores[team] = 1.0f - criteriaScores[team];
-                }
+            criteriaScores[team] = 0.0f;
+        }
+    }
+    else {
+        // Discrete types: ordered/multiordered, categorical/multicategorical
+        if((weight > 0) && (numUniqueVals > 0)) {
+            if((type == DataOptions::AttributeType::ordered) ||
+                (type == DataOptions::AttributeType::multiordered)) {
+                // Score weighted toward range, with a lesser contribution from unique-value count
+                const int rangeOfVals = highestVal - lowestVal;
+                const float rangePart = cachedRangeAttributeLevels > 0 ?
+                                            static_cast<float>(rangeOfVals) / cachedRangeAttributeLevels : 0.0f;
+                const float uniquePart = cachedNumAttributeLevels > 1 ?
+                                            static_cast<float>(numUniqueVals - 1) / (cachedNumAttributeLevels - 1) : 0.0f;
+                criteriaScores[team] = 0.75f * rangePart + 0.25f * uniquePart;
             }
             else {
-                criteriaScores[team] = 0.0f;
+                // categorical / multicategorical: maximise unique values
+                criteriaScores[team] = cachedNumAttributeLevels > 1
+                                           ? static_cast<float>(numUniqueVals - 1) / (cachedNumAttributeLevels - 1)
+                                           : 0.0f;
             }
-        }
 
-        criteriaScores[team] *= weight;
-        penaltyPoints[team] *= weight;
+            // Calculation above assumes diverse = +1, similar = 0; flip if needed
+            if(diversity == Criterion::AttributeDiversity::similar) {
+                criteriaScores[team] = 1.0f - criteriaScores[team];
+            }
+        }
+        else {
+            criteriaScores[team] = 0.0f;
+        }
     }
+
+    criteriaScores[team] *= weight;
+    penaltyPoints[team] *= weight;
 }
 
 QString AttributeCriterion::headerLabel(const DataOptions *dataOptions) const {
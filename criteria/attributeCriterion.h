@@ -3,6 +3,7 @@
 
 #include "criterion.h"
 #include "widgets/attributeWidget.h"
+#include <vector>
 
 class AttributeCriterion : public Criterion {
     Q_OBJECT
@@ -18,9 +19,13 @@ public:
 
     void generateCriteriaCard(TeamingOptions *const teamingOptions) override;
     void prepareForOptimization(const StudentRecord *students, int numStudents, const DataOptions *dataOptions) override;
-    void calculateScore(const StudentRecord *const students, const int teammates[], const int numTeams, const int teamSizes[],
+    std::unique_ptr<Workspace> createWorkspace(const StudentSnapshot &students, const int numTeams, const int teamSizes[]) const override;
+    void calculateScore(const StudentSnapshot &students, const int teammates[], const int numTeams, const int teamSizes[],
                         const TeamingOptions *const teamingOptions, const DataOptions *const dataOptions,
-                        QList<float> &criteriaScores, QList<float> &penaltyPoints) const override;
+                        QList<float> &criteriaScores, QList<float> &penaltyPoints, Workspace *const workspace) const override;
+    void calculateTeamScore(const StudentSnapshot &students, const int teammates[], const int teamSize, const int team,
+                            const TeamingOptions *const teamingOptions, const DataOptions *const dataOptions,
+                            QList<float> &criteriaScores, QList<float> &penaltyPoints, Workspace *const workspace) const override;
 
     QString headerLabel(const DataOptions *dataOptions) const override;
     Qt::TextElideMode headerElideMode() const override;
@@ -44,6 +49,20 @@ public:
     float targetMax = 100.0;
 
 private:
+    class AttributeWorkspace : public Workspace {
+    public:
+        std::vector<int> valueCounts;           // for each discrete value, from lowestValue up, how many times it's on the team (all 0 between teams)
+        int lowestValue = 0;
+        std::vector<float> continuousLevels;    // one team's values
+        std::vector<float> gaps;
+    };
+
+    // the score of one team, shared by calculateScore and calculateTeamScore (FixedTeamSize is 0 unless the team size is known at compile time)
+    template<int FixedTeamSize>
+    void scoreTeam(const StudentSnapshot &students, const int teamStudents[], const int runtimeTeamSize, const int team,
+                   const DataOptions *const dataOptions, QList<float> &criteriaScores, QList<float> &penaltyPoints,
+                   AttributeWorkspace *const attributeWorkspace) const;
+
     static QString valToLetter(int val);
     int cachedNumAttributeLevels = 0;
     float cachedRangeAttributeLevels = 0.0f;
@@ -1,4 +1,7 @@
 #include "criterion.h"
+#include <algorithm>
+#include <bit>
+#include <numeric>
 
 QJsonObject Criterion::settingsToJson() const {
     QJsonObject json;
@@ -25,21 +28,35 @@ int Criterion::resolveCriteriaTypeKey(const QMetaEnum &e, const QString &name) {
     return e.keyToValue(qPrintable(name));
 }
 
+void Criterion::calculateTeamScore(const StudentSnapshot &students, const int teammates[], const int teamSize, const int team,
+                                   const TeamingOptions *const teamingOptions, const DataOptions *const dataOptions,
+                                   QList<float> &criteriaScores, QList<float> &penaltyPoints, Workspace *const workspace) const
+{
+    QList<float> teamScore(1, criteriaScores[team]);
+    QList<float> teamPenalty(1, penaltyPoints[team]);
+    calculateScore(students, teammates, 1, &teamSize, teamingOptions, dataOptions, teamScore, teamPenalty, workspace);
+    criteriaScores[team] = teamScore[0];
+    penaltyPoints[team] = teamPenalty[0];
+}
+
 float Criterion::scoreForOneTeamInDisplay(const QList<StudentRecord> &allStudents, const TeamRecord &team, const TeamingOptions *teamingOptions,
                                           const DataOptions *dataOptions, const QSet<long long> &/*allIDsBeingTeamed*/)
 {
-    // Build a mini-genome: find each team member's index in allStudents
-    QList<int> indices;
-    indices.reserve(team.size);
+    // Build a snapshot of just this team's students, and a mini-genome that places all of them on the team
+    QList<StudentRecord> teamMembers;
+    teamMembers.reserve(team.size);
     for (const auto studentID : team.studentIDs) {
-        int i = 0;
-        while (i < allStudents.size() && allStudents[i].ID != studentID) {
-            i++;
-        }
-        if (i < allStudents.size()) {
-            indices.push_back(i);
+        for (const auto &student : allStudents) {
+            if (student.ID == studentID) {
+                teamMembers << student;
+                break;
+            }
         }
     }
+    const StudentSnapshot snapshot(teamMembers.constData(), int(teamMembers.size()), dataOptions);
+    QList<int> indices(teamMembers.size());
+    std::iota(indices.begin(), indices.end(), 0);
+    const int teamSize = int(teamMembers.size());
 
     QList<float> score(1, 0.0f);
     QList<float> penalty(1, 0.0f);
@@ -49,7 +66,8 @@ float Criterion::scoreForOneTeamInDisplay(const QList<StudentRecord> &allStudent
     const float savedWeight = weight;
     weight = 1.0f;
 
-    calculateScore(allStudents.constData(), indices.data(), 1, &team.size, teamingOptions, dataOptions, score, penalty);
+    const std::unique_ptr<Workspace> workspace = createWorkspace(snapshot, 1, &teamSize);
+    calculateScore(snapshot, indices.constData(), 1, &teamSize, teamingOptions, dataOptions, score, penalty, workspace.get());
 
     weight = savedWeight;
 
@@ -78,3 +96,63 @@ QColor Criterion::teamDisplayColor(float criterionScore) const
 
     return {r, g, 80, 60};
 }
+
+QList<Criterion::IdentityRuleCheck> Criterion::compileIdentityRules(const QMap<QString, IdentityRule> &identityRules, QStringList &identityNames)
+{
+    QList<IdentityRuleCheck> ruleChecks;
+    for (const auto [ruleKey, valMap] : identityRules.asKeyValueRange()) {
+        IdentityRuleCheck ruleCheck;
+        const QStringList identityNamesInRule = ruleKey.split('|');
+        for (const QString &identity : identityNamesInRule) {
+            int index = int(identityNames.indexOf(identity));
+            if (index == -1) {
+                index = int(identityNames.size());
+                identityNames << identity;
+            }
+            if (index < IDENTITY_MASK_BITS) {
+                ruleCheck.identities |= (uint64_t(1) << index);
+            } else if (!ruleCheck.moreIdentities.contains(index)) {
+                ruleCheck.moreIdentities << index;
+            }
+        }
+
+        // every count above the largest value in the rule breaks the same operations as the count just above it
+        int largestValue = 0;
+        for (const auto &values : valMap) {
+            for (const int val : values) {
+                largestValue = std::max(largestValue, val);
+            }
+        }
+        ruleCheck.numViolationsAtCount.fill(0, largestValue + 2);
+        for (int count = 0; count < ruleCheck.numViolationsAtCount.size(); count++) {
+            for (const auto [operation, values] : valMap.asKeyValueRange()) {
+                for (const int val : values) {
+                    if ((operation == "!=" && count == val) ||
+                        (operation == "<"  && count >= val) ||
+                        (operation == ">"  && count <= val)) {
+                        ruleCheck.numViolationsAtCount[count]++;
+                        break;
+                    }
+                }
+            }
+        }
+        ruleChecks << ruleCheck;
+    }
+    return ruleChecks;
+}
+
+int Criterion::numIdentityRulesViolated(const QList<IdentityRuleCheck> &ruleChecks, const int identityCounts[])
+{
+    int numViolated = 0;
+    for (const auto &rule : ruleChecks) {
+        int count = 0;
+        for (uint64_t identities = rule.identities; identities != 0; identities &= (identities - 1)) {
+            count += identityCounts[std::countr_zero(identities)];
+        }
+        for (const int identity : rule.moreIdentities) {
+            count += identityCounts[identity];
+        }
+        numViolated += rule.numViolationsAtCount[std::min(count, int(rule.numViolationsAtCount.size()) - 1)];
+    }
+    return numViolated;
+}
@@ -3,9 +3,14 @@
 
 #include "dataOptions.h"
 #include "studentRecord.h"
+#include "studentSnapshot.h"
 #include "teamRecord.h"
 #include <QMetaEnum>
 #include <QObject>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
 
 class GroupingCriteriaCard;
 class TeamingOptions;
@@ -41,10 +46,40 @@ public:
     // called once before optimization begins to cache any values derived from the student data
     virtual void prepareForOptimization(const StudentRecord */*students*/, int /*numStudents*/, const DataOptions */*dataOptions*/) {}
 
+    // scratch memory (and lookups precomputed from the settings and students) used by calculateScore
+    // created once per scoring thread, sized using the values cached in prepareForOptimization, then reused for every genome so that scoring never allocates
+    // students.records can be used here for anything not in the snapshot
+    class Workspace {
+    public:
+        virtual ~Workspace() = default;
+        std::byte *genomeMemory = nullptr;      // the genome memory (see below) of the genome being scored, or nullptr if there is none
+    };
+    virtual std::unique_ptr<Workspace> createWorkspace(const StudentSnapshot &/*students*/, const int /*numTeams*/, const int /*teamSizes*/[]) const { return nullptr; }
+
+    // number of bytes of memory that the optimizer should keep with each genome for this criterion (zero-filled in the first generation),
+    // copied from one of its parents to each child, e.g., so that a child can be scored by adjusting what was found for its parent;
+    // only kept for criteria that don't score teams independently, since only they are always given the whole genome
+    virtual int genomeMemorySize(const int /*numTeams*/) const { return 0; }
+
     // calculate the score for the criterion for all the teams in a genome, used in the optimization algorithm
-    virtual void calculateScore(const StudentRecord *const students, const int teammates[], const int numTeams, const int teamSizes[],
+    // teammates[] are indexes into the students snapshot; workspace is the one this criterion created for the calling thread
+    virtual void calculateScore(const StudentSnapshot &students, const int teammates[], const int numTeams, const int teamSizes[],
                                 const TeamingOptions *const teamingOptions, const DataOptions *const dataOptions,
-                                QList<float> &criteriaScores, QList<float> &penaltyPoints) const = 0;
+                                QList<float> &criteriaScores, QList<float> &penaltyPoints, Workspace *const workspace) const = 0;
+
+    // whether each team's score depends only on that team's students, so that calculateScore can be given just a subset of a genome's teams
+    // (e.g., only those changed since the genome was last scored); false if teams are scored relative to each other
+    virtual bool scoresTeamsIndependently() const { return true; }
+
+    // if false, the per-team kernels always use the team size given at runtime, rather than their versions for fixed team sizes (e.g., for benchmarking)
+    inline static bool useFixedTeamSizeKernels = true;
+
+    // calculate the score for the criterion for just one team, whose students are teammates[] and whose scores go in criteriaScores[team] and penaltyPoints[team];
+    // used by the optimizer to score each team on all of the criteria in turn while that team's student data is in cache, so only called if scoresTeamsIndependently.
+    // The default goes through calculateScore (allocating as it does); instead, a criterion should have calculateScore and this share one per-team kernel
+    virtual void calculateTeamScore(const StudentSnapshot &students, const int teammates[], const int teamSize, const int team,
+                                    const TeamingOptions *const teamingOptions, const DataOptions *const dataOptions,
+                                    QList<float> &criteriaScores, QList<float> &penaltyPoints, Workspace *const workspace) const;
 
     // a convenience wrapper around calculateScore to calculate for one team, used to color the TeamTree display
     virtual float scoreForOneTeamInDisplay(const QList<StudentRecord> &allStudents, const TeamRecord &team, const TeamingOptions *teamingOptions,
@@ -77,6 +112,50 @@ public:
 
 protected:
     GroupingCriteriaCard *parentCard;
+
+    // for building calculateScore from a per-team kernel: calls scoreTeam(teamStudents, teamSize, team, fixedTeamSize) for each team of the genome,
+    // with fixedTeamSize as given by withFixedTeamSize
+    template<typename TeamKernel>
+    static void forEachTeam(const int teammates[], const int numTeams, const int teamSizes[], const TeamKernel &scoreTeam)
+    {
+        int studentNum = 0;
+        for(int team = 0; team < numTeams; team++) {
+            const int *const teamStudents = teammates + studentNum;
+            const int teamSize = teamSizes[team];
+            withFixedTeamSize(teamSize, [&](const auto fixedTeamSize) {scoreTeam(teamStudents, teamSize, team, fixedTeamSize);});
+            studentNum += teamSize;
+        }
+    }
+
+    // for a per-team kernel templated on the team size: calls scoreTeam(fixedTeamSize), with fixedTeamSize a std::integral_constant<int, teamSize>
+    // if teamSize is 2 to 8 (so the kernel's loops through the teammates can be unrolled for the usual team sizes),
+    // otherwise a std::integral_constant<int, 0> (meaning the kernel has to use teamSize)
+    template<typename TeamKernel>
+    static void withFixedTeamSize(const int teamSize, const TeamKernel &scoreTeam)
+    {
+        switch(useFixedTeamSizeKernels? teamSize : 0) {
+        case 2: scoreTeam(std::integral_constant<int, 2>()); break;
+        case 3: scoreTeam(std::integral_constant<int, 3>()); break;
+        case 4: scoreTeam(std::integral_constant<int, 4>()); break;
+        case 5: scoreTeam(std::integral_constant<int, 5>()); break;
+        case 6: scoreTeam(std::integral_constant<int, 6>()); break;
+        case 7: scoreTeam(std::integral_constant<int, 7>()); break;
+        case 8: scoreTeam(std::integral_constant<int, 8>()); break;
+        default: scoreTeam(std::integral_constant<int, 0>()); break;
+        }
+    }
+
+    // an identity rule compiled for scoring without any string handling: its identities as a bitmask of indexes into a team's identity counts,
+    // and all of its operations (e.g., "!=" 1 and "<" 3) folded into a table of how many of them are broken by each count of students with those identities
+    struct IdentityRuleCheck {
+        uint64_t identities = 0;                // those with the first IDENTITY_MASK_BITS indexes...
+        QList<int> moreIdentities;              // ...and the indexes of any others (only if more identities are named across all the rules)
+        QList<uint8_t> numViolationsAtCount;    // the last entry is for that count and every count above it
+    };
+    inline static const int IDENTITY_MASK_BITS = 64;
+    // identityNames comes in holding any identities that need fixed indexes, and comes out with every other identity named in the rules appended
+    static QList<IdentityRuleCheck> compileIdentityRules(const QMap<QString, IdentityRule> &identityRules, QStringList &identityNames);
+    static int numIdentityRulesViolated(const QList<IdentityRuleCheck> &ruleChecks, const int identityCounts[]);
 };
 
 
@@ -96,7 +175,8 @@ protected:
     studentDisplayText — what to show in the student row
     exportTeamingOptionText — text for the instructor export header
     exportStudentText — per-student text for the instructor export
-    Optionally override: teamTextAlignment, studentTextAlignment, teamDisplayColor, scoreForOneTeamInDisplay, settingsToJson, settingsFromJson
+    Optionally override: createWorkspace (if calculateScore needs scratch memory), teamTextAlignment, studentTextAlignment, teamDisplayColor,
+                         scoreForOneTeamInDisplay, settingsToJson, settingsFromJson
 
 3. gruepr.cpp — add menu action in the constructor, add case in addCriteriaCard, add case in deleteCriteriaCard
 4. teamsTabItem.cpp — add #include for the new subclass, add case in restoreCriteria's switch
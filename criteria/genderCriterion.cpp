@@ -4,6 +4,7 @@
 #include "dialogs/identityRulesDialog.h"
 #include "widgets/groupingCriteriaCardWidget.h"
 #include <QJsonArray>
+#include <algorithm>
 
 Criterion* GenderCriterion::clone() const {
     auto *copy = new GenderCriterion(dataOptions, criteriaType, weight, penaltyStatus);
@@ -170,68 +171,73 @@ void GenderCriterion::generateCriteriaCard(TeamingOptions *const /*teamingOption
     });
 }
 
-void GenderCriterion::calculateScore(const StudentRecord *const students, const int teammates[], const int numTeams, const int teamSizes[],
+std::unique_ptr<Criterion::Workspace> GenderCriterion::createWorkspace(const StudentSnapshot &/*students*/, const int /*numTeams*/, const int /*teamSizes*/[]) const
+{
+    auto workspace = std::make_unique<GenderWorkspace>();
+    QStringList identityNames = {womanKey, manKey, nonbinaryKey};
+    workspace->ruleChecks = compileIdentityRules(identityRules, identityNames);
+    workspace->identityCounts.fill(0, identityNames.size());
+    return workspace;
+}
+
+void GenderCriterion::calculateScore(const StudentSnapshot &students, const int teammates[], const int numTeams, const int teamSizes[],
                                      const TeamingOptions *const /*teamingOptions*/, const DataOptions *const /*dataOptions*/,
-                                     QList<float> &criteriaScores, QList<float> &penaltyPoints) const
+                                     QList<float> &criteriaScores, QList<float> &penaltyPoints, Workspace *const workspace) const
 {
-    int studentNum = 0;
-    for(int team = 0; team < numTeams; team++) {
-        criteriaScores[team] = 1;
-        bool penaltyApplied = false;
-
-        if(teamSizes[team] == 1) {
-            studentNum++;
-            continue;
-        }
+    auto *const genderWorkspace = static_cast<GenderWorkspace*>(workspace);
+    forEachTeam(teammates, numTeams, teamSizes, [&](const int teamStudents[], const int teamSize, const int team, const auto fixedTeamSize)
+                {scoreTeam<decltype(fixedTeamSize)::value>(students, teamStudents, teamSize, team, criteriaScores, penaltyPoints, genderWorkspace);});
+}
 
-        // Count how many of each gender on the team
-        QMap<QString, int> genderCounts;
-        for (int teammate = 0; teammate < teamSizes[team]; teammate++) {
-            const auto &student = students[teammates[studentNum]];
-            if (student.gender.contains(Gender::woman)) {
-                genderCounts[womanKey]++;
-            }
-            if (student.gender.contains(Gender::man)) {
-                genderCounts[manKey]++;
-            }
-            if (student.gender.contains(Gender::nonbinary)) {
-                genderCounts[nonbinaryKey]++;
-            }
-            studentNum++;
-        }
+void GenderCriterion::calculateTeamScore(const StudentSnapshot &students, const int teammates[], const int teamSize, const int team,
+                                         const TeamingOptions *const /*teamingOptions*/, const DataOptions *const /*dataOptions*/,
+                                         QList<float> &criteriaScores, QList<float> &penaltyPoints, Workspace *const workspace) const
+{
+    auto *const genderWorkspace = static_cast<GenderWorkspace*>(workspace);
+    withFixedTeamSize(teamSize, [&](const auto fixedTeamSize)
+                      {scoreTeam<decltype(fixedTeamSize)::value>(students, teammates, teamSize, team, criteriaScores, penaltyPoints, genderWorkspace);});
+}
 
-        auto applyRule = [&](const QString &ruleKey) {
-            const QStringList identities = ruleKey.split('|');
-            int count = 0;
-            for (const QString &identity : identities) {
-                count += genderCounts.value(identity, 0);
-            }
-            const auto &valMap = identityRules.value(ruleKey);
-            for (const auto [operation, values] : valMap.asKeyValueRange()) {
-                for (const int val : values) {
-                    if ((operation == "!=" && count == val) ||
-                        (operation == "<"  && count >= val) ||
-                        (operation == ">"  && count <= val)) {
-                        penaltyApplied = true;
-                        if (penaltyStatus) {
-                            penaltyPoints[team] += 1.0f;
-                        }
-                        break;
-                    }
-                }
-            }
-        };
+template<int FixedTeamSize>
+void GenderCriterion::scoreTeam(const StudentSnapshot &students, const int teamStudents[], const int runtimeTeamSize, const int team,
+                                QList<float> &criteriaScores, QList<float> &penaltyPoints, GenderWorkspace *const genderWorkspace) const
+{
+    const int teamSize = (FixedTeamSize > 0)? FixedTeamSize : runtimeTeamSize;
 
-        for (const auto &ruleKey : identityRules.keys()) {
-            applyRule(ruleKey);
-        }
+    criteriaScores[team] = 1;
+
+    if(teamSize == 1) {
+        return;
+    }
 
-        if (penaltyApplied) {
-            criteriaScores[team] = 0;
+    // Count how many of each gender on the team
+    int *const genderCounts = genderWorkspace->identityCounts.data();
+    genderCounts[0] = 0;
+    genderCounts[1] = 0;
+    genderCounts[2] = 0;
+    for (int teammate = 0; teammate < teamSize; teammate++) {
+        const uint8_t genders = students.genderMask[teamStudents[teammate]];
+        if ((genders & StudentSnapshot::genderBit(Gender::woman)) != 0) {
+            genderCounts[0]++;
         }
-        criteriaScores[team] *= weight;
-        penaltyPoints[team] *= weight;
+        if ((genders & StudentSnapshot::genderBit(Gender::man)) != 0) {
+            genderCounts[1]++;
+        }
+        if ((genders & StudentSnapshot::genderBit(Gender::nonbinary)) != 0) {
+            genderCounts[2]++;
+        }
+    }
+
+    const int numViolations = numIdentityRulesViolated(genderWorkspace->ruleChecks, genderCounts);
+    if (penaltyStatus) {
+        penaltyPoints[team] += float(numViolations);
+    }
+
+    if (numViolations > 0) {
+        criteriaScores[team] = 0;
     }
+    criteriaScores[team] *= weight;
+    penaltyPoints[team] *= weight;
 }
 
 QStringList GenderCriterion::identityOptions() const {
@@ -19,9 +19,13 @@ public:
     void settingsFromJson(const QJsonObject &json) override;
 
     void generateCriteriaCard(TeamingOptions *const teamingOptions) override;
-    void calculateScore(const StudentRecord *const students, const int teammates[], const int numTeams, const int teamSizes[],
+    std::unique_ptr<Workspace> createWorkspace(const StudentSnapshot &students, const int numTeams, const int teamSizes[]) const override;
+    void calculateScore(const StudentSnapshot &students, const int teammates[], const int numTeams, const int teamSizes[],
                         const TeamingOptions *const teamingOptions, const DataOptions *const dataOptions,
-                        QList<float> &criteriaScores, QList<float> &penaltyPoints) const override;
+                        QList<float> &criteriaScores, QList<float> &penaltyPoints, Workspace *const workspace) const override;
+    void calculateTeamScore(const StudentSnapshot &students, const int teammates[], const int teamSize, const int team,
+                            const TeamingOptions *const teamingOptions, const DataOptions *const dataOptions,
+                            QList<float> &criteriaScores, QList<float> &penaltyPoints, Workspace *const workspace) const override;
 
     QStringList identityOptions() const;
     void updateComplicatedRuleCountLabel() const;
@@ -47,6 +51,18 @@ public:
     const QString womanKey = grueprGlobal::genderToString(Gender::woman);
     const QString manKey = grueprGlobal::genderToString(Gender::man);
     const QString nonbinaryKey = grueprGlobal::genderToString(Gender::nonbinary);
+
+private:
+    class GenderWorkspace : public Workspace {
+    public:
+        QList<IdentityRuleCheck> ruleChecks;
+        QList<int> identityCounts;          // index 0 = woman, 1 = man, 2 = nonbinary, then any other identity named in a rule (always 0)
+    };
+
+    // the score of one team, shared by calculateScore and calculateTeamScore (FixedTeamSize is 0 unless the team size is known at compile time)
+    template<int FixedTeamSize>
+    void scoreTeam(const StudentSnapshot &students, const int teamStudents[], const int runtimeTeamSize, const int team,
+                   QList<float> &criteriaScores, QList<float> &penaltyPoints, GenderWorkspace *const genderWorkspace) const;
 };
 
 #endif // GENDERCRITERION_H
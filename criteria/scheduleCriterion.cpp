@@ -4,6 +4,28 @@
 #include "widgets/groupingCriteriaCardWidget.h"
 #include <QHBoxLayout>
 #include <QVBoxLayout>
+#include <algorithm>
+#include <bit>
+
+namespace {
+    // bits[i] &= bits[i + shift], treating the words as one long bitset (with bit 0 of word 0 first) that has 0s past its end
+    void andWithShiftedSelf(uint64_t *const bits, const int numWords, const int shift)
+    {
+        const int wordShift = shift / 64;
+        const int bitShift = shift % 64;
+        for(int word = 0; word < numWords; word++) {
+            uint64_t shifted = 0;
+            const int source = word + wordShift;
+            if(source < numWords) {
+                shifted = bits[source] >> bitShift;
+                if((bitShift != 0) && (source + 1 < numWords)) {
+                    shifted |= bits[source + 1] << (64 - bitShift);
+                }
+            }
+            bits[word] &= shifted;
+        }
+    }
+}
 
 Criterion* ScheduleCriterion::clone() const
 {
@@ -124,110 +146,160 @@ void ScheduleCriterion::prepareForOptimization(const StudentRecord *, int, const
     numBlocksForOneMeeting = static_cast<int>(std::ceil(meetingBlockSize / dataOptions->scheduleResolution));
 }
 
-void ScheduleCriterion::calculateScore(const StudentRecord *const students, const int teammates[], const int numTeams, const int teamSizes[],
-                                       const TeamingOptions *const /*teamingOptions*/, const DataOptions *const dataOptions,
-                                       QList<float> &criteriaScores, QList<float> &penaltyPoints) const
+std::unique_ptr<Criterion::Workspace> ScheduleCriterion::createWorkspace(const StudentSnapshot &students, const int /*numTeams*/, const int /*teamSizes*/[]) const
+{
+    auto workspace = std::make_unique<ScheduleWorkspace>();
+    workspace->teamAvailability.resize(qsizetype(students.numScheduleDays) * students.scheduleWordsPerDay);
+    workspace->allAvailable.fill(~uint64_t(0), workspace->teamAvailability.size());
+    workspace->meetingStarts.resize(students.scheduleWordsPerDay);
+    return workspace;
+}
+
+void ScheduleCriterion::calculateScore(const StudentSnapshot &students, const int teammates[], const int numTeams, const int teamSizes[],
+                                       const TeamingOptions *const /*teamingOptions*/, const DataOptions *const /*dataOptions*/,
+                                       QList<float> &criteriaScores, QList<float> &penaltyPoints, Workspace *const workspace) const
+{
+    auto *const scheduleWorkspace = static_cast<ScheduleWorkspace*>(workspace);
+    forEachTeam(teammates, numTeams, teamSizes, [&](const int teamStudents[], const int teamSize, const int team, const auto fixedTeamSize)
+                {scoreTeam<decltype(fixedTeamSize)::value>(students, teamStudents, teamSize, team, criteriaScores, penaltyPoints, scheduleWorkspace);});
+}
+
+void ScheduleCriterion::calculateTeamScore(const StudentSnapshot &students, const int teammates[], const int teamSize, const int team,
+                                           const TeamingOptions *const /*teamingOptions*/, const DataOptions *const /*dataOptions*/,
+                                           QList<float> &criteriaScores, QList<float> &penaltyPoints, Workspace *const workspace) const
 {
-    const int numDays = int(dataOptions->dayNames.size());
-    const int numTimes = int(dataOptions->timeNames.size());
-
-    // Allocated once per thread; subsequent calls just reuse the memory.
-    // Using vector<uint8_t> rather than vector<bool> to avoid bit-packing overhead.
-    thread_local QList<uint8_t> availabilityChart;
-    const int chartSize = numDays * numTimes;
-    if (int(availabilityChart.size()) < chartSize) {
-        availabilityChart.resize(chartSize);
+    auto *const scheduleWorkspace = static_cast<ScheduleWorkspace*>(workspace);
+    withFixedTeamSize(teamSize, [&](const auto fixedTeamSize)
+                      {scoreTeam<decltype(fixedTeamSize)::value>(students, teammates, teamSize, team, criteriaScores, penaltyPoints, scheduleWorkspace);});
+}
+
+template<int FixedTeamSize>
+void ScheduleCriterion::scoreTeam(const StudentSnapshot &students, const int teamStudents[], const int runtimeTeamSize, const int team,
+                                  QList<float> &criteriaScores, QList<float> &penaltyPoints, ScheduleWorkspace *const scheduleWorkspace) const
+{
+    const int teamSize = (FixedTeamSize > 0)? FixedTeamSize : runtimeTeamSize;
+
+    if(teamSize == 1) {
+        return;
     }
 
-    // combine each student's schedule array into a team schedule array
-    int studentNum = 0;
-    for(int team = 0; team < numTeams; team++) {
-        if(teamSizes[team] == 1) {
-            studentNum++;
-            continue;
-        }
+    const int numDays = students.numScheduleDays;
+    const int numTimes = students.numScheduleTimes;
+    const int wordsPerDay = students.scheduleWordsPerDay;
+    const int numWords = numDays * wordsPerDay;
+    uint64_t *const availabilityChart = scheduleWorkspace->teamAvailability.data();
+    uint64_t *const meetingStarts = scheduleWorkspace->meetingStarts.data();
 
-        // start compiling a team availability chart; begin with that of the first student on team (unless they have ambiguous schedule)
-        int numStudentsWithAmbiguousSchedules = 0;
-        const auto &firstStudentOnTeam = students[teammates[studentNum]];
-        if(!firstStudentOnTeam.ambiguousSchedule && firstStudentOnTeam.unavailable.size() >= chartSize) {
-            const auto &firstStudentUnavailability = firstStudentOnTeam.unavailable;
-            for(int day = 0; day < numDays; day++) {
-                for(int time = 0; time < numTimes; time++) {
-                    availabilityChart[day * numTimes + time] = !firstStudentUnavailability[day * numTimes + time];
-                }
+    // combine each student's schedule bitset into a team schedule bitset:
+    // start with all timeslots available, then, unless they have ambiguous schedule, merge each student's availability into the team's
+    int numStudentsWithAmbiguousSchedules = 0;
+    if constexpr(FixedTeamSize > 0) {
+        // (with the number of teammates known, each word of the team's bitset is found at once from all of theirs, with a student
+        // with an ambiguous schedule given a bitset with every timeslot available)
+        const uint64_t *studentAvailabilities[FixedTeamSize];
+        for(int teammate = 0; teammate < FixedTeamSize; teammate++) {
+            const int student = teamStudents[teammate];
+            if(students.hasSchedule[student] == 0) {
+                numStudentsWithAmbiguousSchedules++;
+                studentAvailabilities[teammate] = scheduleWorkspace->allAvailable.constData();
+            }
+            else {
+                studentAvailabilities[teammate] = students.availability(student);
             }
         }
-        else {
-            // ambiguous schedule, so note it and start with all timeslots available
-            numStudentsWithAmbiguousSchedules++;
-            for(int day = 0; day < numDays; day++) {
-                for(int time = 0; time < numTimes; time++) {
-                    availabilityChart[day * numTimes + time] = true;
-                }
+        for(int word = 0; word < numWords; word++) {
+            uint64_t teamAvailability = studentAvailabilities[0][word];
+            for(int teammate = 1; teammate < FixedTeamSize; teammate++) {
+                teamAvailability &= studentAvailabilities[teammate][word];
             }
+            availabilityChart[word] = teamAvailability;
         }
-        studentNum++;
-
-        // now move on to each subsequent student and, unless they have ambiguous schedule, merge their availability into the team's
-        for(int teammate = 1; teammate < teamSizes[team]; teammate++) {
-            const auto &currStudent = students[teammates[studentNum]];
-            if(currStudent.ambiguousSchedule || currStudent.unavailable.size() < chartSize) {
+    }
+    else {
+        std::fill(availabilityChart, availabilityChart + numWords, ~uint64_t(0));
+        for(int teammate = 0; teammate < teamSize; teammate++) {
+            const int student = teamStudents[teammate];
+            if(students.hasSchedule[student] == 0) {
                 numStudentsWithAmbiguousSchedules++;
-                studentNum++;
                 continue;
             }
-            const auto &currStudentUnavailability = currStudent.unavailable;
-            for(int day = 0; day < numDays; day++) {
-                for(int time = 0; time < numTimes; time++) {
-                    availabilityChart[day * numTimes + time] = availabilityChart[day * numTimes + time] && !currStudentUnavailability[day * numTimes + time];
-                }
+            const uint64_t *const studentAvailability = students.availability(student);
+            for(int word = 0; word < numWords; word++) {
+                availabilityChart[word] &= studentAvailability[word];
             }
-            studentNum++;
         }
+    }
 
-        // keep schedule score at 0 unless 2+ students have unambiguous sched (avoid runaway score by grouping students w/ambiguous scheds)
-        if((teamSizes[team] - numStudentsWithAmbiguousSchedules) < 2) {
-            criteriaScores[team] = 0;
-            continue;
-        }
+    // keep schedule score at 0 unless 2+ students have unambiguous sched (avoid runaway score by grouping students w/ambiguous scheds)
+    if((teamSize - numStudentsWithAmbiguousSchedules) < 2) {
+        criteriaScores[team] = 0;
+        return;
+    }
 
-        //count when there's the correct number of consecutive time blocks, but don't count wrap-around past end of 1 day!
+    //count when there's the correct number of consecutive time blocks, but don't count wrap-around past end of 1 day!
+    if(numBlocksForOneMeeting > 0) {
         for(int day = 0; day < numDays; day++) {
-            for(int time = 0; time < numTimes; time++) {
-                int block = 0;
-                while(availabilityChart[day * numTimes + time] && (block < numBlocksForOneMeeting) && (time < numTimes)) {
-                    block++;
-                    if(block < numBlocksForOneMeeting) {
-                        time++;
-                    }
-                }
-
-                if((block == numBlocksForOneMeeting) && (block > 0)){
-                    criteriaScores[team]++;
-                }
-            }
+            criteriaScores[team] += float(numMeetingTimes(availabilityChart + (day * wordsPerDay), numTimes, wordsPerDay, meetingStarts));
         }
+    }
 
-        // convert counts to a schedule score
-        // normal schedule score is number of overlaps / desired number of overlaps
-        if(criteriaScores[team] > desiredTimeBlocksOverlap) {     // if team has > desiredTimeBlocksOverlap, each added overlap counts less
-            const int numAdditionalOverlaps = int(criteriaScores[team]) - desiredTimeBlocksOverlap;
-            criteriaScores[team] = desiredTimeBlocksOverlap;
-            float factor = 1.0f / (HIGHSCHEDULEOVERLAPSCALE);
-            for(int n = 1 ; n <= numAdditionalOverlaps; n++) {
-                criteriaScores[team] += factor;
-                factor *= 1.0f / (HIGHSCHEDULEOVERLAPSCALE);
-            }
+    // convert counts to a schedule score
+    // normal schedule score is number of overlaps / desired number of overlaps
+    if(criteriaScores[team] > desiredTimeBlocksOverlap) {     // if team has > desiredTimeBlocksOverlap, each added overlap counts less
+        const int numAdditionalOverlaps = int(criteriaScores[team]) - desiredTimeBlocksOverlap;
+        criteriaScores[team] = desiredTimeBlocksOverlap;
+        float factor = 1.0f / (HIGHSCHEDULEOVERLAPSCALE);
+        for(int n = 1 ; n <= numAdditionalOverlaps; n++) {
+            criteriaScores[team] += factor;
+            factor *= 1.0f / (HIGHSCHEDULEOVERLAPSCALE);
         }
-        else if(criteriaScores[team] < minTimeBlocksOverlap) {    // if team has fewer than minTimeBlocksOverlap, apply penalty
-            penaltyPoints[team] += 1.0f;
+    }
+    else if(criteriaScores[team] < minTimeBlocksOverlap) {    // if team has fewer than minTimeBlocksOverlap, apply penalty
+        penaltyPoints[team] += 1.0f;
+    }
+
+    criteriaScores[team] /= desiredTimeBlocksOverlap;
+    criteriaScores[team] *= weight;
+    penaltyPoints[team] *= weight;
+}
+
+int ScheduleCriterion::numMeetingTimes(const uint64_t dayAvailability[], const int numTimes, const int numWords, uint64_t meetingStarts[]) const
+{
+    // mark each time block that starts numBlocksForOneMeeting consecutive available blocks,
+    // ANDing in shifted copies of the availability while doubling the length covered
+    std::copy(dayAvailability, dayAvailability + numWords, meetingStarts);
+    if((numTimes % 64) != 0) {
+        meetingStarts[numWords - 1] &= (uint64_t(1) << (numTimes % 64)) - 1;
+    }
+    int blocksCovered = 1;
+    while(blocksCovered < numBlocksForOneMeeting) {
+        const int shift = std::min(blocksCovered, numBlocksForOneMeeting - blocksCovered);
+        andWithShiftedSelf(meetingStarts, numWords, shift);
+        blocksCovered += shift;
+    }
+
+    int numMeetings = 0;
+    if(numBlocksForOneMeeting == 1) {
+        for(int word = 0; word < numWords; word++) {
+            numMeetings += std::popcount(meetingStarts[word]);
         }
+        return numMeetings;
+    }
 
-        criteriaScores[team] /= desiredTimeBlocksOverlap;
-        criteriaScores[team] *= weight;
-        penaltyPoints[team] *= weight;
+    // meetings can't overlap, so take the earliest start, then the earliest one after that meeting ends, etc.
+    int nextAllowedStart = 0;
+    for(int word = 0; word < numWords; word++) {
+        uint64_t starts = meetingStarts[word];
+        while(starts != 0) {
+            const int time = (word * 64) + std::countr_zero(starts);
+            starts &= starts - 1;
+            if(time >= nextAllowedStart) {
+                numMeetings++;
+                nextAllowedStart = time + numBlocksForOneMeeting;
+            }
+        }
     }
+    return numMeetings;
 }
 
 int ScheduleCriterion::getNumBlocksForOneMeeting(const TeamingOptions *teamingOptions)
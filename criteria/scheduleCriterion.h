@@ -19,9 +19,13 @@ public:
 
     void generateCriteriaCard(TeamingOptions *const /*teamingOptions*/) override;
     void prepareForOptimization(const StudentRecord *students, int numStudents, const DataOptions *dataOptions) override;
-    void calculateScore(const StudentRecord *const students, const int teammates[], const int numTeams, const int teamSizes[],
+    std::unique_ptr<Workspace> createWorkspace(const StudentSnapshot &students, const int numTeams, const int teamSizes[]) const override;
+    void calculateScore(const StudentSnapshot &students, const int teammates[], const int numTeams, const int teamSizes[],
                         const TeamingOptions *const /*teamingOptions*/, const DataOptions *const dataOptions,
-                        QList<float> &criteriaScores, QList<float> &penaltyPoints) const override;
+                        QList<float> &criteriaScores, QList<float> &penaltyPoints, Workspace *const workspace) const override;
+    void calculateTeamScore(const StudentSnapshot &students, const int teammates[], const int teamSize, const int team,
+                            const TeamingOptions *const teamingOptions, const DataOptions *const dataOptions,
+                            QList<float> &criteriaScores, QList<float> &penaltyPoints, Workspace *const workspace) const override;
 
     static int getNumBlocksForOneMeeting(const TeamingOptions *teamingOptions);
 
@@ -43,6 +47,21 @@ public:
     QDoubleSpinBox *meetingLengthSpinBox = nullptr;
 
 private:
+    class ScheduleWorkspace : public Workspace {
+    public:
+        QList<uint64_t> teamAvailability;               // same layout as the bitsets in StudentSnapshot
+        QList<uint64_t> meetingStarts;                  // one day's worth of bits
+        QList<uint64_t> allAvailable;                   // the same size as teamAvailability, with every bit set
+    };
+
+    // the score of one team, shared by calculateScore and calculateTeamScore (FixedTeamSize is 0 unless the team size is known at compile time)
+    template<int FixedTeamSize>
+    void scoreTeam(const StudentSnapshot &students, const int teamStudents[], const int runtimeTeamSize, const int team,
+                   QList<float> &criteriaScores, QList<float> &penaltyPoints, ScheduleWorkspace *const scheduleWorkspace) const;
+
+    // number of non-overlapping meetings of numBlocksForOneMeeting consecutive time blocks that fit within one day's availability bitset
+    int numMeetingTimes(const uint64_t dayAvailability[], const int numTimes, const int numWords, uint64_t meetingStarts[]) const;
+
     int numBlocksForOneMeeting = 1;                     // the minimum length of schedule overlap (in units of # of blocks in schedule)
 };
 
@@ -14,9 +14,12 @@ public:
     Criterion* clone() const override { return nullptr; }
 
     void generateCriteriaCard(TeamingOptions *const teamingOptions) override;
-    void calculateScore(const StudentRecord *const /*students*/, const int /*teammates*/[], const int /*numTeams*/, const int /*teamSizes*/[],
+    void calculateScore(const StudentSnapshot &/*students*/, const int /*teammates*/[], const int /*numTeams*/, const int /*teamSizes*/[],
                                 const TeamingOptions *const /*teamingOptions*/, const DataOptions *const /*dataOptions*/,
-                                QList<float> &/*criteriaScores*/, QList<float> &/*penaltyPoints*/) const override {};
+                                QList<float> &/*criteriaScores*/, QList<float> &/*penaltyPoints*/, Workspace *const /*workspace*/) const override {};
+    void calculateTeamScore(const StudentSnapshot &/*students*/, const int /*teammates*/[], const int /*teamSize*/, const int /*team*/,
+                            const TeamingOptions *const /*teamingOptions*/, const DataOptions *const /*dataOptions*/,
+                            QList<float> &/*criteriaScores*/, QList<float> &/*penaltyPoints*/, Workspace *const /*workspace*/) const override {};
 
     QString headerLabel(const DataOptions *) const override { return {}; }
     Qt::TextElideMode headerElideMode() const override { return Qt::ElideNone; }
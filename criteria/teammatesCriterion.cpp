@@ -4,6 +4,7 @@
 #include "dialogs/teammatesRulesDialog.h"
 #include "widgets/groupingCriteriaCardWidget.h"
 #include <QVBoxLayout>
+#include <algorithm>
 
 Criterion* TeammatesCriterion::clone() const {
     auto *copy = new TeammatesCriterion(criteriaType, weight, penaltyStatus);
@@ -102,45 +103,108 @@ void TeammatesCriterion::generateCriteriaCard(TeamingOptions *const teamingOptio
 }
 
 
-void TeammatesCriterion::calculateScore(const StudentRecord *const students, const int teammates[], const int numTeams, const int teamSizes[],
-                                        const TeamingOptions *const teamingOptions, const DataOptions *const /*dataOptions*/,
-                                        QList<float> &criteriaScores, QList<float> &penaltyPoints) const
+std::unique_ptr<Criterion::Workspace> TeammatesCriterion::createWorkspace(const StudentSnapshot &students, const int numTeams, const int teamSizes[]) const
 {
-    // Get all IDs being teamed (so that we can make sure we only check the groupTogethers/splitAparts that are actually within this teamset)
-    QSet<long long> IDsBeingTeamed;
-    int studentNum = 0;
-    for(int team = 0; team < numTeams; team++) {
-        for(int teammate = 0; teammate < teamSizes[team]; teammate++) {
-            IDsBeingTeamed.insert(students[teammates[studentNum]].ID);
-            studentNum++;
-        }
+    auto workspace = std::make_unique<TeammatesWorkspace>();
+    if(students.hasTeammatesMatrices()) {
+        workspace->teamMatrixIndexes.resize((numTeams > 0)? *std::max_element(teamSizes, teamSizes + numTeams) : 0);
+    }
+    else {
+        workspace->onTeamStamp.assign(students.numStudents, 0);
     }
+    return workspace;
+}
 
-    // Loop through each team
-    studentNum = 0;
-    QSet<long long> IDsOnTeam;
-    QList<const StudentRecord *> teamMembers;
+void TeammatesCriterion::calculateScore(const StudentSnapshot &students, const int teammates[], const int numTeams, const int teamSizes[],
+                                        const TeamingOptions *const /*teamingOptions*/, const DataOptions *const /*dataOptions*/,
+                                        QList<float> &criteriaScores, QList<float> &penaltyPoints, Workspace *const workspace) const
+{
+    auto *const teammatesWorkspace = static_cast<TeammatesWorkspace*>(workspace);
+    forEachTeam(teammates, numTeams, teamSizes, [&](const int teamStudents[], const int teamSize, const int team, const auto fixedTeamSize)
+                {scoreTeam<decltype(fixedTeamSize)::value>(students, teamStudents, teamSize, team, criteriaScores, penaltyPoints, teammatesWorkspace);});
+}
 
-    for(int team = 0; team < numTeams; team++) {
-        IDsOnTeam.clear();
-        teamMembers.clear();
-        teamMembers.reserve(teamSizes[team]);
+void TeammatesCriterion::calculateTeamScore(const StudentSnapshot &students, const int teammates[], const int teamSize, const int team,
+                                            const TeamingOptions *const /*teamingOptions*/, const DataOptions *const /*dataOptions*/,
+                                            QList<float> &criteriaScores, QList<float> &penaltyPoints, Workspace *const workspace) const
+{
+    auto *const teammatesWorkspace = static_cast<TeammatesWorkspace*>(workspace);
+    withFixedTeamSize(teamSize, [&](const auto fixedTeamSize)
+                      {scoreTeam<decltype(fixedTeamSize)::value>(students, teammates, teamSize, team, criteriaScores, penaltyPoints, teammatesWorkspace);});
+}
 
-        for(int teammate = 0; teammate < teamSizes[team]; teammate++) {
-            const auto &currStudent = students[teammates[studentNum]];
-            IDsOnTeam.insert(currStudent.ID);
-            teamMembers.append(&currStudent);
-            studentNum++;
-        }
+template<int FixedTeamSize>
+void TeammatesCriterion::scoreTeam(const StudentSnapshot &students, const int teamStudents[], const int runtimeTeamSize, const int team,
+                                   QList<float> &criteriaScores, QList<float> &penaltyPoints, TeammatesWorkspace *const teammatesWorkspace) const
+{
+    const int teamSize = (FixedTeamSize > 0)? FixedTeamSize : runtimeTeamSize;
 
-        const int penalties = scoreOneTeam(teamMembers, IDsOnTeam, IDsBeingTeamed, teamingOptions);
-        if (penalties > 0 && penaltyStatus) {
-            penaltyPoints[team] += penalties;
+    // The snapshot's lists only hold students being teamed, so each student's teammates (and how many of them are needed) are the same in every genome,
+    // and each team can be scored on its own. Count penalties the same way as scoreOneTeam
+    const auto &teammateLists = (criteriaType == CriteriaType::groupTogether)? students.groupTogether : students.splitApart;
+    int penalties = 0;
+    if (haveAnyTeammates && (criteriaType == CriteriaType::groupTogether || criteriaType == CriteriaType::splitApart)) {
+        if (students.hasTeammatesMatrices()) {
+            const auto &teammateMatrix = (criteriaType == CriteriaType::groupTogether)? students.groupTogetherMatrix : students.splitApartMatrix;
+            int *const teamMatrixIndexes = teammatesWorkspace->teamMatrixIndexes.data();
+            for(int teammate = 0; teammate < teamSize; teammate++) {
+                teamMatrixIndexes[teammate] = students.teammatesMatrixIndex[teamStudents[teammate]];
+            }
+            for(int teammate = 0; teammate < teamSize; teammate++) {
+                const int needed = teammateLists.size(teamStudents[teammate]);
+                if (needed == 0) {
+                    continue;
+                }
+                const uint64_t *const studentsTeammates = teammateMatrix.row(teamMatrixIndexes[teammate]);
+                int found = 0;
+                for(int other = 0; other < teamSize; other++) {
+                    if ((teamMatrixIndexes[other] != -1) && StudentSnapshot::BitMatrix::test(studentsTeammates, teamMatrixIndexes[other])) {
+                        found++;
+                    }
+                }
+                if (criteriaType == CriteriaType::groupTogether) {
+                    if (found < std::min(needed, numberGiven)) {
+                        penalties++;
+                    }
+                }
+                else {
+                    penalties += found;
+                }
+            }
         }
+        else {
+            auto &onTeamStamp = teammatesWorkspace->onTeamStamp;
+            const unsigned long long teamStamp = ++teammatesWorkspace->teamStamp;
+            for(int teammate = 0; teammate < teamSize; teammate++) {
+                onTeamStamp[teamStudents[teammate]] = teamStamp;
+            }
+            for(int teammate = 0; teammate < teamSize; teammate++) {
+                const int student = teamStudents[teammate];
+                const int needed = teammateLists.size(student);
+                int found = 0;
+                for (const int *other = teammateLists.begin(student); other != teammateLists.end(student); other++) {
+                    if (onTeamStamp[*other] == teamStamp) {
+                        found++;
+                    }
+                }
+                if (criteriaType == CriteriaType::groupTogether) {
+                    if (found < std::min(needed, numberGiven)) {
+                        penalties++;
+                    }
+                }
+                else {
+                    penalties += found;
+                }
+            }
+        }
+    }
 
-        criteriaScores[team] = (penalties == 0) ? weight : 0;
-        penaltyPoints[team] *= weight;
+    if (penalties > 0 && penaltyStatus) {
+        penaltyPoints[team] += penalties;
     }
+
+    criteriaScores[team] = (penalties == 0) ? weight : 0;
+    penaltyPoints[team] *= weight;
 }
 
 float TeammatesCriterion::scoreForOneTeamInDisplay(const QList<StudentRecord> &allStudents, const TeamRecord &team, const TeamingOptions *teamingOptions,
@@ -4,6 +4,7 @@
 #include "criterion.h"
 #include <QLabel>
 #include <QPushButton>
+#include <vector>
 
 class TeammatesCriterion : public Criterion {
     Q_OBJECT
@@ -16,9 +17,13 @@ public:
     void settingsFromJson(const QJsonObject &json) override;
 
     void generateCriteriaCard(TeamingOptions *const teamingOptions) override;
-    void calculateScore(const StudentRecord *const students, const int teammates[], const int numTeams, const int teamSizes[],
+    std::unique_ptr<Workspace> createWorkspace(const StudentSnapshot &students, const int numTeams, const int teamSizes[]) const override;
+    void calculateScore(const StudentSnapshot &students, const int teammates[], const int numTeams, const int teamSizes[],
                         const TeamingOptions *const teamingOptions, const DataOptions *const dataOptions,
-                        QList<float> &criteriaScores, QList<float> &penaltyPoints) const override;
+                        QList<float> &criteriaScores, QList<float> &penaltyPoints, Workspace *const workspace) const override;
+    void calculateTeamScore(const StudentSnapshot &students, const int teammates[], const int teamSize, const int team,
+                            const TeamingOptions *const teamingOptions, const DataOptions *const dataOptions,
+                            QList<float> &criteriaScores, QList<float> &penaltyPoints, Workspace *const workspace) const override;
 
     // Need to override this one, because this criterion needs to see all teams for scoring any one team
     float scoreForOneTeamInDisplay(const QList<StudentRecord> &allStudents, const TeamRecord &team, const TeamingOptions *teamingOptions,
@@ -41,6 +46,19 @@ public:
     int numberGiven = REQUESTED_TEAMMATES_ALL;  // For groupTogether: at least how many of the requested teammates should we place on a student's team
 
 private:
+    // with the students' teammates matrices, the team's students' columns in them; otherwise, each student's slot is stamped with the team count when they're on it
+    class TeammatesWorkspace : public Workspace {
+    public:
+        std::vector<int> teamMatrixIndexes;
+        std::vector<unsigned long long> onTeamStamp;
+        unsigned long long teamStamp = 0;
+    };
+
+    // the score of one team, shared by calculateScore and calculateTeamScore (FixedTeamSize is 0 unless the team size is known at compile time)
+    template<int FixedTeamSize>
+    void scoreTeam(const StudentSnapshot &students, const int teamStudents[], const int runtimeTeamSize, const int team,
+                   QList<float> &criteriaScores, QList<float> &penaltyPoints, TeammatesWorkspace *const teammatesWorkspace) const;
+
     int scoreOneTeam(const QList<const StudentRecord *> &teamMembers, const QSet<long long> &idsOnTeam,
                      const QSet<long long> &idsBeingTeamed, const TeamingOptions *const teamingOptions) const;
 };
@@ -3,7 +3,7 @@
 #include "teamingOptions.h"
 #include "widgets/groupingCriteriaCardWidget.h"
 
-void TeamsizeCriterion::generateCriteriaCard(TeamingOptions *const /*teamingOptions*/)
+void TeamsizeCriterion::generateCriteriaCard(TeamingOptions *const teamingOptions)
 {
     auto *teamSizeContentAreaLayout = new QHBoxLayout();
     teamSizeContentAreaLayout->setSpacing(2);
@@ -25,7 +25,22 @@ void TeamsizeCriterion::generateCriteriaCard(TeamingOptions *const /*teamingOpti
     idealTeamSizeBox->installEventFilter(new MouseWheelBlocker(idealTeamSizeBox));
     idealTeamSizeBox->setFocusPolicy(Qt::StrongFocus);
 
+    timeLimitBox = new QSpinBox(parentCard);
+    timeLimitBox->setStyleSheet(SPINBOXSTYLE);
+    timeLimitBox->setRange(0, MAX_TIME_LIMIT);
+    timeLimitBox->setSingleStep(10);
+    timeLimitBox->setValue(teamingOptions->timeLimitPerSection);
+    timeLimitBox->setSpecialValueText(tr("no time limit"));
+    timeLimitBox->setSuffix(tr(" s limit"));
+    timeLimitBox->setToolTip(tr("The most time to spend creating each section's teams, after which the best teams found so far are used"));
+    timeLimitBox->setSizePolicy(QSizePolicy::Minimum, QSizePolicy::Fixed);
+    timeLimitBox->setMinimumHeight(30);
+    timeLimitBox->setMinimumWidth(50);
+    timeLimitBox->installEventFilter(new MouseWheelBlocker(timeLimitBox));
+    timeLimitBox->setFocusPolicy(Qt::StrongFocus);
+
     teamSizeContentAreaLayout->addWidget(idealTeamSizeBox);
     teamSizeContentAreaLayout->addWidget(teamSizeBox);
+    teamSizeContentAreaLayout->addWidget(timeLimitBox);
     parentCard->setContentAreaLayout(*teamSizeContentAreaLayout);
 }
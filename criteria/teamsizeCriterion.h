@@ -14,9 +14,12 @@ public:
     Criterion* clone() const override { return nullptr; }
 
     void generateCriteriaCard(TeamingOptions *const teamingOptions) override;
-    void calculateScore(const StudentRecord *const /*students*/, const int /*teammates*/[], const int /*numTeams*/, const int /*teamSizes*/[],
+    void calculateScore(const StudentSnapshot &/*students*/, const int /*teammates*/[], const int /*numTeams*/, const int /*teamSizes*/[],
                         const TeamingOptions *const /*teamingOptions*/, const DataOptions *const /*dataOptions*/,
-                        QList<float> &/*criteriaScores*/, QList<float> &/*penaltyPoints*/) const override {};
+                        QList<float> &/*criteriaScores*/, QList<float> &/*penaltyPoints*/, Workspace *const /*workspace*/) const override {};
+    void calculateTeamScore(const StudentSnapshot &/*students*/, const int /*teammates*/[], const int /*teamSize*/, const int /*team*/,
+                            const TeamingOptions *const /*teamingOptions*/, const DataOptions *const /*dataOptions*/,
+                            QList<float> &/*criteriaScores*/, QList<float> &/*penaltyPoints*/, Workspace *const /*workspace*/) const override {};
 
     QString headerLabel(const DataOptions *) const override { return {}; }
     Qt::TextElideMode headerElideMode() const override { return Qt::ElideNone; }
@@ -26,6 +29,9 @@ public:
 
     StyledComboBox *teamSizeBox = nullptr;
     QSpinBox *idealTeamSizeBox = nullptr;
+    QSpinBox *timeLimitBox = nullptr;        // seconds of optimization per section, 0 = no limit
+
+    inline static const int MAX_TIME_LIMIT = 3600;
 };
 
 #endif // TEAMSIZECRITERION_H
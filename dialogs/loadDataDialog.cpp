@@ -6,7 +6,7 @@
 #include "dialogs/categorizingDialog.h"
 #include "widgets/dropcsvframe.h"
 #include "widgets/styledComboBox.h"
-#include <QCollator>
+#include "surveyReader.h"
 #include <QDir>
 #include <QJsonArray>
 #include <QJsonDocument>
@@ -262,68 +262,7 @@ bool loadDataDialog::readQuestionsFromHeader()
         return false;
     }
 
-    // See if there are header fields after any of (preferred teammates / non-teammates, section, or schedule) since those are probably notes fields
-    static const QRegularExpression lastKnownMeaningfulField("(.*(like to not have on your team).*)|(.*(want to avoid working with).*)|"
-                                                             "(.*(like to have on your team).*)|(.*(want to work with).*)|"
-                                                             ".*(which section are you enrolled).*|(.*(check).+(times).*)",
-                                                             QRegularExpression::CaseInsensitiveOption);
-    const int notesFieldsProbBeginAt = 1 + int(surveyFile->headerValues.lastIndexOf(lastKnownMeaningfulField));
-    if((notesFieldsProbBeginAt != 0) && (notesFieldsProbBeginAt != surveyFile->headerValues.size())) {
-        //if notesFieldsProbBeginAt == 0 then none of these questions exist, so assume no notes because list ends with attributes
-        //and if notesFieldsProbBeginAt == headervalues size, also assume no notes because list ends with one of these questions
-        for(int field = notesFieldsProbBeginAt; field < surveyFile->fieldMeanings.size(); field++) {
-            surveyFile->fieldMeanings[field] = "Notes";
-        }
-    }
-
-    // Ask user what the columns mean
-    const QList<possFieldMeaning> surveyFieldOptions = {{"Timestamp", "(timestamp)|(^submitted$)", 1},
-                                                        {"First Name", "((first)|(given)|(preferred))(?!.*last).*(name)", 1},
-                                                        {"Last Name", "^(?!.*first).*((last)|(sur)|(family)).*(name)", 1},
-                                                        {"Email Address", "(e).*(mail)", 1},
-                                                        {"Gender", "((gender)|(pronouns))", 1},
-                                                        {"Racial/ethnic identity", "((minority)|(ethnic))", 1},
-                                                        {"Schedule", "((check)|(select)).+(times)", MAX_DAYS},
-                                                        {"Section", "which section are you enrolled", 1},
-                                                        {"Timezone","(time zone)", 1},
-                                                        {"Preferred Teammates", "(like to have on your team)|(want to work with)", MAX_PREFTEAMMATES},
-                                                        {"Preferred Non-teammates", "(like to not have on your team)|(want to avoid working with)", MAX_PREFTEAMMATES},
-                                                        {"Assignment Preference", QString("\\[(") + RANKYOURFIRSTCHOICE + "|" + RANKYOURCHOICE + " \\d+)\\]", MAX_ASSIGNMENT_OPTIONS},
-                                                        {"Multiple Choice or Numerical", ".*", MAX_ATTRIBUTES},
-                                                        {"Notes", "", MAX_NOTES}};
-    // see if each field is a value to be ignored; if not and the fieldMeaning is empty, preload with possibleFieldMeaning based on matches to the patterns
-    for(int i = 0; i < surveyFile->numFields; i++) {
-        const QString &headerVal = surveyFile->headerValues.at(i);
-
-        bool ignore = false;
-        for(const auto &matchpattern : std::as_const(surveyFile->fieldsToBeIgnored)) {
-            if(headerVal.contains(QRegularExpression(matchpattern, QRegularExpression::CaseInsensitiveOption))) {
-                surveyFile->fieldMeanings[i] = "**IGNORE**";
-                ignore = true;
-            }
-            // if this is coming from Canvas, see if it's the LMSID field and, if so, set the field
-            if((source == DataOptions::DataSource::fromCanvas) && (headerVal.compare("id", Qt::CaseInsensitive) == 0)) {
-                surveyFile->fieldMeanings[i] = "**LMSID**";
-                ignore = true;
-            }
-        }
-
-        if(!ignore && surveyFile->fieldMeanings.at(i).isEmpty()) {
-            int matchPattern = 0;
-            QString match;
-            do {
-                match = surveyFieldOptions.at(matchPattern).regExSearchString;
-                matchPattern++;
-            } while((matchPattern < surveyFieldOptions.size()) && !headerVal.contains(QRegularExpression(match, QRegularExpression::CaseInsensitiveOption)));
-
-            if(matchPattern != surveyFieldOptions.size()) {
-                surveyFile->fieldMeanings[i] = surveyFieldOptions.at(matchPattern - 1).nameShownToUser;
-            }
-            else {
-                surveyFile->fieldMeanings[i] = UNUSEDTEXT;
-            }
-        }
-    }
+    SurveyReader::preloadFieldMeanings(*surveyFile, source);
 
     return true;
 }
@@ -687,95 +626,7 @@ bool loadDataDialog::readData()
     loadingProgressDialog->setStyleSheet(QString(LABEL10PTSTYLE) + PROGRESSBARSTYLE + SMALLBUTTONSTYLEINVERTED);
 
     // set field values now according to user's selection of field meanings (defaulting to FIELDNOTPRESENT (i.e., -1) if not chosen)
-    dataOptions->timestampField = int(surveyFile->fieldMeanings.indexOf("Timestamp"));
-    dataOptions->LMSIDField = int(surveyFile->fieldMeanings.indexOf("**LMSID**"));
-    dataOptions->firstNameField = int(surveyFile->fieldMeanings.indexOf("First Name"));
-    dataOptions->lastNameField = int(surveyFile->fieldMeanings.indexOf("Last Name"));
-    dataOptions->emailField = int(surveyFile->fieldMeanings.indexOf("Email Address"));
-    dataOptions->genderField = int(surveyFile->fieldMeanings.indexOf("Gender"));
-    dataOptions->genderIncluded = (dataOptions->genderField != DataOptions::FIELDNOTPRESENT);
-    dataOptions->URMField = int(surveyFile->fieldMeanings.indexOf("Racial/ethnic identity"));
-    dataOptions->URMIncluded = (dataOptions->URMField != DataOptions::FIELDNOTPRESENT);
-    dataOptions->sectionField = int(surveyFile->fieldMeanings.indexOf("Section"));
-    dataOptions->sectionIncluded = (dataOptions->sectionField != DataOptions::FIELDNOTPRESENT);
-    dataOptions->timezoneField = int(surveyFile->fieldMeanings.indexOf("Timezone"));
-    dataOptions->timezoneIncluded = (dataOptions->timezoneField != DataOptions::FIELDNOTPRESENT);
-
-    // pref teammates fields
-    int lastFoundIndex = 0;
-    const int numTeammateQs = int(surveyFile->fieldMeanings.count("Preferred Teammates"));
-    for(int prefQ = 0; prefQ < numTeammateQs; prefQ++) {
-        dataOptions->prefTeammatesField << int(surveyFile->fieldMeanings.indexOf("Preferred Teammates", lastFoundIndex));
-        lastFoundIndex = std::max(lastFoundIndex, 1 + int(surveyFile->fieldMeanings.indexOf("Preferred Teammates", lastFoundIndex)));
-    }
-    // pref non-teammates fields
-    lastFoundIndex = 0;
-    const int numNonTeammateQs = int(surveyFile->fieldMeanings.count("Preferred Non-teammates"));
-    for(int prefQ = 0; prefQ < numNonTeammateQs; prefQ++) {
-        dataOptions->prefNonTeammatesField << int(surveyFile->fieldMeanings.indexOf("Preferred Non-teammates", lastFoundIndex));
-        lastFoundIndex = std::max(lastFoundIndex, 1 + int(surveyFile->fieldMeanings.indexOf("Preferred Non-teammates", lastFoundIndex)));
-    }
-    // notes fields
-    lastFoundIndex = 0;
-    const int numNotes = int(surveyFile->fieldMeanings.count("Notes"));
-    for(int note = 0; note < numNotes; note++) {
-        dataOptions->notesFields << int(surveyFile->fieldMeanings.indexOf("Notes", lastFoundIndex));
-        lastFoundIndex = std::max(lastFoundIndex, 1 + int(surveyFile->fieldMeanings.indexOf("Notes", lastFoundIndex)));
-    }
-    // assignment preference fields (ranked choices, in order of rank)
-    lastFoundIndex = 0;
-    const int numAssignmentPreferenceFields = int(surveyFile->fieldMeanings.count("Assignment Preference"));
-    for(int pref = 0; pref < numAssignmentPreferenceFields; pref++) {
-        dataOptions->assignmentPreferenceFields << int(surveyFile->fieldMeanings.indexOf("Assignment Preference", lastFoundIndex));
-        lastFoundIndex = std::max(lastFoundIndex, 1 + int(surveyFile->fieldMeanings.indexOf("Assignment Preference", lastFoundIndex)));
-    }
-    // attribute fields
-    lastFoundIndex = 0;
-    dataOptions->numAttributes = int(surveyFile->fieldMeanings.count("Multiple Choice or Numerical"));
-    for(int attribute = 0; attribute < dataOptions->numAttributes; attribute++) {
-        dataOptions->attributeField << int(surveyFile->fieldMeanings.indexOf("Multiple Choice or Numerical", lastFoundIndex));
-        QString questionText = surveyFile->headerValues.at(dataOptions->attributeField[attribute]);
-        // if this is coming from Canvas, remove the leading integer (a prepended Canvas question ID number) from the question
-        if(source == DataOptions::DataSource::fromCanvas) {
-            static const QRegularExpression startsWithInteger(R"(^(\d++: ))");
-            QRegularExpressionMatch match;
-            match = startsWithInteger.match(questionText);
-            questionText = questionText.mid(match.capturedLength(1));
-        }
-        dataOptions->attributeQuestionText << questionText;
-        lastFoundIndex = std::max(lastFoundIndex, 1 + int(surveyFile->fieldMeanings.indexOf("Multiple Choice or Numerical", lastFoundIndex)));
-    }
-    if(dataOptions->timezoneIncluded) {
-        dataOptions->attributeField << dataOptions->timezoneField;
-        dataOptions->attributeQuestionText << surveyFile->headerValues.at(dataOptions->timezoneField);
-        dataOptions->numAttributes++;
-    }
-    // schedule fields
-    lastFoundIndex = 0;
-    for(int scheduleQuestion = 0, numScheduleFields = int(surveyFile->fieldMeanings.count("Schedule")); scheduleQuestion < numScheduleFields; scheduleQuestion++) {
-        const int field = int(surveyFile->fieldMeanings.indexOf("Schedule", lastFoundIndex));
-        dataOptions->scheduleField << field;
-        const QString scheduleQuestionText = surveyFile->headerValues.at(field);
-        static const QRegularExpression freeOrAvailable(".+\\b(free|available)\\b.+", QRegularExpression::CaseInsensitiveOption);
-        if(scheduleQuestionText.contains(freeOrAvailable)) {
-            // if >=1 field has this language, all interpreted as free time
-            dataOptions->scheduleDataIsFreetime = true;
-        }
-        static const QRegularExpression homeTimezone(".+\\b(your home)\\b.+", QRegularExpression::CaseInsensitiveOption);
-        if(scheduleQuestionText.contains(homeTimezone)) {
-            // if >=1 field has this language, all interpreted as referring to each student's home timezone
-            dataOptions->homeTimezoneUsed = true;
-        }
-        static const QRegularExpression dayNameFinder("\\[([^[]*)\\]");   // Day name is in brackets at end of field (where Google Forms puts column titles in matrix questions)
-        const QRegularExpressionMatch dayName = dayNameFinder.match(scheduleQuestionText);
-        if(dayName.hasMatch()) {
-            dataOptions->dayNames << dayName.captured(1);
-        }
-        else {
-            dataOptions->dayNames << " " + QString::number(scheduleQuestion+1) + " ";
-        }
-        lastFoundIndex = std::max(lastFoundIndex, 1 + int(surveyFile->fieldMeanings.indexOf("Schedule", lastFoundIndex)));
-    }
+    SurveyReader::setFieldsFromMeanings(*surveyFile, *dataOptions, source);
     loadingProgressDialog->setValue(1);
     // read one line of data; if no data after header row then file is invalid
     if(!surveyFile->readDataRow()) {
@@ -786,83 +637,13 @@ bool loadDataDialog::readData()
     }
 
     // If there is schedule info, read through the schedule fields in all of the responses to compile a list of time names, save as dataOptions->TimeNames
-    if(!dataOptions->dayNames.isEmpty()) {
-        QStringList allTimeNames;
-        do {
-            for(const int fieldNum : std::as_const(dataOptions->scheduleField)) {
-                if (fieldNum >= 0 && fieldNum < surveyFile->fieldValues.size()) {
-                    QString scheduleFieldText = (surveyFile->fieldValues.at(fieldNum)).toLower().split(';').join(',');
-                    QTextStream scheduleFieldStream(&scheduleFieldText);
-                    allTimeNames << CsvFile::getLine(scheduleFieldStream);
-                }
-            }
-        } while(surveyFile->readDataRow());
-        allTimeNames.removeDuplicates();
-        allTimeNames.removeOne("");
-
-        //sort allTimeNames smartly, using string -> hour of day float; any timeName not found is put at the beginning of the list
-        std::sort(allTimeNames.begin(), allTimeNames.end(), [] (const QString &a, const QString &b) {
-            return grueprGlobal::timeStringToHours(a) < grueprGlobal::timeStringToHours(b);
-        });
-        dataOptions->timeNames = allTimeNames;
-
-        // Set the schedule resolution (in units of hours) by looking at all the time values.
-        // If any end with 0.25, set schedule resolution to 0.25 immediately and stop looking.
-        // If none do, still keep looking for any that end 0.5, in which case resolution is 0.5.
-        // If none do, keep at default of 1.
-        dataOptions->scheduleResolution = 1;
-        for(const auto &timeName : std::as_const(dataOptions->timeNames)) {
-            const int numOfQuarterHours = std::lround(4 * grueprGlobal::timeStringToHours(timeName)) % 4;
-            if((numOfQuarterHours == 1) || (numOfQuarterHours == 3)) {
-                dataOptions->scheduleResolution = 0.25;
-                break;
-            }
-            if(numOfQuarterHours == 2) {
-                dataOptions->scheduleResolution = 0.5;
-            }
-        }
-
-        //pad the timeNames to include all 24 hours if we will be time-shifting student responses based on their home timezones later
-        if(dataOptions->homeTimezoneUsed) {
-            dataOptions->earlyTimeAsked = std::max(0.0f, grueprGlobal::timeStringToHours(dataOptions->timeNames.constFirst()));
-            dataOptions->lateTimeAsked = std::max(0.0f, grueprGlobal::timeStringToHours(dataOptions->timeNames.constLast()));
-            const QStringList formats = QString(TIMEFORMATS).split(';');
-
-            //figure out which format to use for the timenames we're adding
-            auto timeName = dataOptions->timeNames.constBegin();
-            QString timeFormat;
-            QTime time;
-            do {
-                for(const auto &format : formats) {
-                    time = QTime::fromString(*timeName, format);
-                    if(time.isValid()) {
-                        timeFormat = format;
-                        break;
-                    }
-                }
-                timeName++;
-            } while(!time.isValid() && timeName != dataOptions->timeNames.constEnd());
-
-            float hoursSinceMidnight = 0;
-            for(int timeBlock = 0; timeBlock < int(24 / dataOptions->scheduleResolution); timeBlock++) {
-                if(dataOptions->timeNames.size() > timeBlock) {
-                    if(grueprGlobal::timeStringToHours(dataOptions->timeNames.at(timeBlock)) == hoursSinceMidnight) {
-                        //this timename already exists in the list
-                        hoursSinceMidnight += dataOptions->scheduleResolution;
-                        continue;
-                    }
-                }
-                time.setHMS(int(hoursSinceMidnight), int(60 * (hoursSinceMidnight - int(hoursSinceMidnight))), 0);
-                dataOptions->timeNames.insert(timeBlock, time.toString(timeFormat));
-                hoursSinceMidnight += dataOptions->scheduleResolution;
-            }
-
-            // Ask what should be used as the base timezone to which schedules will all be adjusted
-            auto *window = new baseTimezoneDialog(this);
-            window->exec();
-            dataOptions->baseTimezone = window->baseTimezoneVal;
-            window->deleteLater();
-        }
+    SurveyReader::compileTimeNames(*surveyFile, *dataOptions);
+    if(!dataOptions->dayNames.isEmpty() && dataOptions->homeTimezoneUsed) {
+        // Ask what should be used as the base timezone to which schedules will all be adjusted
+        auto *window = new baseTimezoneDialog(this);
+        window->exec();
+        dataOptions->baseTimezone = window->baseTimezoneVal;
+        window->deleteLater();
     }
     loadingProgressDialog->setValue(2);
 
@@ -910,25 +691,7 @@ bool loadDataDialog::readData()
             }
         }
 
-        // Figure out what type of gender data was given (if any) -- initialized value is GenderType::adult, and we're checking each student
-        // because some values are ambiguous to GenderType (e.g. "nonbinary")
-        if(dataOptions->genderIncluded) {
-            if (dataOptions->genderField >= 0 && dataOptions->genderField < surveyFile->fieldValues.size()) {
-                const QString genderText = surveyFile->fieldValues.at(dataOptions->genderField);
-                if(genderText.contains(tr("male"), Qt::CaseInsensitive)) {  // contains "male" also picks up "female"
-                    dataOptions->genderType = GenderType::biol;
-                }
-                else if(genderText.contains(tr("man"), Qt::CaseInsensitive)) {  // contains "man" also picks up "woman"
-                    dataOptions->genderType = GenderType::adult;
-                }
-                else if((genderText.contains(tr("girl"), Qt::CaseInsensitive)) || (genderText.contains("boy", Qt::CaseInsensitive))) {
-                    dataOptions->genderType = GenderType::child;
-                }
-                else if(genderText.contains(tr("he"), Qt::CaseInsensitive)) {  // contains "he" also picks up "she" and "they"
-                    dataOptions->genderType = GenderType::pronoun;
-                }
-            }
-        }
+        SurveyReader::updateGenderType(surveyFile->fieldValues, *dataOptions);
 
         numStudents++;
         students << currStudent;
@@ -1026,218 +789,19 @@ bool loadDataDialog::readData()
     }
 
     // Set the attribute question options and numerical values for each student
-    dataOptions->attributeQuestionResponses.resize(dataOptions->numAttributes);
-    dataOptions->attributeQuestionResponseCounts.resize(dataOptions->numAttributes);
-    dataOptions->attributeVals_discrete.resize(dataOptions->numAttributes);
-    dataOptions->attributeVals_continuous.resize(dataOptions->numAttributes);
-    dataOptions->attributeType.resize(dataOptions->numAttributes);
+    SurveyReader::sizeAttributeResponses(*dataOptions);
     for(int attribute = 0; attribute < dataOptions->numAttributes; attribute++) {
         if(loadingProgressDialog->wasCanceled()) {
             surveyFile->close((source == DataOptions::DataSource::fromGoogle) || (source == DataOptions::DataSource::fromCanvas));
             return false;
         }
 
-        auto &responses = dataOptions->attributeQuestionResponses[attribute];
-        auto &attributeType = dataOptions->attributeType[attribute];
-        // gather all unique attribute question responses, then remove a blank response if it exists in a list with other responses
-        for(const auto &student : std::as_const(students)) {
-            if(!responses.contains(student.attributeResponse[attribute])) {
-                responses << student.attributeResponse[attribute];
-            }
-        }
-        if(responses.size() > 1) {
-            responses.removeAll(QString(""));
-        }
-
-        // Figure out what type of attribute this is: timezone, ordered/numerical, categorical (one response), or categorical (mult. responses)
-        // If this is the timezone field, it's timezone type;
-        // otherwise, if any response contains a comma, then it's multicategorical
-        // otheriwse, if every response starts with an integer, it is ordered (numerical);
-        // otherwise, if any response is missing an integer at the start, then it is categorical
-        // The regex to recognize ordered/numerical is:
-        // digit(s) then, optionally, "." or "," then end; OR digit(s) then "." or "," then any character but digits; OR digit(s) then any character but "." or ","
-        static const QRegularExpression startsWithInteger(R"(^(\d++)([\.\,]?$|[\.\,]\D|[^\.\,]))");
-        static const QRegularExpression isJustAFloat(R"(^-?\d+(\.\d+)?$)");
-        if(dataOptions->attributeField[attribute] == dataOptions->timezoneField) {
-            attributeType = DataOptions::AttributeType::timezone;
-        }
-        else if(std::any_of(responses.constBegin(), responses.constEnd(), [](const QString &response)
-                             {return response.contains(',');})) {
-            attributeType = DataOptions::AttributeType::multicategorical;   // might be multiordered, this gets sorted out below
-        }
-        else if(std::all_of(responses.constBegin(), responses.constEnd(), [](const QString &response)
-                             {return isJustAFloat.match(response).hasMatch();})) {
-            attributeType = DataOptions::AttributeType::numerical;
-        }
-        else if(std::all_of(responses.constBegin(), responses.constEnd(), [](const QString &response)
-                             {return startsWithInteger.match(response).hasMatch();})) {
-            attributeType = DataOptions::AttributeType::ordered;
-        }
-        else {
-            attributeType = DataOptions::AttributeType::categorical;
-        }
-
-        // for multicategorical, have to reprocess the responses to delimit at the commas and then determine if actually multiordered
-        if(attributeType == DataOptions::AttributeType::multicategorical) {
-            for(int originalResponseNum = 0, numOriginalResponses = int(responses.size()); originalResponseNum < numOriginalResponses; originalResponseNum++) {
-                QStringList newResponses = responses.takeFirst().split(',');
-                for(auto &newResponse : newResponses) {
-                    newResponse = newResponse.trimmed();
-                    if(!responses.contains(newResponse)) {
-                        responses << newResponse;
-                    }
-                }
-            }
-            responses.removeAll(QString(""));
-            // now that we've split them up, let's see if actually multiordered instead of multicategorical
-            if(std::all_of(responses.constBegin(), responses.constEnd(), [](const QString &response) {return startsWithInteger.match(response).hasMatch();})) {
-                attributeType = DataOptions::AttributeType::multiordered;
-            }
-        }
-
-        // sort alphanumerically unless it's timezone, in which case sort according to offset from GMT, or numerical, in which case sort by float value
-        if(attributeType == DataOptions::AttributeType::timezone) {
-            std::sort(responses.begin(), responses.end(), [] (const QString &A, const QString &B) {
-                float timezoneA = 0, timezoneB = 0;
-                QString unusedtimezoneName;
-                DataOptions::parseTimezoneInfoFromText(A, unusedtimezoneName, timezoneA);
-                DataOptions::parseTimezoneInfoFromText(B, unusedtimezoneName, timezoneB);
-                return timezoneA < timezoneB;
-            });
-        }
-        else if(attributeType == DataOptions::AttributeType::numerical) {
-            std::sort(responses.begin(), responses.end(), [] (const QString &A, const QString &B) {
-                return A.toFloat() < B.toFloat();
-            });
-        }
-        else {
-            QCollator sortAlphanumerically;
-            sortAlphanumerically.setNumericMode(true);
-            sortAlphanumerically.setCaseSensitivity(Qt::CaseInsensitive);
-            std::sort(responses.begin(), responses.end(), sortAlphanumerically);
-        }
-
-        // set values associated with each response and create a spot to hold the responseCounts
-        if((attributeType == DataOptions::AttributeType::ordered) ||
-            (attributeType == DataOptions::AttributeType::multiordered)) {
-            // ordered/numerical values. value is based on number at start of response
-            for(const auto &response : std::as_const(responses)) {
-                dataOptions->attributeVals_discrete[attribute].insert(startsWithInteger.match(response).captured(1).toInt());
-                dataOptions->attributeQuestionResponseCounts[attribute].insert({response, 0});
-            }
-        }
-        else if(attributeType == DataOptions::AttributeType::numerical) {
-            // No discrete response set — store observed float range in continuous vals.
-            // The student loop below will insert into attributeVals_continuous.
-            // Response counts are not meaningful for free-range numbers; leave empty.
-        }
-        else if((attributeType == DataOptions::AttributeType::categorical) ||
-                 (attributeType == DataOptions::AttributeType::multicategorical)) {
-            // categorical values. value is based on index of response within sorted list
-            for(int i = 1; i <= responses.size(); i++) {
-                dataOptions->attributeVals_discrete[attribute].insert(i);
-                dataOptions->attributeQuestionResponseCounts[attribute].insert({responses.at(i-1), 0});
-            }
-        }
-        else { // timezone
-            for(int i = 1; i <= responses.size(); i++) {
-                dataOptions->attributeVals_discrete[attribute].insert(i);
-                dataOptions->attributeQuestionResponseCounts[attribute].insert({responses.at(i-1), 0});
-            }
-        }
-
-        // set numerical value of each student's response and record in dataOptions a tally for each response
-        for(auto &student : students) {
-            const QString &currentStudentResponse = student.attributeResponse[attribute];
-            QList<int> &discreteVals = student.attributeVals_discrete[attribute];
-            QList<float> &continuousVals = student.attributeVals_continuous[attribute];
-
-            if(!currentStudentResponse.isEmpty()) {
-                if(attributeType == DataOptions::AttributeType::numerical) {
-                    bool scannedAValue = false;
-                    const float val = currentStudentResponse.trimmed().toFloat(&scannedAValue);
-                    if(scannedAValue) {
-                        continuousVals << val;
-                        dataOptions->attributeVals_continuous[attribute].insert(val);
-                    }
-                    // No response count tracking for free-range numbers.
-                }
-                else if(attributeType == DataOptions::AttributeType::ordered) {
-                    discreteVals << startsWithInteger.match(currentStudentResponse).captured(1).toInt();
-                    dataOptions->attributeQuestionResponseCounts[attribute][currentStudentResponse]++;
-                }
-                else if((attributeType == DataOptions::AttributeType::categorical) ||
-                         (attributeType == DataOptions::AttributeType::timezone)) {
-                    discreteVals << int(responses.indexOf(currentStudentResponse)) + 1;
-                    dataOptions->attributeQuestionResponseCounts[attribute][currentStudentResponse]++;
-                }
-                else if(attributeType == DataOptions::AttributeType::multicategorical) {
-                    const QStringList parts = currentStudentResponse.split(',', Qt::SkipEmptyParts);
-                    for(const auto &part : parts) {
-                        discreteVals << int(responses.indexOf(part.trimmed())) + 1;
-                        dataOptions->attributeQuestionResponseCounts[attribute][part.trimmed()]++;
-                    }
-                }
-                else if(attributeType == DataOptions::AttributeType::multiordered) {
-                    const QStringList parts = currentStudentResponse.split(',', Qt::SkipEmptyParts);
-                    for(const auto &part : parts) {
-                        discreteVals << startsWithInteger.match(part.trimmed()).captured(1).toInt();
-                        dataOptions->attributeQuestionResponseCounts[attribute][part.trimmed()]++;
-                    }
-                }
-                // For timezone the float value is set separately via student.timezone;
-                // the discrete sentinel (index into sorted tz list) is set above via
-                // the categorical branch, which is correct existing behaviour.
-            }
-            else {
-                discreteVals << -1;  // unknown sentinel for discrete types
-                // for numerical/timezone, empty continuousVals means unknown
-            }
-        }
+        SurveyReader::processAttributeResponses(attribute, students, *dataOptions);
         loadingProgressDialog->setValue(2 + numStudents + attribute);
     }
     loadingProgressDialog->setValue(2 + numStudents + dataOptions->numAttributes);
     // gather all unique URM and section question responses and sort
-    for(const auto &student : std::as_const(students)) {
-        if(!dataOptions->URMResponses.contains(student.URMResponse, Qt::CaseInsensitive)) {
-            dataOptions->URMResponses << student.URMResponse;
-        }
-        if(!(dataOptions->sectionNames.contains(student.section, Qt::CaseInsensitive))) {
-            dataOptions->sectionNames << student.section;
-        }
-
-        for(const auto gender : std::as_const(student.gender)){
-            if(!dataOptions->genderValues.contains(gender)) {
-                dataOptions->genderValues << gender;
-            }
-        }
-        //Only take the first gender, otherwise numOfIdentities > numOfStudents
-        const Gender studentFirstGender = student.gender.values().at(0);
-        if (dataOptions->countOfGenderIdentities.contains(studentFirstGender)){
-            dataOptions->countOfGenderIdentities[studentFirstGender]++;
-        }
-        else {
-            dataOptions->countOfGenderIdentities[studentFirstGender] = 0;
-        }
-
-        if (dataOptions->countOfURMIdentities.contains(student.URMResponse)){
-            dataOptions->countOfURMIdentities[student.URMResponse]++;
-        }
-        else {
-            dataOptions->countOfURMIdentities[student.URMResponse] = 0;
-        }
-    }
-
-    QCollator sortAlphanumerically;
-    sortAlphanumerically.setNumericMode(true);
-    sortAlphanumerically.setCaseSensitivity(Qt::CaseInsensitive);
-    std::sort(dataOptions->URMResponses.begin(), dataOptions->URMResponses.end(), sortAlphanumerically);
-    if(dataOptions->URMResponses.contains("--")) {
-        // put the blank response option at the end of the list
-        dataOptions->URMResponses.removeAll("--");
-        dataOptions->URMResponses << "--";
-    }
-    std::sort(dataOptions->sectionNames.begin(), dataOptions->sectionNames.end(), sortAlphanumerically);
+    SurveyReader::gatherIdentityResponses(students, *dataOptions);
 
     loadingProgressDialog->setValue(surveyFile->estimatedNumberRows + 3 + dataOptions->numAttributes);
 
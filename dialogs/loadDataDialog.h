@@ -54,7 +54,6 @@ private:
     inline static const QString HEADERTEXT = QObject::tr("Question text");
     inline static const QString CATEGORYTEXT = QObject::tr("Category");
     inline static const QString ROW1TEXT = QObject::tr("First Row of Data");
-    inline static const QString UNUSEDTEXT = QObject::tr("Unused");
     inline static const int BASEWINDOWWIDTH = 800;
     inline static const int BASEWINDOWHEIGHT = 456;
     inline static const int BASICICONSIZE = 30;
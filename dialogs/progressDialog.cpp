@@ -113,6 +113,11 @@ void progressDialog::highlightStopButton()
     countdownToClose->start(std::chrono::seconds(1));
 }
 
+bool progressDialog::onlyStoppingManually() const
+{
+    return onlyStopManually->isChecked();
+}
+
 void progressDialog::updateCountdown()
 {
     if(onlyStopManually->isChecked()) {
@@ -21,6 +21,7 @@ public:
 
     void setText(const QString &text = "", int generation = 0, float score = 0, bool autostopInProgress = false);
     void highlightStopButton();
+    bool onlyStoppingManually() const;
 
 private slots:
     void statsButtonPushed(QWidget *chart);
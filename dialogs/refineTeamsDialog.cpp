@@ -0,0 +1,84 @@
+#include "refineTeamsDialog.h"
+#include "gruepr_globals.h"
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QLabel>
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+// A dialog to refine a set of teams, choosing any students (or whole teams) to keep as they are
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+refineTeamsDialog::refineTeamsDialog(const TeamSet &teams, const QList<StudentRecord> &students, QWidget *parent)
+    :listTableDialog(tr("Refine these teams"), true, true, parent)
+{
+    setMinimumSize(SM_DLG_SIZE, SM_DLG_SIZE);
+
+    //Rows 1&2 - the explanation and a spacer
+    auto *explanation = new QLabel(tr("gruepr will look for a better set of teams, starting from these teams instead of from scratch.\n"
+                                      "Select any students who should stay on their current team, or select a team to keep it exactly as it is."), this);
+    explanation->setStyleSheet(QString(LABEL10PTSTYLE).replace("QLabel {", "QLabel {background-color: " TRANSPARENT ";"));
+    explanation->setWordWrap(true);
+    theGrid->addWidget(explanation, 0, 1, 1, 1);
+    addSpacerRow(1);
+
+    //Row 3 - table of the teams, each with a checkbox for the whole team and one for each student
+    const int numTeams = int(teams.size());
+    theTable->setRowCount(numTeams);
+    int widthCol0 = 0, rowHeight = 0;
+    for(int team = 0; team < numTeams; team++) {
+        auto *teamCheckBox = new QCheckBox(tr("Team ") + teams.at(team).name, this);
+        teamCheckBox->setStyleSheet(CHECKBOXSTYLE);
+        theTable->setCellWidget(team, 0, teamCheckBox);
+        widthCol0 = std::max(widthCol0, teamCheckBox->width());
+
+        auto *teammates = new QWidget(this);
+        auto *teammatesLayout = new QHBoxLayout(teammates);
+        teammatesLayout->setContentsMargins(0, 0, 0, 0);
+        QList<QCheckBox*> teammateCheckBoxes;
+        for(const auto ID : std::as_const(teams.at(team).studentIDs)) {
+            const auto student = std::find_if(students.cbegin(), students.cend(), [ID](const StudentRecord &student){return (student.ID == ID);});
+            if(student == students.cend()) {
+                continue;
+            }
+            auto *studentCheckBox = new QCheckBox(student->firstname + " " + student->lastname, teammates);
+            studentCheckBox->setStyleSheet(CHECKBOXSTYLE);
+            teammatesLayout->addWidget(studentCheckBox);
+            teammateCheckBoxes << studentCheckBox;
+            studentCheckBoxes << studentCheckBox;
+            studentIDs << ID;
+        }
+        teammatesLayout->addStretch(1);
+        theTable->setCellWidget(team, 1, teammates);
+        rowHeight = std::max(rowHeight, std::max(teamCheckBox->height(), teammates->sizeHint().height()));
+
+        // selecting the team selects all of its students, and the team is selected only while all of its students are
+        connect(teamCheckBox, &QCheckBox::clicked, this, [teammateCheckBoxes](const bool checked)
+                                                         {for(auto *const studentCheckBox : teammateCheckBoxes) {studentCheckBox->setChecked(checked);}});
+        for(auto *const studentCheckBox : std::as_const(teammateCheckBoxes)) {
+            connect(studentCheckBox, &QCheckBox::toggled, this, [teamCheckBox, teammateCheckBoxes]
+                                                                {teamCheckBox->setChecked(std::all_of(teammateCheckBoxes.cbegin(), teammateCheckBoxes.cend(),
+                                                                                                      [](const QCheckBox *const box){return box->isChecked();}));});
+        }
+    }
+    theTable->horizontalHeader()->resizeSection(0, int(float(widthCol0) * TABLEOVERSIZE));
+    for(int team = 0; team < numTeams; team++) {
+        theTable->verticalHeader()->resizeSection(team, int(float(rowHeight) * TABLEOVERSIZE));
+    }
+    theTable->adjustSize();
+
+    buttonBox->button(QDialogButtonBox::Ok)->setText(tr("Refine"));
+
+    adjustSize();
+}
+
+
+QList<long long> refineTeamsDialog::pinnedStudentIDs() const
+{
+    QList<long long> pinnedIDs;
+    for(int student = 0; student < studentCheckBoxes.size(); student++) {
+        if(studentCheckBoxes.at(student)->isChecked()) {
+            pinnedIDs << studentIDs.at(student);
+        }
+    }
+    return pinnedIDs;
+}
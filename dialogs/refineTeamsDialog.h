@@ -0,0 +1,28 @@
+#ifndef REFINETEAMSDIALOG_H
+#define REFINETEAMSDIALOG_H
+
+#include "listTableDialog.h"
+#include "studentRecord.h"
+#include "teamRecord.h"
+#include <QCheckBox>
+
+class refineTeamsDialog : public listTableDialog
+{
+    Q_OBJECT
+
+public:
+    refineTeamsDialog(const TeamSet &teams, const QList<StudentRecord> &students, QWidget *parent = nullptr);
+    ~refineTeamsDialog() override = default;
+    refineTeamsDialog(const refineTeamsDialog&) = delete;
+    refineTeamsDialog operator= (const refineTeamsDialog&) = delete;
+    refineTeamsDialog(refineTeamsDialog&&) = delete;
+    refineTeamsDialog& operator= (refineTeamsDialog&&) = delete;
+
+    QList<long long> pinnedStudentIDs() const;      // the students chosen to stay on their current team
+
+private:
+    QList<QCheckBox*> studentCheckBoxes;
+    QList<long long> studentIDs;                    // the ID of the student for each checkbox
+};
+
+#endif // REFINETEAMSDIALOG_H
@@ -0,0 +1,213 @@
+#include "gaCheckpoint.h"
+#include <QSaveFile>
+#include <QtConcurrentRun>
+#include <algorithm>
+#include <cstring>
+
+struct GACheckpoint::Header
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t headerSize;
+    uint64_t fileSize;
+    uint64_t optimizationKey;
+    int32_t numStudents;
+    int32_t populationSize;
+    int32_t numAncestors;
+    int32_t numIslands;
+    int32_t generation;
+    int32_t numBestScores;
+    int32_t numPRNGStates;
+    float scoreStability;
+    uint32_t unpenalizedGenomePresent;
+    uint32_t reserved;
+    // where each array starts in the file (in bytes); the pRNG states are numPRNGStates sizes (uint64_t) followed by each state's text
+    uint64_t genePoolOffset;
+    uint64_t ancestorsOffset;
+    uint64_t scoresOffset;
+    uint64_t orderedIndexOffset;
+    uint64_t islandOrderedIndexOffset;
+    uint64_t bestScoresOffset;
+    uint64_t pRNGStatesOffset;
+};
+
+
+//////////////////
+// Fill in the header for this state, with each array's place in the file, returning the size of the whole file
+//////////////////
+qsizetype GACheckpoint::layout(const State &state, Header &header)
+{
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.headerSize = sizeof(Header);
+    header.optimizationKey = state.optimizationKey;
+    header.numStudents = state.numStudents;
+    header.populationSize = state.populationSize;
+    header.numAncestors = state.numAncestors;
+    header.numIslands = state.numIslands;
+    header.generation = state.generation;
+    header.numBestScores = state.numBestScores;
+    header.numPRNGStates = int32_t(state.pRNGStates.size());
+    header.scoreStability = state.scoreStability;
+    header.unpenalizedGenomePresent = state.unpenalizedGenomePresent? 1 : 0;
+    header.reserved = 0;
+
+    qsizetype size = sizeof(Header);
+    const auto place = [&size](const qsizetype bytes) {
+        const qsizetype start = ((size + ALIGNMENT - 1) / ALIGNMENT) * ALIGNMENT;
+        size = start + bytes;
+        return uint64_t(start);
+    };
+    const qsizetype populationSize = state.populationSize;
+    header.genePoolOffset = place(populationSize * state.numStudents * qsizetype(sizeof(int32_t)));
+    header.ancestorsOffset = place(populationSize * state.numAncestors * qsizetype(sizeof(int32_t)));
+    header.scoresOffset = place(populationSize * qsizetype(sizeof(float)));
+    header.orderedIndexOffset = place(populationSize * qsizetype(sizeof(int32_t)));
+    header.islandOrderedIndexOffset = place(populationSize * qsizetype(sizeof(int32_t)));
+    header.bestScoresOffset = place(state.numBestScores * qsizetype(sizeof(float)));
+    qsizetype pRNGStatesSize = state.pRNGStates.size() * qsizetype(sizeof(uint64_t));
+    for(const auto &pRNGState : state.pRNGStates) {
+        pRNGStatesSize += pRNGState.size();
+    }
+    header.pRNGStatesOffset = place(pRNGStatesSize);
+    header.fileSize = uint64_t(size);
+    return size;
+}
+
+
+//////////////////
+// Copy the state into the buffer and then save the buffer to the file on another thread.
+// The file is written to a temporary file that replaces the checkpoint only once it's complete, so an interrupted save leaves the previous checkpoint intact.
+//////////////////
+bool GACheckpoint::Writer::write(const State &state)
+{
+    if(pendingSave.isRunning()) {
+        return false;
+    }
+
+    Header header{};
+    buffer.resize(layout(state, header));
+    char *const data = buffer.data();
+    std::memcpy(data, &header, sizeof(Header));
+    const qsizetype populationSize = state.populationSize;
+    std::memcpy(data + header.genePoolOffset, state.genePool, populationSize * state.numStudents * sizeof(int32_t));
+    std::memcpy(data + header.ancestorsOffset, state.ancestors, populationSize * state.numAncestors * sizeof(int32_t));
+    std::memcpy(data + header.scoresOffset, state.scores, populationSize * sizeof(float));
+    std::memcpy(data + header.orderedIndexOffset, state.orderedIndex, populationSize * sizeof(int32_t));
+    std::memcpy(data + header.islandOrderedIndexOffset, state.islandOrderedIndex, populationSize * sizeof(int32_t));
+    std::memcpy(data + header.bestScoresOffset, state.bestScores, state.numBestScores * sizeof(float));
+    char *pRNGData = data + header.pRNGStatesOffset;
+    for(const auto &pRNGState : state.pRNGStates) {
+        const auto stateSize = uint64_t(pRNGState.size());
+        std::memcpy(pRNGData, &stateSize, sizeof(uint64_t));
+        pRNGData += sizeof(uint64_t);
+    }
+    for(const auto &pRNGState : state.pRNGStates) {
+        std::memcpy(pRNGData, pRNGState.constData(), pRNGState.size());
+        pRNGData += pRNGState.size();
+    }
+
+    pendingSave = QtConcurrent::run([this] {
+        QSaveFile saveFile(fileName);
+        if(!saveFile.open(QIODevice::WriteOnly) || (saveFile.write(buffer) != buffer.size()) || !saveFile.commit()) {
+            return false;
+        }
+        numSaved++;
+        return true;
+    });
+    return true;
+}
+
+void GACheckpoint::Writer::waitForFinished()
+{
+    pendingSave.waitForFinished();
+}
+
+
+void GACheckpoint::remove(const QString &fileName)
+{
+    QFile::remove(fileName);
+}
+
+
+//////////////////
+// Map the file and check that it is a complete checkpoint, with every array within the file
+//////////////////
+GACheckpoint::GACheckpoint(const QString &fileName) :
+    file(fileName)
+{
+    if(!file.open(QIODevice::ReadOnly) || (file.size() < qint64(sizeof(Header)))) {
+        return;
+    }
+    map = file.map(0, file.size());
+    if(map == nullptr) {
+        return;
+    }
+
+    Header header{};
+    std::memcpy(&header, map, sizeof(Header));
+    if((std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0) || (header.version != VERSION) || (header.headerSize != sizeof(Header)) ||
+        (header.fileSize != uint64_t(file.size())) || (header.numStudents <= 0) || (header.populationSize <= 0) || (header.numAncestors <= 0) ||
+        (header.numIslands <= 0) || (header.numBestScores < 0) || (header.numPRNGStates < 0)) {
+        return;
+    }
+
+    // the layout is recomputed from the header's sizes, so any difference in the stored offsets means a corrupt file
+    State &state = mappedState;
+    state.optimizationKey = header.optimizationKey;
+    state.numStudents = header.numStudents;
+    state.populationSize = header.populationSize;
+    state.numAncestors = header.numAncestors;
+    state.numIslands = header.numIslands;
+    state.generation = header.generation;
+    state.numBestScores = header.numBestScores;
+    state.scoreStability = header.scoreStability;
+    state.unpenalizedGenomePresent = (header.unpenalizedGenomePresent != 0);
+    if((header.pRNGStatesOffset > header.fileSize) ||
+        ((uint64_t(header.numPRNGStates) * sizeof(uint64_t)) > (header.fileSize - header.pRNGStatesOffset))) {
+        return;
+    }
+    const uchar *pRNGData = map + header.pRNGStatesOffset;
+    const uchar *const end = map + file.size();
+    const uchar *pRNGText = pRNGData + (qsizetype(header.numPRNGStates) * qsizetype(sizeof(uint64_t)));
+    for(int pRNG = 0; pRNG < header.numPRNGStates; pRNG++) {
+        uint64_t stateSize = 0;
+        std::memcpy(&stateSize, pRNGData + (pRNG * sizeof(uint64_t)), sizeof(uint64_t));
+        if(stateSize > uint64_t(end - pRNGText)) {
+            return;
+        }
+        state.pRNGStates << QByteArray::fromRawData(reinterpret_cast<const char*>(pRNGText), qsizetype(stateSize));
+        pRNGText += stateSize;
+    }
+    Header expected{};
+    if((layout(state, expected) != file.size()) ||
+        (std::memcmp(&expected.genePoolOffset, &header.genePoolOffset, sizeof(uint64_t) * 7) != 0)) {
+        return;
+    }
+
+    state.genePool = reinterpret_cast<const int*>(map + header.genePoolOffset);
+    state.ancestors = reinterpret_cast<const int*>(map + header.ancestorsOffset);
+    state.scores = reinterpret_cast<const float*>(map + header.scoresOffset);
+    state.orderedIndex = reinterpret_cast<const int*>(map + header.orderedIndexOffset);
+    state.islandOrderedIndex = reinterpret_cast<const int*>(map + header.islandOrderedIndexOffset);
+    state.bestScores = reinterpret_cast<const float*>(map + header.bestScoresOffset);
+
+    // every index must be in range, so that a damaged file can't send the optimization out of bounds
+    const auto inRange = [](const int *const values, const qsizetype numValues, const int limit) {
+        return std::all_of(values, values + numValues, [limit](const int value){return (value >= 0) && (value < limit);});
+    };
+    valid = inRange(state.orderedIndex, state.populationSize, state.populationSize) &&
+            inRange(state.islandOrderedIndex, state.populationSize, state.populationSize);
+}
+
+GACheckpoint::~GACheckpoint()
+{
+    if(map != nullptr) {
+        file.unmap(map);
+    }
+}
+
+float GACheckpoint::bestScore() const
+{
+    return valid? mappedState.scores[mappedState.orderedIndex[0]] : 0;
+}
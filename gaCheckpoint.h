@@ -0,0 +1,92 @@
+#ifndef GACHECKPOINT_H
+#define GACHECKPOINT_H
+
+// A snapshot of the genetic algorithm's state, saved periodically during a long optimization so that, after a crash or an accidental close,
+// the optimization can continue from where it was instead of starting over.
+// The file is a fixed header followed by each array, every one starting on a 64-byte boundary, so the file is memory mapped and read in place.
+// Values are stored in the machine's own byte order and type sizes: a checkpoint is for resuming on the machine that wrote it.
+
+#include <QByteArray>
+#include <QFile>
+#include <QFuture>
+#include <QList>
+#include <QString>
+#include <atomic>
+#include <cstdint>
+
+class GACheckpoint
+{
+public:
+    // Everything needed to continue an optimization: when writing, pointers to the optimizer's arrays; when reading, pointers into the mapped file
+    struct State
+    {
+        uint64_t optimizationKey = 0;           // identifies the students and team sizes being optimized, so a checkpoint is only resumed by the same optimization
+        int numStudents = 0;
+        int populationSize = 0;
+        int numAncestors = 0;
+        int numIslands = 0;
+        int generation = 0;
+        float scoreStability = 0;
+        bool unpenalizedGenomePresent = false;
+        const int *genePool = nullptr;          // populationSize genomes of numStudents, end-to-end
+        const int *ancestors = nullptr;         // populationSize sets of numAncestors, end-to-end
+        const float *scores = nullptr;          // populationSize
+        const int *orderedIndex = nullptr;      // populationSize
+        const int *islandOrderedIndex = nullptr;// populationSize
+        const float *bestScores = nullptr;      // the historical record of best scores
+        int numBestScores = 0;
+        QList<QByteArray> pRNGStates;           // the textual representation of each pRNG's state (as from operator<<)
+    };
+
+    // Opens and maps a checkpoint file; state() is only usable if isValid()
+    explicit GACheckpoint(const QString &fileName);
+    ~GACheckpoint();
+    GACheckpoint(const GACheckpoint&) = delete;
+    GACheckpoint operator= (const GACheckpoint&) = delete;
+    GACheckpoint(GACheckpoint&&) = delete;
+    GACheckpoint& operator= (GACheckpoint&&) = delete;
+
+    bool isValid() const {return valid;}
+    const State &state() const {return mappedState;}
+    float bestScore() const;
+
+    // Saves checkpoints on a background thread. The state is copied into a buffer on the calling thread (the only pause to the optimization),
+    // and while a save is still in progress, any new checkpoint is skipped rather than waited for.
+    class Writer
+    {
+    public:
+        explicit Writer(const QString &fileName) : fileName(fileName) {}
+        ~Writer() {waitForFinished();}
+        Writer(const Writer&) = delete;
+        Writer operator= (const Writer&) = delete;
+        Writer(Writer&&) = delete;
+        Writer& operator= (Writer&&) = delete;
+
+        bool write(const State &state);     // returns false if skipped because the previous save is still in progress
+        void waitForFinished();
+        int numWritten() const {return numSaved.load();}
+
+    private:
+        const QString fileName;
+        QByteArray buffer;                  // reused for every checkpoint, and never touched while a save is in progress
+        QFuture<bool> pendingSave;
+        std::atomic<int> numSaved = 0;
+    };
+
+    static void remove(const QString &fileName);
+
+private:
+    struct Header;
+    static qsizetype layout(const State &state, Header &header);
+
+    QFile file;
+    uchar *map = nullptr;
+    State mappedState;
+    bool valid = false;
+
+    inline static const char MAGIC[8] = {'g', 'r', 'u', 'e', 'p', 'r', 'G', 'A'};
+    inline static const uint32_t VERSION = 1;
+    inline static const qsizetype ALIGNMENT = 64;
+};
+
+#endif // GACHECKPOINT_H
@@ -0,0 +1,327 @@
+#include "greedySeeder.h"
+#include "criteria/teammatesCriterion.h"
+#include <algorithm>
+#include <numeric>
+
+GreedySeeder::GreedySeeder(const StudentSnapshot &students, const QList<int> &studentIndexes, const QList<int> &teamSizes,
+                           const TeamingOptions *const teamingOptions, const DataOptions *const dataOptions) :
+    students(students),
+    teamingOptions(teamingOptions),
+    dataOptions(dataOptions),
+    numTeams(int(teamSizes.size())),
+    teamSizes(teamSizes.cbegin(), teamSizes.cend()),
+    teamStartPositions(numTeams + 1, 0),
+    inGroup(students.numStudents, 0)
+{
+    for(int team = 0; team < numTeams; team++) {
+        teamStartPositions[team + 1] = teamStartPositions[team] + teamSizes[team];
+        maxTeamSize = std::max(maxTeamSize, int(teamSizes[team]));
+    }
+
+    // the hard rules are those of the criteria that penalize breaking them
+    for(const auto *const criterion : std::as_const(teamingOptions->criteria)) {
+        if(!criterion->penaltyStatus) {
+            continue;
+        }
+        switch(criterion->criteriaType) {
+        case Criterion::CriteriaType::groupTogether:
+            groupingTogether = groupingTogether || static_cast<const TeammatesCriterion*>(criterion)->haveAnyTeammates;
+            break;
+        case Criterion::CriteriaType::splitApart:
+            keepingApart = keepingApart || static_cast<const TeammatesCriterion*>(criterion)->haveAnyTeammates;
+            break;
+        case Criterion::CriteriaType::genderIdentity:
+        case Criterion::CriteriaType::urmIdentity:
+            identityCriteria.push_back(criterion);
+            break;
+        default:
+            break;
+        }
+    }
+
+    // the groups are the sets of students (being teamed) linked to each other through their lists of students to be grouped together,
+    // found by merging the sets of each linked pair of students
+    std::vector<int> groupOf(students.numStudents);
+    std::iota(groupOf.begin(), groupOf.end(), 0);
+    const auto findGroup = [&groupOf](int student) {
+        while(groupOf[student] != student) {
+            groupOf[student] = groupOf[groupOf[student]];
+            student = groupOf[student];
+        }
+        return student;
+    };
+    if(groupingTogether) {
+        std::vector<uint8_t> beingTeamed(students.numStudents, 0);
+        for(const int student : studentIndexes) {
+            beingTeamed[student] = 1;
+        }
+        for(const int student : studentIndexes) {
+            for(const int *other = students.groupTogether.begin(student); other != students.groupTogether.end(student); other++) {
+                if(beingTeamed[*other] != 0) {
+                    groupOf[findGroup(student)] = findGroup(*other);
+                }
+            }
+        }
+    }
+
+    // each group becomes a unit (split into parts the size of the largest team, if it's larger), and then every other student becomes a unit of their own
+    std::vector<int> byGroup(studentIndexes.cbegin(), studentIndexes.cend());
+    for(const int student : byGroup) {
+        groupOf[student] = findGroup(student);
+    }
+    std::stable_sort(byGroup.begin(), byGroup.end(), [&groupOf](const int a, const int b){return groupOf[a] < groupOf[b];});
+    std::vector<int> singleStudents;
+    unitStarts.push_back(0);
+    for(auto first = byGroup.cbegin(); first != byGroup.cend();) {
+        const int group = groupOf[*first];
+        const auto last = std::find_if(first, byGroup.cend(), [&groupOf, group](const int student){return groupOf[student] != group;});
+        while(first != last) {
+            const auto partEnd = first + std::min(qsizetype(maxTeamSize), qsizetype(last - first));
+            if(partEnd - first == 1) {
+                singleStudents.push_back(*first);
+            }
+            else {
+                for(auto student = first; student != partEnd; student++) {
+                    unitStudents.push_back(*student);
+                    inGroup[*student] = 1;
+                }
+                unitStarts.push_back(int(unitStudents.size()));
+            }
+            first = partEnd;
+        }
+    }
+    numGroups = int(unitStarts.size()) - 1;
+    for(const int student : singleStudents) {
+        unitStudents.push_back(student);
+        unitStarts.push_back(int(unitStudents.size()));
+    }
+}
+
+
+GreedySeeder::Workspace::Workspace(const GreedySeeder &seeder) :
+    unitOrder(seeder.unitStarts.size() - 1),
+    teamOfStudent(seeder.students.numStudents, -1),
+    teamFill(seeder.numTeams, 0),
+    openIndex(seeder.numTeams, 0),
+    teamPenalties(seeder.numTeams, 0),
+    isViolating(seeder.numTeams, 0),
+    criteriaScores(seeder.numTeams, 0),
+    penaltyPoints(seeder.numTeams, 0),
+    pairTeammates(2 * qsizetype(seeder.maxTeamSize), 0)
+{
+    std::iota(unitOrder.begin(), unitOrder.end(), 0);
+    openTeams.reserve(seeder.numTeams);
+    violatingTeams.reserve(seeder.numTeams);
+    for(const auto *const criterion : seeder.identityCriteria) {
+        criterionWorkspaces.push_back(criterion->createWorkspace(seeder.students, seeder.numTeams, seeder.teamSizes.data()));
+    }
+}
+
+
+void GreedySeeder::buildTeamSet(int genome[], std::mt19937 &pRNG, Workspace &workspace) const
+{
+    // start with every team empty
+    for(const int student : unitStudents) {
+        workspace.teamOfStudent[student] = -1;
+    }
+    std::fill(workspace.teamFill.begin(), workspace.teamFill.end(), 0);
+    workspace.openTeams.clear();
+    for(int team = 0; team < numTeams; team++) {
+        if(teamSizes[team] > 0) {
+            workspace.openIndex[team] = int(workspace.openTeams.size());
+            workspace.openTeams.push_back(team);
+        }
+    }
+
+    // place the groups, larger groups first (while there's the most room for them) and otherwise in random order, then every other student in random order
+    auto &unitOrder = workspace.unitOrder;
+    const auto unitSize = [this](const int unit){return unitStarts[unit + 1] - unitStarts[unit];};
+    std::shuffle(unitOrder.begin(), unitOrder.begin() + numGroups, pRNG);
+    std::stable_sort(unitOrder.begin(), unitOrder.begin() + numGroups, [&unitSize](const int a, const int b){return unitSize(a) > unitSize(b);});
+    std::shuffle(unitOrder.begin() + numGroups, unitOrder.end(), pRNG);
+    for(const int unit : unitOrder) {
+        const int *const members = unitStudents.data() + unitStarts[unit];
+        const int size = unitSize(unit);
+        const int team = chooseTeam(members, size, pRNG, workspace);
+        if(team != -1) {
+            for(int member = 0; member < size; member++) {
+                placeOnTeam(genome, members[member], team, workspace);
+            }
+        }
+        else {
+            // no team has room left for the whole group, so its students are placed one at a time (there's always room for one)
+            for(int member = 0; member < size; member++) {
+                placeOnTeam(genome, members[member], chooseTeam(members + member, 1, pRNG, workspace), workspace);
+            }
+        }
+    }
+
+    if(!identityCriteria.empty()) {
+        repairIdentityRules(genome, pRNG, workspace);
+    }
+}
+
+
+//////////////////
+// Choose the team for a unit: usually a random team with room and none of the students the unit is to be kept apart from,
+// otherwise the team with room and the fewest of them, or -1 if no team has room for the unit
+//////////////////
+int GreedySeeder::chooseTeam(const int unitStudents[], const int unitSize, std::mt19937 &pRNG, Workspace &workspace) const
+{
+    auto &conflictTeams = workspace.conflictTeams;
+    conflictTeams.clear();
+    if(keepingApart) {
+        for(int member = 0; member < unitSize; member++) {
+            for(const int *other = students.splitApart.begin(unitStudents[member]); other != students.splitApart.end(unitStudents[member]); other++) {
+                if(workspace.teamOfStudent[*other] != -1) {
+                    conflictTeams.push_back(workspace.teamOfStudent[*other]);
+                }
+            }
+        }
+    }
+    const auto numConflicts = [&conflictTeams](const int team){return int(std::count(conflictTeams.cbegin(), conflictTeams.cend(), team));};
+    const auto hasRoom = [this, &workspace, unitSize](const int team){return (teamSizes[team] - workspace.teamFill[team]) >= unitSize;};
+
+    const auto &openTeams = workspace.openTeams;
+    const int numOpenTeams = int(openTeams.size());
+    std::uniform_int_distribution<int> randOpenTeam(0, numOpenTeams - 1);
+    for(int tries = 0; tries < MAX_RANDOM_TEAM_TRIES; tries++) {
+        const int team = openTeams[randOpenTeam(pRNG)];
+        if(hasRoom(team) && (numConflicts(team) == 0)) {
+            return team;
+        }
+    }
+
+    int bestTeam = -1;
+    int fewestConflicts = 0;
+    const int firstOpenTeam = randOpenTeam(pRNG);
+    for(int openTeam = 0; openTeam < numOpenTeams; openTeam++) {
+        const int team = openTeams[(firstOpenTeam + openTeam) % numOpenTeams];
+        if(!hasRoom(team)) {
+            continue;
+        }
+        const int conflicts = numConflicts(team);
+        if((bestTeam == -1) || (conflicts < fewestConflicts)) {
+            bestTeam = team;
+            fewestConflicts = conflicts;
+            if(conflicts == 0) {
+                break;
+            }
+        }
+    }
+    return bestTeam;
+}
+
+
+void GreedySeeder::placeOnTeam(int genome[], const int student, const int team, Workspace &workspace) const
+{
+    genome[teamStartPositions[team] + workspace.teamFill[team]] = student;
+    workspace.teamFill[team]++;
+    workspace.teamOfStudent[student] = team;
+
+    // a full team is no longer open
+    if(workspace.teamFill[team] == teamSizes[team]) {
+        auto &openTeams = workspace.openTeams;
+        const int index = workspace.openIndex[team];
+        openTeams[index] = openTeams.back();
+        workspace.openIndex[openTeams[index]] = index;
+        openTeams.pop_back();
+    }
+}
+
+
+//////////////////
+// Repair the teams breaking an identity rule by trying random swaps of one of their students with a student on another team
+// (often one also breaking a rule, since a single swap can then repair both), keeping any swap that reduces the two teams' penalties.
+// Students in a group and swaps that would put a student on a team with someone they're to be kept apart from are left alone.
+//////////////////
+void GreedySeeder::repairIdentityRules(int genome[], std::mt19937 &pRNG, Workspace &workspace) const
+{
+    auto &teamPenalties = workspace.teamPenalties;
+    auto &violatingTeams = workspace.violatingTeams;
+    auto &isViolating = workspace.isViolating;
+
+    std::fill(workspace.penaltyPoints.begin(), workspace.penaltyPoints.end(), 0.0f);
+    for(int criterion = 0; criterion < int(identityCriteria.size()); criterion++) {
+        identityCriteria[criterion]->calculateScore(students, genome, numTeams, teamSizes.data(), teamingOptions, dataOptions,
+                                                    workspace.criteriaScores, workspace.penaltyPoints, workspace.criterionWorkspaces[criterion].get());
+    }
+    violatingTeams.clear();
+    for(int team = 0; team < numTeams; team++) {
+        teamPenalties[team] = workspace.penaltyPoints[team];
+        isViolating[team] = (teamPenalties[team] > 0)? 1 : 0;
+        if(isViolating[team] != 0) {
+            violatingTeams.push_back(team);
+        }
+    }
+
+    std::uniform_int_distribution<int> randTeam(0, numTeams - 1);
+    for(int attempt = int(violatingTeams.size()) * REPAIR_ATTEMPTS_PER_TEAM; (attempt > 0) && !violatingTeams.empty(); attempt--) {
+        std::uniform_int_distribution<int> randViolatingTeam(0, int(violatingTeams.size()) - 1);
+        const int violatingIndex = randViolatingTeam(pRNG);
+        const int teamA = violatingTeams[violatingIndex];
+        if(teamPenalties[teamA] <= 0) {
+            // (repaired by an earlier swap)
+            violatingTeams[violatingIndex] = violatingTeams.back();
+            violatingTeams.pop_back();
+            isViolating[teamA] = 0;
+            continue;
+        }
+        const int teamB = ((violatingTeams.size() > 1) && ((pRNG() & 1u) != 0))? violatingTeams[randViolatingTeam(pRNG)] : randTeam(pRNG);
+        if(teamB == teamA) {
+            continue;
+        }
+        const int positionA = teamStartPositions[teamA] + std::uniform_int_distribution<int>(0, teamSizes[teamA] - 1)(pRNG);
+        const int positionB = teamStartPositions[teamB] + std::uniform_int_distribution<int>(0, teamSizes[teamB] - 1)(pRNG);
+        const int studentA = genome[positionA];
+        const int studentB = genome[positionB];
+        if((inGroup[studentA] != 0) || (inGroup[studentB] != 0) ||
+            (keepingApart && (keptApartFromTeam(studentA, teamB, studentB, workspace) || keptApartFromTeam(studentB, teamA, studentA, workspace)))) {
+            continue;
+        }
+
+        const float penaltiesBefore = teamPenalties[teamA] + teamPenalties[teamB];
+        std::swap(genome[positionA], genome[positionB]);
+        if(penaltiesOfTwoTeams(genome, teamA, teamB, workspace) < penaltiesBefore) {
+            teamPenalties[teamA] = workspace.penaltyPoints[0];
+            teamPenalties[teamB] = workspace.penaltyPoints[1];
+            workspace.teamOfStudent[studentA] = teamB;
+            workspace.teamOfStudent[studentB] = teamA;
+            if((teamPenalties[teamB] > 0) && (isViolating[teamB] == 0)) {
+                isViolating[teamB] = 1;
+                violatingTeams.push_back(teamB);
+            }
+        }
+        else {
+            std::swap(genome[positionA], genome[positionB]);
+        }
+    }
+}
+
+
+//////////////////
+// The identity criteria's penalties for two teams, gathered into a team set of their own that is scored just as they would be in the whole team set
+// (each team's penalties are left in workspace.penaltyPoints[0] and [1])
+//////////////////
+float GreedySeeder::penaltiesOfTwoTeams(const int genome[], const int teamA, const int teamB, Workspace &workspace) const
+{
+    const int pairTeamSizes[2] = {teamSizes[teamA], teamSizes[teamB]};
+    std::copy_n(genome + teamStartPositions[teamA], pairTeamSizes[0], workspace.pairTeammates.begin());
+    std::copy_n(genome + teamStartPositions[teamB], pairTeamSizes[1], workspace.pairTeammates.begin() + pairTeamSizes[0]);
+
+    workspace.penaltyPoints[0] = 0;
+    workspace.penaltyPoints[1] = 0;
+    for(int criterion = 0; criterion < int(identityCriteria.size()); criterion++) {
+        identityCriteria[criterion]->calculateScore(students, workspace.pairTeammates.data(), 2, pairTeamSizes, teamingOptions, dataOptions,
+                                                    workspace.criteriaScores, workspace.penaltyPoints, workspace.criterionWorkspaces[criterion].get());
+    }
+    return workspace.penaltyPoints[0] + workspace.penaltyPoints[1];
+}
+
+
+// whether the student is to be kept apart from anyone on the team, other than the ignored student (who is leaving the team)
+bool GreedySeeder::keptApartFromTeam(const int student, const int team, const int ignoredStudent, const Workspace &workspace) const
+{
+    return std::any_of(students.splitApart.begin(student), students.splitApart.end(student),
+                       [&workspace, team, ignoredStudent](const int other){return (other != ignoredStudent) && (workspace.teamOfStudent[other] == team);});
+}
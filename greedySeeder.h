@@ -0,0 +1,85 @@
+#ifndef GREEDYSEEDER_H
+#define GREEDYSEEDER_H
+
+// A randomized greedy constructor of team sets that honor the hard rules (the teammates rules and identity rules of any criterion that penalizes breaking them),
+// used to build part of the optimization's initial population so that the early generations aren't spent only repairing broken rules.
+// Each team set is built by placing each group of students to be grouped together (as far as the team sizes allow) on a single team,
+// larger groups first and otherwise in random order, each on a random team with room that has none of the students they're to be kept apart from.
+// Then any team breaking an identity rule is repaired by trying random swaps of its students with those of other teams, keeping those that reduce the penalties.
+
+#include "dataOptions.h"
+#include "studentSnapshot.h"
+#include "teamingOptions.h"
+#include "criteria/criterion.h"
+#include <QList>
+#include <memory>
+#include <random>
+#include <vector>
+
+class GreedySeeder
+{
+public:
+    GreedySeeder(const StudentSnapshot &students, const QList<int> &studentIndexes, const QList<int> &teamSizes,
+                 const TeamingOptions *const teamingOptions, const DataOptions *const dataOptions);
+    ~GreedySeeder() = default;
+    GreedySeeder(const GreedySeeder&) = delete;
+    GreedySeeder operator= (const GreedySeeder&) = delete;
+    GreedySeeder(GreedySeeder&&) = delete;
+    GreedySeeder& operator= (GreedySeeder&&) = delete;
+
+    bool hasHardRules() const {return groupingTogether || keepingApart || !identityCriteria.empty();}
+
+    // Scratch space for building team sets, one per thread, reused for every team set that thread builds
+    class Workspace
+    {
+    public:
+        explicit Workspace(const GreedySeeder &seeder);
+
+        std::vector<int> unitOrder;
+        std::vector<int> teamOfStudent;             // for each student (by index into students), the team they've been placed on, or -1
+        std::vector<int> teamFill;                  // the number of students placed on each team so far
+        std::vector<int> openTeams;                 // the teams with room left, in any order...
+        std::vector<int> openIndex;                 // ...and where each team is in openTeams
+        std::vector<int> conflictTeams;             // the teams of the students that the unit being placed is to be kept apart from
+        std::vector<float> teamPenalties;
+        std::vector<int> violatingTeams;
+        std::vector<uint8_t> isViolating;
+        QList<float> criteriaScores;                // space for the identity criteria's scoring of the whole team set, or of just two teams of it
+        QList<float> penaltyPoints;
+        std::vector<int> pairTeammates;
+        std::vector<std::unique_ptr<Criterion::Workspace>> criterionWorkspaces;
+    };
+
+    // fill genome (numStudents long, in the same form as the optimizer's genomes) with a new team set
+    void buildTeamSet(int genome[], std::mt19937 &pRNG, Workspace &workspace) const;
+
+private:
+    int chooseTeam(const int unitStudents[], int unitSize, std::mt19937 &pRNG, Workspace &workspace) const;
+    void placeOnTeam(int genome[], int student, int team, Workspace &workspace) const;
+    void repairIdentityRules(int genome[], std::mt19937 &pRNG, Workspace &workspace) const;
+    float penaltiesOfTwoTeams(const int genome[], int teamA, int teamB, Workspace &workspace) const;
+    bool keptApartFromTeam(int student, int team, int ignoredStudent, const Workspace &workspace) const;
+
+    const StudentSnapshot &students;
+    const TeamingOptions *const teamingOptions;
+    const DataOptions *const dataOptions;
+    const int numTeams;
+    std::vector<int> teamSizes;
+    std::vector<int> teamStartPositions;
+    int maxTeamSize = 0;
+
+    // every student being teamed is in exactly one unit: a group of students to be grouped together, or a student on their own
+    std::vector<int> unitStudents;                  // the students of each unit, end-to-end, each unit's starting at unitStarts[unit]
+    std::vector<int> unitStarts;
+    int numGroups = 0;                              // the units that are groups come first
+    std::vector<uint8_t> inGroup;                   // for each student (by index into students), whether they're in a group (and so never swapped apart in repairs)
+
+    bool groupingTogether = false;
+    bool keepingApart = false;
+    std::vector<const Criterion*> identityCriteria; // the identity criteria that penalize breaking their rules
+
+    inline static const int MAX_RANDOM_TEAM_TRIES = 8;          // random open teams tried for a unit before looking through all of them
+    inline static const int REPAIR_ATTEMPTS_PER_TEAM = 64;      // swaps tried for each team initially breaking an identity rule
+};
+
+#endif // GREEDYSEEDER_H
@@ -12,10 +12,11 @@
 #include "widgets/sortableTableWidgetItem.h"
 #include "widgets/teamsTabItem.h"
 #include <memory>
-#include <random>
 #include <QDesktopServices>
 #include <QFile>
 #include <QFileDialog>
+#include <QFileInfo>
+#include <QHash>
 #include <QJsonArray>
 #include <QJsonDocument>
 #include <QList>
@@ -26,6 +27,7 @@
 #include <QPushButton>
 #include <QScreen>
 #include <QScrollBar>
+#include <QSet>
 #include <QSettings>
 #include <QSlider>
 #include <QSplitter>
@@ -137,6 +139,7 @@ gruepr::gruepr(DataOptions &_dataOptions, QList<StudentRecord> &_students, QProg
     idealTeamSizeBox->setValue(teamingOptions->idealTeamSize);
     connect(teamSizeCriterion->idealTeamSizeBox, &QSpinBox::valueChanged, this, &gruepr::changeIdealTeamSize);
     connect(teamSizeCriterion->teamSizeBox, &QComboBox::currentIndexChanged, this, &gruepr::chooseTeamSizes);
+    connect(teamSizeCriterion->timeLimitBox, &QSpinBox::valueChanged, this, [this](const int seconds){teamingOptions->timeLimitPerSection = seconds;});
     criteriaCardsList.append(teamsizeCriteriaCard);
 
     GroupingCriteriaCard::fixedCardOffset = (dataOptions->sectionIncluded ? 1 : 0) + 1; // +1 for teamsize, always present
@@ -287,6 +290,7 @@ void gruepr::addSavedTeamsTabs()
                 numTeams = int(teams.size());
                 connect(teamTab, &TeamsTabItem::saveState, this, &gruepr::saveState);
                 connect(teamTab, &TeamsTabItem::addCriterionRequested, this, static_cast<void (gruepr::*)(Criterion::CriteriaType)>(&gruepr::addCriteriaCard));
+                connect(teamTab, &TeamsTabItem::refineTeamsRequested, this, &gruepr::refineTeamSet);
                 if(teamTab->criteriaWereMissing) {
                     tabsWithMissingCriteria << teamTab->tabName;
                 }
@@ -656,54 +660,6 @@ void gruepr::refreshCriteriaLayout(){
     layout->addStretch(1);
 }
 
-////////////////////
-// A static public wrapper for the getGenomeScore function
-// The calculated scores are updated into the .scores members of the _teams array sent to the function
-// This is a static function, and parameters are named with leading underscore to differentiate from gruepr member variables
-////////////////////
-void gruepr::calcTeamScores(const QList<StudentRecord> &_students, const long long _numStudents,
-                            TeamSet &_teams, const TeamingOptions *const _teamingOptions)
-{
-    const int _numTeams = _teams.size();
-    const auto &_dataOptions = _teams.dataOptions;
-    QList<float> teamScores(_numTeams);
-    QList<QList<float>> criteriaScores(_teamingOptions->criteria.size(), QList<float>(_numTeams));
-    QList<float> penaltyPoints(_numTeams);
-    QList<int> teamSizes(_numTeams);
-    QList<int> genome(_numStudents);
-    int ID = 0;
-    for(int teamnum = 0; teamnum < _numTeams; teamnum++) {
-        teamSizes[teamnum] = _teams[teamnum].size;
-        for(const auto studentID : std::as_const(_teams[teamnum].studentIDs)) {
-            int index = 0;
-            while(index < _students.size() && _students.at(index).ID != studentID) {
-                index++;
-            }
-            genome[ID] = index;
-            ID++;
-        }
-    }
-
-    getGenomeScore(_students.constData(), genome.data(), _numTeams, teamSizes.data(),
-                   _teamingOptions, &_dataOptions, teamScores.data(), criteriaScores, penaltyPoints);
-
-    for(int teamnum = 0; teamnum < _numTeams; teamnum++) {
-        _teams[teamnum].score = teamScores[teamnum];
-    }
-
-/*  for(int criterion = 0; criterion < _teamingOptions->realNumScoringFactors; criterion++){
-        for (int team = 0; team <_numTeams; team++){
-            const float actualScore = criteriaScores[criterion][team]/_teamingOptions->weights[criterion];
-            qDebug() << "weight from weights[]:" << _teamingOptions->weights[criterion];
-            qDebug() << "team:" << team;
-            qDebug() << "criterion:" << criterion;
-            qDebug() << "penalty:" << -penaltyPoints[criterion];
-            qDebug() << "actual score:" << actualScore;
-            qDebug() << "score:" << criteriaScores[criterion][team];
-        }
-    } */
-}
-
 QStringList gruepr::getTeamTabNames() const {
     QStringList names;
     for (int tab = 1; tab < ui->dataDisplayTabWidget->count(); tab++) {
@@ -746,19 +702,17 @@ void gruepr::changeSection(int index)
     }
 
     teamingOptions->sectionName = desiredSection;
-    if(!multipleSectionsInProgress) {
-        if(!dataOptions->sectionIncluded) {
-            teamingOptions->sectionType = TeamingOptions::SectionType::noSections;
-        }
-        else if(sectionSelectionBox->currentIndex() == 1) {
-            teamingOptions->sectionType = TeamingOptions::SectionType::allSeparately;
-        }
-        else if(sectionSelectionBox->currentIndex() == 0) {
-            teamingOptions->sectionType = TeamingOptions::SectionType::allTogether;
-        }
-        else {
-            teamingOptions->sectionType = TeamingOptions::SectionType::oneSection;
-        }
+    if(!dataOptions->sectionIncluded) {
+        teamingOptions->sectionType = TeamingOptions::SectionType::noSections;
+    }
+    else if(sectionSelectionBox->currentIndex() == 1) {
+        teamingOptions->sectionType = TeamingOptions::SectionType::allSeparately;
+    }
+    else if(sectionSelectionBox->currentIndex() == 0) {
+        teamingOptions->sectionType = TeamingOptions::SectionType::allTogether;
+    }
+    else {
+        teamingOptions->sectionType = TeamingOptions::SectionType::oneSection;
     }
 
     refreshStudentDisplay();
@@ -780,7 +734,7 @@ void gruepr::changeSection(int index)
                 if(!student.deleted &&
                    ((teamingOptions->sectionType == TeamingOptions::SectionType::allTogether) ||
                     (teamingOptions->sectionType == TeamingOptions::SectionType::noSections) ||
-                    ((teamingOptions->sectionType == TeamingOptions::SectionType::allSeparately) && !multipleSectionsInProgress) ||
+                    (teamingOptions->sectionType == TeamingOptions::SectionType::allSeparately) ||
                     (student.section == teamingOptions->sectionName))) {
                     const QString &currentStudentResponse = student.attributeResponse[attribute];
 
@@ -1366,7 +1320,7 @@ void gruepr::changeIdealTeamSize()
 
     // typically just figuring out team sizes for one section or for all students together,
     // but need to re-calculate for each section if we will team all sections independently
-    const bool calculatingSeparateSections = (teamingOptions->sectionType == TeamingOptions::SectionType::allSeparately) && !multipleSectionsInProgress;
+    const bool calculatingSeparateSections = (teamingOptions->sectionType == TeamingOptions::SectionType::allSeparately);
     const int numSectionsToCalculate = (calculatingSeparateSections? int(dataOptions->sectionNames.size()) : 1);
     long long numStudentsBeingTeamed = numActiveStudents;
     int smallerTeamsSizeA=0, smallerTeamsSizeB=0, numSmallerATeams=0, largerTeamsSizeA=0, largerTeamsSizeB=0, numLargerATeams=0;
@@ -1384,15 +1338,6 @@ void gruepr::changeIdealTeamSize()
                 }
             }
         }
-        else if(multipleSectionsInProgress) {
-            const QString sectionName = sectionSelectionBox->currentText();
-            numStudentsBeingTeamed = 0;
-            for(const auto &student : std::as_const(students)) {
-                if(student.section == sectionName && !student.deleted) {
-                    numStudentsBeingTeamed++;
-                }
-            }
-        }
         else {
             numStudentsBeingTeamed = numActiveStudents;
         }
@@ -1570,129 +1515,270 @@ void gruepr::chooseTeamSizes(int index)
 }
 
 
-void gruepr::startOptimization()
+//////////////////
+// Gather the criteria in priority order, initialize their weights based on that priority, and prepare them for the optimization
+//////////////////
+void gruepr::prepareCriteria()
 {
-    // Initialize weights based on priority then normalize all score factor weights using norm factor = number of factors / total weights of all factors
-    // First criterion has weight 10, then each subsequent criterion is 3/4 the weight of the prev. one
+    // Gather the criteria in priority order and initialize their weights based on that priority
     teamingOptions->criteria.clear();
-    float weight = 10;
-    float sumOfWeights = 0;
     for (auto *const criteriaCard : std::as_const(criteriaCardsList)){
         if (criteriaCard->criterion->criteriaType == Criterion::CriteriaType::section ||
             criteriaCard->criterion->criteriaType == Criterion::CriteriaType::teamSize) {
             continue;
         }
         teamingOptions->criteria << criteriaCard->criterion;
-        criteriaCard->criterion->weight = weight;
-        sumOfWeights += weight;
-        weight *= 0.75;
-    }
-
-    const int numCriteria = teamingOptions->criteria.size();
-    float normFactor = numCriteria / sumOfWeights;
-    if(!std::isfinite(normFactor)) {
-        normFactor = 0;
-    }
-    // convert weights to realWeights
-    for (auto *criterion : std::as_const(teamingOptions->criteria)) {
-        criterion->weight *= normFactor;
     }
+    TeamOptimizer::setCriteriaWeights(teamingOptions->criteria);
 
     // prepare the criteria for the optimization process (mostly cache pre-determined values)
     for (auto *criterion : std::as_const(teamingOptions->criteria)) {
         criterion->prepareForOptimization(students.constData(), numActiveStudents, dataOptions);
     }
+}
+
+
+void gruepr::startOptimization()
+{
+    prepareCriteria();
 
     bestTeamSet.clear();
     finalTeams.clear();
     finalTeams.dataOptions = *dataOptions;
 
-    const bool teamingMultipleSections = (teamingOptions->sectionType == TeamingOptions::SectionType::allSeparately);
-    multipleSectionsInProgress = teamingMultipleSections;
-    const int numSectionsToTeam = (teamingMultipleSections? int(dataOptions->sectionNames.size()) : 1);
-    const bool smallerTeamSizesInSelector = (teamSizeBox->currentIndex() == 0);
-    for(int section = 0; section < numSectionsToTeam; section++) {
-        if(teamingMultipleSections) {
-            // team each section one at a time by changing the section
-            sectionSelectionBox->setCurrentIndex(section + 3);  // go to the next section (index: 0 = allTogether, 1 = allSeparately, 2 = separator line, 3 = first section)
+    // when teaming each section separately, all of the sections are optimized at the same time
+    if(teamingOptions->sectionType == TeamingOptions::SectionType::allSeparately) {
+        startMultiSectionOptimization();
+        return;
+    }
+
+    // Get the indexes of non-deleted students from desired section(s) and change numStudents accordingly
+    int numStudentsInSection = 0;
+    studentIndexes.reserve(students.size());
+    for(int index = 0; index < students.size(); index++) {
+        if(!students[index].deleted &&
+            ((teamingOptions->sectionType == TeamingOptions::SectionType::allTogether) ||
+            (teamingOptions->sectionType == TeamingOptions::SectionType::noSections) ||
+            (teamingOptions->sectionName == students[index].section))) {
+            studentIndexes << index;
+            numStudentsInSection++;
         }
+    }
+    numActiveStudents = numStudentsInSection;
+    if(numActiveStudents < 4) {
+        studentIndexes.clear();
+        return;
+    }
+
+    // Create a new set of TeamRecords to hold the eventual results
+    numTeams = teamingOptions->numTeamsDesired;
+    teams.clear();
+    teams.dataOptions = *dataOptions;
+    teams.reserve(numTeams);
+    for(const auto teamSize : std::as_const(teamingOptions->teamSizesDesired)) {
+        teams.emplaceBack(&teams.dataOptions, teamSize);
+    }
+
+    // Create progress display plot
+    progressChart = new BoxWhiskerPlot("", "Generation", "Scores");
+
+    // Create window to display progress, and connect the stop optimization button in the window to the actual stopping of the optimization thread
+    progressWindow = new progressDialog("", progressChart, this);
+    progressWindow->show();
+    connect(progressWindow, &progressDialog::letsStop, this, [this] {QApplication::setOverrideCursor(QCursor(Qt::BusyCursor));
+                                                                     connect(this, &gruepr::turnOffBusyCursor, this, &QApplication::restoreOverrideCursor);
+                                                                     teamOptimizer->stop();
+                                                                    });
+
+    // Set up the optimizer, forwarding its progress, and set up futureWatcher to know when results are available
+    QList<int> teamSizes;
+    teamSizes.reserve(numTeams);
+    for(const auto &team : std::as_const(teams)) {
+        teamSizes << team.size;
+    }
+    teamOptimizer = std::make_unique<TeamOptimizer>(students, studentIndexes, teamSizes, teamingOptions, dataOptions);
+    teamOptimizer->continueUntilStopped = true;
+    teamOptimizer->timeBudget = teamingOptions->timeLimitPerSection * 1000;
+    teamOptimizer->checkpointFileName = checkpointFileName(0);
+    int checkpointGeneration = 0;
+    if(teamOptimizer->canResumeFromCheckpoint(&checkpointGeneration)) {
+        teamOptimizer->resumeFromCheckpoint = grueprGlobal::warningMessage(progressWindow, "gruepr",
+                                                                           tr("A previous optimization of these students was interrupted after ") +
+                                                                           QString::number(checkpointGeneration) + tr(" generations.") + "<br>" +
+                                                                           tr("Would you like to continue it from there?"),
+                                                                           tr("Continue it"), tr("Start over"));
+    }
+    connect(teamOptimizer.get(), &TeamOptimizer::generationComplete, this, &gruepr::generationComplete, Qt::DirectConnection);
+    connect(teamOptimizer.get(), &TeamOptimizer::finishedOptimizing, this, &gruepr::turnOffBusyCursor);
+    future = QtConcurrent::run(&TeamOptimizer::optimize, teamOptimizer.get());       // spin optimization off into a separate thread
+    futureWatcher.setFuture(future);                                // connect the watcher to get notified when optimization completes
+}
 
-        // Get the indexes of non-deleted students from desired section(s) and change numStudents accordingly
-        int numStudentsInSection = 0;
-        studentIndexes.reserve(students.size());
+
+//////////////////
+// Team each section separately, all of the sections at the same time: each section with enough students becomes an independent job,
+// with its own students, team sizes, and copy of the teaming options, and one progress window follows all of them.
+// Once every section is done, their teams are put together into one team set.
+//////////////////
+void gruepr::startMultiSectionOptimization()
+{
+    sectionsOptimizer = std::make_unique<MultiSectionOptimizer>(students, dataOptions);
+    // the team sizes of each section, calculated as in the team size box: smaller teams, unless the larger teams option is chosen (if offered)
+    const bool largerTeams = (teamSizeBox->currentIndex() == 1) && (teamSizeBox->count() != 3);
+    const int idealSize = idealTeamSizeBox->value();
+    for(int section = 0; section < dataOptions->sectionNames.size(); section++) {
+        const QString &sectionName = dataOptions->sectionNames.at(section);
+        QList<int> sectionStudentIndexes;
         for(int index = 0; index < students.size(); index++) {
-            if(!students[index].deleted &&
-                ((teamingOptions->sectionType == TeamingOptions::SectionType::allTogether) ||
-                (teamingOptions->sectionType == TeamingOptions::SectionType::noSections) ||
-                (teamingOptions->sectionName == students[index].section))) {
-                studentIndexes << index;
-                numStudentsInSection++;
+            if(!students[index].deleted && (students[index].section == sectionName)) {
+                sectionStudentIndexes << index;
             }
         }
-        numActiveStudents = numStudentsInSection;
-        if(numActiveStudents < 4) {
+        if(sectionStudentIndexes.size() < 4) {
             continue;
         }
 
-        if(teamingMultipleSections) {
-            // now pick the correct team sizes
-            if(smallerTeamSizesInSelector || (teamSizeBox->count() == 3)) {
-                teamSizeBox->setCurrentIndex(0);
-            }
-            else {
-                teamSizeBox->setCurrentIndex(1);
-            }
+        TeamingOptions sectionTeamingOptions = *teamingOptions;
+        sectionTeamingOptions.sectionName = sectionName;
+        sectionTeamingOptions.sectionType = TeamingOptions::SectionType::oneSection;
+        sectionTeamingOptions.teamSizesDesired = TeamingOptions::calculateTeamSizes(int(sectionStudentIndexes.size()), idealSize, largerTeams);
+        sectionTeamingOptions.numTeamsDesired = int(sectionTeamingOptions.teamSizesDesired.size());
+        auto &job = sectionsOptimizer->addJob(sectionStudentIndexes, sectionTeamingOptions);
+        job.optimizer->continueUntilStopped = true;
+        job.optimizer->timeBudget = teamingOptions->timeLimitPerSection * 1000;
+        job.optimizer->checkpointFileName = checkpointFileName(section);
+    }
+
+    const int numSections = int(sectionsOptimizer->jobs().size());
+    runSectionsOptimizer(tr("all ") + QString::number(numSections) + tr(" sections"));
+}
+
+
+//////////////////
+// Run all of the sectionsOptimizer's jobs, with one progress window following all of them
+//////////////////
+void gruepr::runSectionsOptimizer(const QString &progressTitle)
+{
+    if(sectionsOptimizer->jobs().empty()) {
+        sectionsOptimizer.reset();
+        return;
+    }
+
+    // Create window to display the progress of all of the jobs together, and connect its stop optimization button to stopping every job
+    progressWindow = new progressDialog(progressTitle, nullptr, this);
+    progressWindow->show();
+    connect(progressWindow, &progressDialog::letsStop, this, [this] {QApplication::setOverrideCursor(QCursor(Qt::BusyCursor));
+                                                                     connect(this, &gruepr::turnOffBusyCursor, this, &QApplication::restoreOverrideCursor);
+                                                                     sectionsOptimizer->stop();
+                                                                    });
+
+    // one question covers every section that can continue from a checkpoint
+    bool anyCheckpoints = false;
+    int maxCheckpointGeneration = 0;
+    for(const auto &job : sectionsOptimizer->jobs()) {
+        int checkpointGeneration = 0;
+        if(job->optimizer->canResumeFromCheckpoint(&checkpointGeneration)) {
+            anyCheckpoints = true;
+            maxCheckpointGeneration = std::max(maxCheckpointGeneration, checkpointGeneration);
         }
+    }
+    if(anyCheckpoints) {
+        const bool resume = grueprGlobal::warningMessage(progressWindow, "gruepr",
+                                                         tr("A previous optimization of these sections was interrupted after as many as ") +
+                                                         QString::number(maxCheckpointGeneration) + tr(" generations.") + "<br>" +
+                                                         tr("Would you like to continue it from there?"),
+                                                         tr("Continue it"), tr("Start over"));
+        for(const auto &job : sectionsOptimizer->jobs()) {
+            job->optimizer->resumeFromCheckpoint = resume;
+        }
+    }
 
-        // Create a new set of TeamRecords to hold the eventual results
-        numTeams = teamingOptions->numTeamsDesired;
-        teams.clear();
-        teams.dataOptions = *dataOptions;
-        teams.reserve(numTeams);
-        for(const auto teamSize : std::as_const(teamingOptions->teamSizesDesired)) {
-            teams.emplaceBack(&teams.dataOptions, teamSize);
+    connect(sectionsOptimizer.get(), &MultiSectionOptimizer::progressUpdated, this, &gruepr::updateMultiSectionProgress);
+    connect(sectionsOptimizer.get(), &MultiSectionOptimizer::finished, this, &gruepr::multiSectionOptimizationComplete);
+    sectionsOptimizer->start();
+}
+
+
+//////////////////
+// Optimize again, starting from an existing team set (perhaps edited by hand) instead of from random teams, keeping the pinned students on their teams.
+// The teams keep their sizes, and a team set made section by section is refined section by section, all at the same time.
+//////////////////
+void gruepr::refineTeamSet(const QList<QList<long long>> &teamIDLists, const QList<long long> &pinnedIDs, const bool separateSections)
+{
+    prepareCriteria();
+
+    bestTeamSet.clear();
+    finalTeams.clear();
+    finalTeams.dataOptions = *dataOptions;
+
+    QHash<long long, int> indexOfID;
+    for(int index = 0; index < students.size(); index++) {
+        if(!students[index].deleted) {
+            indexOfID.insert(students[index].ID, index);
         }
+    }
 
-        // Create progress display plot
-        progressChart = new BoxWhiskerPlot("", "Generation", "Scores");
-
-        // Create window to display progress, and connect the stop optimization button in the window to the actual stopping of the optimization thread
-        const QString sectionName = (teamingMultipleSections? (tr("section ") + QString::number(section + 1) + " / " + QString::number(numSectionsToTeam) + ": " +
-                                                          teamingOptions->sectionName) : "");
-        progressWindow = new progressDialog(sectionName, progressChart, this);
-        progressWindow->show();
-        connect(progressWindow, &progressDialog::letsStop, this, [this] {QApplication::setOverrideCursor(QCursor(Qt::BusyCursor));
-                                                                         connect(this, &gruepr::turnOffBusyCursor, this, &QApplication::restoreOverrideCursor);
-                                                                         optimizationStoppedmutex.lock();
-                                                                         optimizationStopped = true;
-                                                                         optimizationStoppedmutex.unlock();
-                                                                        });
-
-        // set the working value of the genetic algorithm's population size and tournament selection probability
-        ga.setGAParameters(numActiveStudents);
-
-        // Set up the flag to allow a stoppage and set up futureWatcher to know when results are available
-        optimizationStopped = false;
-        future = QtConcurrent::run(&gruepr::optimizeTeams, this, studentIndexes);       // spin optimization off into a separate thread
-        futureWatcher.setFuture(future);                                // connect the watcher to get notified when optimization completes
-        multipleSectionsInProgress = (section < (numSectionsToTeam - 1));
-
-        // hold here until the optimization is done. This feels really hacky and probably can be improved with something simple!
-        QEventLoop loop;
-        connect(this, &gruepr::sectionOptimizationFullyComplete, this, [this, &loop, teamingMultipleSections, smallerTeamSizesInSelector] {
-            if(teamingMultipleSections && !multipleSectionsInProgress) {
-                sectionSelectionBox->setCurrentIndex(1);            // go back to each section separately
-                if(smallerTeamSizesInSelector || (teamSizeBox->count() == 3)) {  // pick the correct team sizes
-                    teamSizeBox->setCurrentIndex(0);
-                }
-                else {
-                    teamSizeBox->setCurrentIndex(1);
-                }
+    // the teams, grouped by section if refining each section separately, as the students and team sizes of each optimization
+    struct TeamGroup {QString sectionName; QList<int> studentIndexes; QList<int> teamSizes;};
+    QList<TeamGroup> groups;
+    for(const auto &teamIDs : teamIDLists) {
+        QList<int> team;
+        for(const auto ID : teamIDs) {
+            const int index = indexOfID.value(ID, -1);
+            if(index != -1) {
+                team << index;
+            }
+        }
+        if(team.isEmpty()) {
+            continue;
+        }
+        const QString sectionName = separateSections? students.at(team.constFirst()).section : teamingOptions->sectionName;
+        auto group = std::find_if(groups.begin(), groups.end(), [&sectionName](const TeamGroup &group){return (group.sectionName == sectionName);});
+        if(group == groups.end()) {
+            groups.append({sectionName, {}, {}});
+            group = groups.end() - 1;
+        }
+        group->studentIndexes << team;
+        group->teamSizes << int(team.size());
+    }
+
+    // a refinement is not checkpointed: it starts from the teams instead of from anything it could continue
+    const QSet<long long> pinned(pinnedIDs.cbegin(), pinnedIDs.cend());
+    sectionsOptimizer = std::make_unique<MultiSectionOptimizer>(students, dataOptions);
+    for(const auto &group : std::as_const(groups)) {
+        if(group.studentIndexes.size() < 4) {
+            continue;
+        }
+        TeamingOptions groupTeamingOptions = *teamingOptions;
+        groupTeamingOptions.sectionName = group.sectionName;
+        if(separateSections) {
+            groupTeamingOptions.sectionType = TeamingOptions::SectionType::oneSection;
+        }
+        groupTeamingOptions.teamSizesDesired = group.teamSizes;
+        groupTeamingOptions.numTeamsDesired = int(group.teamSizes.size());
+        auto &job = sectionsOptimizer->addJob(group.studentIndexes, groupTeamingOptions);
+        job.optimizer->continueUntilStopped = true;
+        job.optimizer->timeBudget = teamingOptions->timeLimitPerSection * 1000;
+        job.optimizer->startingTeamSet = group.studentIndexes;
+        for(const auto index : group.studentIndexes) {
+            if(pinned.contains(students.at(index).ID)) {
+                job.optimizer->pinnedStudents << index;
             }
-            loop.quit();
-        }, static_cast<Qt::ConnectionType>(Qt::AutoConnection | Qt::SingleShotConnection));
-        loop.exec();
+        }
+    }
+
+    const int numGroups = int(sectionsOptimizer->jobs().size());
+    runSectionsOptimizer((numGroups > 1)? (tr("all ") + QString::number(numGroups) + tr(" sections")) : QString());
+}
+
+
+QString gruepr::checkpointFileName(const int section) const
+{
+    if(dataOptions->saveStateFileName.isEmpty()) {
+        return {};
     }
+    const QFileInfo saveFile(dataOptions->saveStateFileName);
+    return saveFile.absolutePath() + "/" + saveFile.completeBaseName() + "_checkpoint" + QString::number(section + 1) + ".grck";
 }
 
 
@@ -1700,20 +1786,20 @@ void gruepr::updateOptimizationProgress(const float *const allScores, const int
                                         const int generation, const float scoreStability, const bool unpenalizedGenomePresent)
 {
     if((generation % (BoxWhiskerPlot::PLOTFREQUENCY)) == 0) {
-        progressChart->loadNextVals(allScores, orderedIndex, ga.populationsize, unpenalizedGenomePresent);
+        progressChart->loadNextVals(allScores, orderedIndex, teamOptimizer->ga.populationsize, unpenalizedGenomePresent);
     }
 
     if(generation > GA::MAX_GENERATIONS) {
         progressWindow->setText(tr("We have reached ") + QString::number(GA::MAX_GENERATIONS) + tr(" generations."),
-                                generation, *std::max_element(allScores, allScores+ga.populationsize), true);
+                                generation, *std::max_element(allScores, allScores+teamOptimizer->ga.populationsize), true);
         progressWindow->highlightStopButton();
     }
     else if((generation >= GA::MIN_GENERATIONS) && (scoreStability > GA::MIN_SCORE_STABILITY)) {
-        progressWindow->setText(tr("Score appears to be stable!"), generation, *std::max_element(allScores, allScores+ga.populationsize), true);
+        progressWindow->setText(tr("Score appears to be stable!"), generation, *std::max_element(allScores, allScores+teamOptimizer->ga.populationsize), true);
         progressWindow->highlightStopButton();
     }
     else {
-        progressWindow->setText(tr("Please wait while your grueps are created!"), generation, *std::max_element(allScores, allScores+ga.populationsize), false);
+        progressWindow->setText(tr("Please wait while your grueps are created!"), generation, *std::max_element(allScores, allScores+teamOptimizer->ga.populationsize), false);
     }
 }
 
@@ -1724,17 +1810,61 @@ void gruepr::optimizationComplete()
     delete progressChart;
     delete progressWindow;
 
-    // Get the results
+    // Get the results, after which the optimization no longer needs its checkpoint
     bestTeamSet << future.result();
+    GACheckpoint::remove(teamOptimizer->checkpointFileName);
     finalTeams << teams;
     studentIndexes.clear();
 
-    emit sectionOptimizationFullyComplete();
+    showNewTeamSet();
+}
 
-    if(multipleSectionsInProgress) {
-        return;
+
+void gruepr::updateMultiSectionProgress()
+{
+    const auto progress = sectionsOptimizer->progress();
+    QString status = tr("Please wait while your grueps are created!");
+    if((progress.numStable > 0) && progressWindow->onlyStoppingManually()) {
+        status = tr("Scores appear to be stable in ") + QString::number(progress.numStable + progress.numFinished) + tr(" of ") +
+                 QString::number(progress.numJobs) + tr(" sections.");
+    }
+    else if(progress.numFinished > 0) {
+        status += "\n" + QString::number(progress.numFinished) + tr(" of ") + QString::number(progress.numJobs) + tr(" sections done.");
+    }
+    progressWindow->setText(status, progress.generation, progress.bestScore, false);
+
+    // unless continuing until stopped, each section ends on its own once its score is stable
+    if(!progressWindow->onlyStoppingManually()) {
+        sectionsOptimizer->stopStableJobs();
+    }
+}
+
+
+void gruepr::multiSectionOptimizationComplete()
+{
+    // update UI
+    delete progressWindow;
+    emit turnOffBusyCursor();
+
+    // Put the sections' teams together, section by section, after which their optimizations no longer need their checkpoints
+    teams.clear();
+    teams.dataOptions = *dataOptions;
+    for(const auto &job : sectionsOptimizer->jobs()) {
+        for(const auto teamSize : std::as_const(job->teamingOptions.teamSizesDesired)) {
+            teams.emplaceBack(&teams.dataOptions, teamSize);
+        }
+        bestTeamSet << job->bestTeamSet;
+        GACheckpoint::remove(job->optimizer->checkpointFileName);
     }
+    finalTeams << teams;
+    sectionsOptimizer.release()->deleteLater();     // (not deleted here, since it's the sender of this signal)
+
+    showNewTeamSet();
+}
+
 
+void gruepr::showNewTeamSet()
+{
     //alert
     QApplication::beep();
     QApplication::alert(this);
@@ -1760,7 +1890,7 @@ void gruepr::optimizationComplete()
     }
 
     // Load scores and info into the teams
-    calcTeamScores(students, numActiveStudents, teams, teamingOptions);
+    TeamOptimizer::calcTeamScores(students, teams, teamingOptions);
     for(auto &team : teams) {
         team.refreshTeamInfo(students, ScheduleCriterion::getNumBlocksForOneMeeting(teamingOptions));
     }
@@ -1787,6 +1917,7 @@ void gruepr::optimizationComplete()
     teamingOptions->teamsetNumber++;
     connect(teamTab, &TeamsTabItem::saveState, this, &gruepr::saveState);
     connect(teamTab, &TeamsTabItem::addCriterionRequested, this, static_cast<void (gruepr::*)(Criterion::CriteriaType)>(&gruepr::addCriteriaCard));
+    connect(teamTab, &TeamsTabItem::refineTeamsRequested, this, &gruepr::refineTeamSet);
     ui->dataDisplayTabWidget->setCurrentWidget(teamTab);
     saveState();
 }
@@ -2275,297 +2406,6 @@ void gruepr::refreshStudentDisplay(QProgressDialog *progressDialog, int progress
 }
 
 
-////////////////////////////////////////////
-// Create and optimize teams using genetic algorithm
-////////////////////////////////////////////
-QList<int> gruepr::optimizeTeams(QList<int> studentIndexes)
-{
-    // create and seed the pRNG (need to specifically do it here because this is happening in a new thread)
-    std::random_device randDev;
-    std::mt19937 pRNG(randDev());
-
-    // Initialize an initial generation of random teammate sets, genePool[populationSize][numStudents].
-    // Each genome in this generation stores (by permutation) which students are in which team.
-    // Array has one entry per student and lists, in order, the index of the student in the students[] array.
-    // For example, if team 1 has 4 students, and genePool[0][] = [4, 9, 12, 1, 3, 6...], then the first genome places
-    // students[] entries 4, 9, 12, and 1 on to team 1 and students[] entries 3 and 6 as the first two students on team 2.
-
-    // allocate memory for gene pools and ancestor pools (RAII — freed automatically)
-    GA::GenePool genePool(ga, numActiveStudents);
-    GA::GenePool nextGenGenePool(ga, numActiveStudents);
-    GA::AncestorPool ancestors(ga);
-    GA::AncestorPool nextGenAncestors(ga);
-
-    // array of indexes, sorted in order of score (so genePool[orderedIndex[0]] is the one with the top score)
-    auto orderedIndex = std::make_unique<int[]>(ga.populationsize);
-    for(int genome = 0; genome < ga.populationsize; genome++) {
-        orderedIndex[genome] = genome;
-    }
-
-    // create an initial population
-    // start with an array of all the student IDs in order
-    auto randPerm = std::make_unique<int[]>(numActiveStudents);
-    for(int i = 0; i < numActiveStudents; i++) {
-        randPerm[i] = studentIndexes[i];
-    }
-    // then make "populationSize" number of random permutations for the initial population, store in genePool
-    // just use random values for their initial "ancestor" values
-    std::uniform_int_distribution<unsigned int> randAncestor(0, ga.populationsize);
-    for(int genome = 0; genome < ga.populationsize; genome++) {
-        std::shuffle(randPerm.get(), randPerm.get()+numActiveStudents, pRNG);
-        auto *const thisGenome = genePool[genome];
-        for(int ID = 0; ID < numActiveStudents; ID++) {
-            thisGenome[ID] = randPerm[ID];
-        }
-        auto *const thisGenomesAncestors = ancestors[genome];
-        for(int ancestor = 0; ancestor < ancestors.numAncestors(); ancestor++) {
-            thisGenomesAncestors[ancestor] = int(randAncestor(pRNG));
-        }
-    }
-
-    QList<int> teamSizes(numTeams);
-    for(int team = 0; team < numTeams; team++) {
-        teamSizes[team] = teams[team].size;
-    }
-
-    auto worstTeam = std::make_unique<int[]>(ga.populationsize);
-    auto teamStartPositions = std::make_unique<int[]>(numTeams + 1);
-    teamStartPositions[0] = 0;
-    for(int team = 0; team < numTeams; team++) {
-        teamStartPositions[team + 1] = teamStartPositions[team] + teamSizes[team];
-    }
-
-    // calculate this first generation's scores (multi-threaded using OpenMP, preallocating one set of scoring variables per thread)
-    auto scores = std::make_unique<float[]>(ga.populationsize);
-    bool unpenalizedGenomePresent = false;
-    // make local copies of member variables to satisfy openMP's needs
-    const auto &sharedStudents = students;
-    const auto &sharedNumTeams = numTeams;
-    const auto *const sharedTeamingOptions = teamingOptions;
-    const auto *const sharedDataOptions = dataOptions;
-
-    //parallel initialization of needed variables.
-#pragma omp parallel \
-        default(none) \
-        shared(scores, sharedStudents, genePool, sharedNumTeams, teamSizes, sharedTeamingOptions, sharedDataOptions) \
-        reduction(||:unpenalizedGenomePresent)
-    {
-        QList<float> teamScores(sharedNumTeams);
-        QList<QList<float>> criteriaScores(sharedTeamingOptions->criteria.size(), QList<float>(sharedNumTeams));
-        QList<float> penaltyPoints(sharedNumTeams);
-#pragma omp for
-        for(int genome = 0; genome < ga.populationsize; genome++) {
-            scores[genome] = getGenomeScore(sharedStudents.constData(), genePool[genome], sharedNumTeams, teamSizes.data(),
-                                            sharedTeamingOptions, sharedDataOptions, teamScores.data(),
-                                            criteriaScores, penaltyPoints);
-            unpenalizedGenomePresent = unpenalizedGenomePresent || std::all_of(penaltyPoints.cbegin(), penaltyPoints.cend(), [](const int p){return p == 0;});
-        }
-    }
-
-    // get genome indexes in order of score, largest to smallest
-    std::sort(orderedIndex.get(), orderedIndex.get() + ga.populationsize,
-              [&scores](const int i, const int j){return (scores[i] > scores[j]);});
-    emit generationComplete(scores.get(), orderedIndex.get(), 0, 0, unpenalizedGenomePresent);
-
-    const int *mom=nullptr, *dad=nullptr;               // pointer to genome of mom and dad
-    float bestScores[GA::GENERATIONS_OF_STABILITY]={0};	// historical record of best score in the genome, going back generationsOfStability generations
-    float scoreStability = 0;
-    int generation = 0;
-    bool localOptimizationStopped = false;
-
-    // now optimize
-    do {        // allow user to choose to continue optimizing beyond maxGenerations or seemingly reaching stability
-        do {        // keep optimizing until reach stability or maxGenerations
-            // clone the elites in genePool into nextGenGenePool, shifting their ancestor arrays as if "self-mating"
-            for(int genome = 0; genome < GA::NUM_ELITES; genome++) {
-                ga.clone(genePool[orderedIndex[genome]], ancestors[orderedIndex[genome]], orderedIndex[genome],
-                         nextGenGenePool[genome], nextGenAncestors[genome], numActiveStudents);
-            }
-
-            // create rest of population in nextGenGenePool by mating
-            for(int genome = GA::NUM_ELITES; genome < ga.populationsize; genome++) {
-                //get a couple of parents
-                ga.tournamentSelectParents(genePool.data(), orderedIndex.get(), ancestors.data(), mom, dad, nextGenAncestors[genome], pRNG);
-
-                //mate them and put child in nextGenGenePool
-                ga.mate(mom, dad, teamStartPositions.get(), sharedNumTeams, nextGenGenePool[genome], numActiveStudents, pRNG);
-            }
-
-            // swap pointers to make nextGen's genePool and ancestors into this generation's
-            swap(genePool, nextGenGenePool);
-            swap(ancestors, nextGenAncestors);
-
-            generation++;
-
-            // calculate this generation's scores (multi-threaded using OpenMP, preallocating one set of scoring variables per thread)
-            unpenalizedGenomePresent = false;
-#pragma omp parallel \
-            default(none) \
-                shared(scores, worstTeam, sharedStudents, genePool, sharedNumTeams, teamSizes, sharedTeamingOptions, sharedDataOptions) \
-                reduction(||:unpenalizedGenomePresent)
-            {
-                QList<float> teamScores(sharedNumTeams);
-                QList<QList<float>> criteriaScores(sharedTeamingOptions->criteria.size(), QList<float>(sharedNumTeams));
-                QList<float> penaltyPoints(sharedNumTeams);
-#pragma omp for
-                for(int genome = 0; genome < ga.populationsize; genome++) {
-                    scores[genome] = getGenomeScore(sharedStudents.constData(), genePool[genome], sharedNumTeams, teamSizes.data(),
-                                                    sharedTeamingOptions, sharedDataOptions, teamScores.data(),
-                                                    criteriaScores, penaltyPoints);
-                    // find this genome's worst team
-                    int worst = 0;
-                    for(int team = 1; team < sharedNumTeams; team++) {
-                        if(teamScores[team] < teamScores[worst]) {
-                            worst = team;
-                        }
-                    }
-                    worstTeam[genome] = worst;
-                    unpenalizedGenomePresent = unpenalizedGenomePresent ||
-                                               std::all_of(penaltyPoints.cbegin(), penaltyPoints.cend(), [](const int p){return p == 0;});
-                }
-            }
-
-            // get genome indexes in order of score, largest to smallest
-            std::sort(orderedIndex.get(), orderedIndex.get() + ga.populationsize,
-                      [&scores](const int i, const int j){return (scores[i] > scores[j]);});
-
-            // mutate all but the single top-scoring genome with some probability
-            std::uniform_int_distribution<unsigned int> randProbability(1, 100);
-            for(int genome = 0; genome < ga.populationsize; genome++) {
-                if(genome == orderedIndex[0]) {
-                    continue;
-                }
-                while(randProbability(pRNG) < ga.mutationlikelihood) {
-                    ga.mutateWorstTeam(genePool[genome], teamStartPositions.get(), worstTeam[genome], numActiveStudents, pRNG);
-                }
-            }
-
-            // determine best score, save in historical record, and calculate score stability
-            const float maxScoreInThisGeneration = scores[orderedIndex[0]];
-            const float maxScoreFromGenerationsAgo = bestScores[(generation+1) % (GA::GENERATIONS_OF_STABILITY)];
-            bestScores[generation % (GA::GENERATIONS_OF_STABILITY)] = maxScoreInThisGeneration;	//best scores from most recent generationsOfStability, wrapping storage location
-
-            if(maxScoreInThisGeneration == maxScoreFromGenerationsAgo) {
-                scoreStability = maxScoreInThisGeneration / 0.0001F;
-            }
-            else {
-                scoreStability = maxScoreInThisGeneration / (maxScoreInThisGeneration - maxScoreFromGenerationsAgo);
-            }
-            emit generationComplete(scores.get(), orderedIndex.get(), generation, scoreStability, unpenalizedGenomePresent);
-
-            optimizationStoppedmutex.lock();
-            localOptimizationStopped = optimizationStopped;
-            optimizationStoppedmutex.unlock();
-        }
-        while(!localOptimizationStopped && ((generation < GA::MIN_GENERATIONS) ||
-                                            ((generation < GA::MAX_GENERATIONS) && (scoreStability < GA::MIN_SCORE_STABILITY))));
-
-        if(localOptimizationStopped || teamingOptions->criteria.empty()) { //if no criteria to group by, return immediately
-            keepOptimizing = false;
-            emit turnOffBusyCursor();
-        }
-        else {
-            keepOptimizing = true;
-        }
-    }
-    while(keepOptimizing);
-
-    finalGeneration = generation;
-    teamSetScore = bestScores[generation % (GA::GENERATIONS_OF_STABILITY)];
-
-    //copy best team set into a QList to return
-    QList<int> bestTeamSet;
-    bestTeamSet.reserve(numActiveStudents);
-    const auto &bestGenome = genePool[orderedIndex[0]];
-    for(int ID = 0; ID < numActiveStudents; ID++) {
-        bestTeamSet << bestGenome[ID];
-    }
-
-    return bestTeamSet;
-}
-
-
-//////////////////
-// Calculate score for one teamset (one genome)
-// Returns the total net score (which is, typically, the harmonic mean of all team scores)
-// Modifies the teamScores[] to give scores for each individual team in the genome, too
-// This is a static function, and parameters are named with leading underscore to differentiate from gruepr member variables
-//////////////////
-float gruepr::getGenomeScore(const StudentRecord *const _students, const int _teammates[], const int _numTeams, const int _teamSizes[],
-                             const TeamingOptions *const _teamingOptions, const DataOptions *const _dataOptions, float _teamScores[],
-                             QList<QList<float>> &_criteriaScores, QList<float> &_penaltyPoints)
-{
-    // Initialize each component and team score
-    for(auto &penalty : _penaltyPoints) {
-        penalty = 0;
-    }
-    for(auto &criteria : _criteriaScores) {
-        for(auto &score : criteria) {
-            score = 0;
-        }
-    }
-    for(int team = 0; team < _numTeams; team++) {
-        _teamScores[team] = 0;
-    }
-
-    for (int criterion = 0; criterion < _teamingOptions->criteria.size(); criterion++) {
-        _teamingOptions->criteria[criterion]->calculateScore(_students, _teammates, _numTeams, _teamSizes,
-                                                             _teamingOptions, _dataOptions, _criteriaScores[criterion], _penaltyPoints);
-    }
-
-    // Bring together for a final score for each team:
-    // Score is normalized to be out of 100 (but with possible "extra credit" for more than criterion match)
-    for(int team = 0; team < _numTeams; team++) {
-        for(int criterion = 0; criterion < _teamingOptions->criteria.size(); criterion++) {
-            // remove any criterion's "extra credit" (score > weight) if **any** penalties are being applied,
-            // so that very high extra credit doesn't cancel out the penalty
-            if(_criteriaScores[criterion][team] > _teamingOptions->criteria[criterion]->weight &&
-                _penaltyPoints[team] > 0) {
-                _teamScores[team] += _teamingOptions->criteria[criterion]->weight;
-            }
-            else {
-                _teamScores[team] += _criteriaScores[criterion][team];
-            }
-        }
-
-        if(_penaltyPoints[team] > 0) {
-            _penaltyPoints[team] = std::max(_penaltyPoints[team], MINIMUM_PENALTY);
-        }
-        _teamScores[team] = 100 * ((_teamScores[team] / float(_teamingOptions->criteria.size())) - _penaltyPoints[team]);
-    }
-
-    // Finally, bring all team scores together for a total genome score.
-    // Use the harmonic mean, the inverse of the average of the inverses, so score is skewed towards the smaller members.
-    // This makes it so we optimize for better values of the worse teams rather than run-away best teams.
-    // Very poor teams have 0 or negative scores, and this makes the harmonic mean impossible to calculate.
-    // Thus, if any teamScore is <= 0, we instead use the arithmetic mean punished by reducing towards negative infinity by half the arithmetic mean.
-    float harmonicSum = 0, regularSum = 0;
-    int numTeamsScored = 0;
-    bool allTeamsPositive = true;
-    for(int team = 0; team < _numTeams; team++) {
-        //ignore unpenalized teams of one since their score of 0 is not meaningful
-        if(_teamSizes[team] == 1 && _teamScores[team] == 0) {
-            continue;
-        }
-        numTeamsScored++;
-        regularSum += _teamScores[team];
-
-        if(_teamScores[team] <= 0) {
-            allTeamsPositive = false;
-        }
-        else {
-            harmonicSum += 1/_teamScores[team];
-        }
-    }
-
-    if(allTeamsPositive) {
-        return(float(numTeamsScored)/harmonicSum);      //harmonic mean
-    }
-
-    const float mean = regularSum / float(numTeamsScored);
-    return(mean - (std::abs(mean)/2));   //"punished" arithmetic mean
-}
-
 void gruepr::closeEvent(QCloseEvent *event)
 {
     QSettings savedSettings;
@@ -4,7 +4,9 @@
 #include "csvfile.h"
 #include "dataOptions.h"
 #include "gruepr_globals.h"
+#include "multiSectionOptimizer.h"
 #include "studentRecord.h"
+#include "teamOptimizer.h"
 #include "teamRecord.h"
 #include "teamingOptions.h"
 #include "dialogs/progressDialog.h"
@@ -12,6 +14,7 @@
 #include "widgets/boxwhiskerplot.h"
 #include "widgets/groupingCriteriaCardWidget.h"
 #include "widgets/styledComboBox.h"
+#include <memory>
 #include <QFuture>
 #include <QFutureWatcher>
 #include <QMainWindow>
@@ -37,9 +40,6 @@ public:
     gruepr(gruepr&&) = delete;
     gruepr& operator= (gruepr&&) = delete;
 
-    static void calcTeamScores(const QList<StudentRecord> &_students, const long long _numStudents,
-                               TeamSet &_teams, const TeamingOptions *const _teamingOptions);
-
     QList<StudentRecord> students;
     DataOptions *dataOptions = nullptr;
 
@@ -51,7 +51,6 @@ signals:
     void closed();
     void generationComplete(const float *const allScores, const int *const orderedIndex,
                             const int generation, const float scoreStability, const bool unpenalizedGenomePresent);
-    void sectionOptimizationFullyComplete();
     void turnOffBusyCursor();
 
 public slots:
@@ -83,6 +82,9 @@ private slots:
     void updateOptimizationProgress(const float *const allScores, const int *const orderedIndex,
                                     const int generation, const float scoreStability, const bool unpenalizedGenomePresent);
     void optimizationComplete();
+    void updateMultiSectionProgress();
+    void multiSectionOptimizationComplete();
+    void refineTeamSet(const QList<QList<long long>> &teamIDLists, const QList<long long> &pinnedIDs, bool separateSections);
     void dataDisplayTabClose(int closingTabIndex);
     void editDataDisplayTabName(int tabIndex);
 
@@ -107,28 +109,22 @@ private:
         // team set optimization
     QPushButton *letsDoItButton = nullptr;
     QList<int> studentIndexes;                                    // the indexes of students to be placed on teams
-    QList<int> optimizeTeams(const QList<int> studentIndexes);    // return value is a single permutation-of-indexes
+    std::unique_ptr<TeamOptimizer> teamOptimizer;                 // runs the genetic algorithm optimization of the current section
     QFuture< QList<int> > future;                                 // needed so that optimization can happen in a separate thread
     QFutureWatcher< QList<int> > futureWatcher;                   // used for signaling of optimization completion
     BoxWhiskerPlot *progressChart = nullptr;
     progressDialog *progressWindow = nullptr;
-    GA ga;                                                        // class for genetic algorithm optimization
-    static float getGenomeScore(const StudentRecord *const _students, const int _teammates[], const int _numTeams, const int _teamSizes[],
-                                const TeamingOptions *const _teamingOptions, const DataOptions *const _dataOptions, float _teamScores[],
-                                QList<QList<float> > &_criteriaScores, QList<float> &_penaltyPoints);
-
-    float teamSetScore = 0;
-    int finalGeneration = 1;
-    QMutex optimizationStoppedmutex;
-    bool multipleSectionsInProgress = false;
-    bool optimizationStopped = false;
-    bool keepOptimizing = false;
-    inline const static float MINIMUM_PENALTY = 1.01f;            // ensures that even the smallest penalty to a team makes that team have negative score
+    std::unique_ptr<MultiSectionOptimizer> sectionsOptimizer;     // runs the optimizations of all sections at once, when teaming each section separately
+    void prepareCriteria();
+    void startMultiSectionOptimization();
+    void runSectionsOptimizer(const QString &progressTitle);
+    QString checkpointFileName(int section) const;                // where the optimization of a section saves its checkpoints, next to the save file
 
         // reporting results
     TeamSet teams;
     QList<int> bestTeamSet;
     TeamSet finalTeams;
+    void showNewTeamSet();
 
 
         //Criteria Cards
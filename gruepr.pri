@@ -0,0 +1,208 @@
+# Settings and sources shared by every executable built from the gruepr code base
+# (the gruepr app itself, and the headless command-line and benchmark tools in subdirectories).
+# Each including .pro file must define gruepr_version and copyright_year before including this file.
+
+QT += core gui widgets concurrent network printsupport networkauth designer
+
+INCLUDEPATH += $$PWD
+
+DEFINES += GRUEPR_VERSION_NUMBER='\\"$$gruepr_version\\"'
+DEFINES += GRUEPR_COPYRIGHT_YEAR='\\"$$copyright_year\\"'
+DEFINES += NUMBER_VERSION_FIELDS=4  # Allowing for version numbers 4 levels deep (i.e., 0.0.0.0)
+DEFINES += NUMBER_VERSION_PRECISION=100 # Allowing for version values up to but not including 100 (i.e., 0.0.0.0 -> 99.99.99.99)
+
+DEFINES += VERSION_CHECK_URL='\\"https://api.github.com/repos/gruepr/gruepr/releases/latest\\"'
+DEFINES += USER_REGISTRATION_URL='\\"https://script.google.com/macros/s/AKfycbzuMivfe02aRIf6hLJQAuhAvaunOOmAK8RAaUyySFOBOKYI9LXNemFbt_uMrunoNVmq/exec\\"'
+DEFINES += GRUEPRHOMEPAGE='\\"gruepr.com\\"'
+DEFINES += GRUEPRDOWNLOADSUBPAGE='\\"Download\\"'   # Need to add hash between homepage and this, but cannot include "#" in the define here
+DEFINES += BUGREPORTPAGE='\\"https://github.com/gruepr/gruepr/issues\\"'
+DEFINES += GRUEPRHELPEMAIL='\\"info@gruepr.com\\"'
+
+# Secrets - CI or local, whichever exists
+exists($$PWD/ci_secrets.pri): include($$PWD/ci_secrets.pri)
+exists($$PWD/local_secrets.pri): include($$PWD/local_secrets.pri)
+
+DEFINES += QT_DISABLE_DEPRECATED_UP_TO=0x060500
+
+CONFIG += c++20
+
+# remove possible other optimization flags
+QMAKE_CXXFLAGS -= -O
+QMAKE_CXXFLAGS -= -O1
+QMAKE_CXXFLAGS -= -O3
+QMAKE_CXXFLAGS -= -Os
+# add the desired -O2 if not present
+QMAKE_CXXFLAGS += -O2
+
+# add OpenMP
+win32: QMAKE_CXXFLAGS += -openmp
+macx {
+    isEmpty(OMP_PREFIX) {
+        OMP_PREFIX = $$system(brew --prefix libomp)
+    }
+    QMAKE_CXXFLAGS += -Xclang -fopenmp
+    INCLUDEPATH += $$OMP_PREFIX/include
+    LIBS += -L$$OMP_PREFIX/lib -lomp
+}
+linux {
+    QMAKE_CXXFLAGS += -fopenmp
+    QMAKE_LFLAGS += -fopenmp
+}
+
+# Run TSan:
+# macx: QMAKE_CXXFLAGS += -fsanitize=thread -fno-omit-frame-pointer
+# macx: QMAKE_LFLAGS += -fsanitize=thread
+# Run ASan:
+# macx: QMAKE_CXXFLAGS += -fsanitize=address,undefined -g -fno-omit-frame-pointer
+# macx: QMAKE_LFLAGS += -fsanitize=address,undefined
+# Run leaks:
+# macx: QMAKE_CXXFLAGS += -g
+# stop compilation for dangling references
+# macx: QMAKE_CXXFLAGS += -Wdangling -Werror=dangling
+
+
+SOURCES += \
+        $$PWD/criteria/assignmentPreferenceCriterion.cpp \
+        $$PWD/criteria/attributeCriterion.cpp \
+        $$PWD/criteria/criterion.cpp \
+        $$PWD/criteria/genderCriterion.cpp \
+        $$PWD/criteria/scheduleCriterion.cpp \
+        $$PWD/criteria/sectionCriterion.cpp \
+        $$PWD/criteria/teammatesCriterion.cpp \
+        $$PWD/criteria/teamsizeCriterion.cpp \
+        $$PWD/criteria/URMIdentityCriterion.cpp \
+        $$PWD/dialogs/attributeRulesDialog.cpp \
+        $$PWD/dialogs/baseTimeZoneDialog.cpp \
+        $$PWD/dialogs/categorizingDialog.cpp \
+        $$PWD/dialogs/customResponseOptionsDialog.cpp \
+        $$PWD/dialogs/customTeamnamesDialog.cpp \
+        $$PWD/dialogs/customTeamsizesDialog.cpp \
+        $$PWD/dialogs/dataTypesTableDialog.cpp \
+        $$PWD/dialogs/dayNamesDialog.cpp \
+        $$PWD/dialogs/editOrAddStudentDialog.cpp \
+        $$PWD/dialogs/editSectionNamesDialog.cpp \
+        $$PWD/dialogs/findMatchingNameDialog.cpp \
+        $$PWD/dialogs/identityRulesDialog.cpp \
+        $$PWD/dialogs/listTableDialog.cpp \
+        $$PWD/dialogs/loadDataDialog.cpp \
+        $$PWD/dialogs/progressDialog.cpp \
+        $$PWD/dialogs/refineTeamsDialog.cpp \
+        $$PWD/dialogs/registerDialog.cpp \
+        $$PWD/dialogs/sampleQuestionsDialog.cpp \
+        $$PWD/dialogs/startDialog.cpp \
+        $$PWD/dialogs/teammatesRulesDialog.cpp \
+        $$PWD/dialogs/whichFilesDialog.cpp \
+        $$PWD/LMS/LMS.cpp \
+        $$PWD/LMS/canvashandler.cpp \
+        $$PWD/LMS/googlehandler.cpp \
+        $$PWD/widgets/attributeWidget.cpp \
+        $$PWD/widgets/boxwhiskerplot.cpp \
+        $$PWD/widgets/checkableComboBox.cpp \
+        $$PWD/widgets/comboBoxWithElidedContents.cpp \
+        $$PWD/widgets/dropcsvframe.cpp \
+        $$PWD/widgets/frameThatForwardsMouseClicks.cpp \
+        $$PWD/widgets/groupingCriteriaCardWidget.cpp \
+        $$PWD/widgets/labelThatForwardsMouseClicks.cpp \
+        $$PWD/widgets/labelWithInstantTooltip.cpp \
+        $$PWD/widgets/sortableTableWidgetItem.cpp \
+        $$PWD/widgets/studentTableWidget.cpp \
+        $$PWD/widgets/surveyMakerQuestion.cpp \
+        $$PWD/widgets/switchButton.cpp \
+        $$PWD/widgets/teamsTabItem.cpp \
+        $$PWD/widgets/teamTreeWidget.cpp \
+        $$PWD/csvfile.cpp \
+        $$PWD/dataOptions.cpp \
+        $$PWD/GA.cpp \
+        $$PWD/gaCheckpoint.cpp \
+        $$PWD/greedySeeder.cpp \
+        $$PWD/gruepr.cpp \
+        $$PWD/gruepr_globals.cpp \
+        $$PWD/Levenshtein.cpp \
+        $$PWD/multiSectionOptimizer.cpp \
+        $$PWD/studentRecord.cpp \
+        $$PWD/studentSnapshot.cpp \
+        $$PWD/surveyMakerWizard.cpp \
+        $$PWD/surveyReader.cpp \
+        $$PWD/teamingOptions.cpp \
+        $$PWD/teamRecord.cpp \
+        $$PWD/teamOptimizer.cpp
+
+HEADERS += \
+        $$PWD/criteria/assignmentPreferenceCriterion.h \
+        $$PWD/criteria/attributeCriterion.h \
+        $$PWD/criteria/criterion.h \
+        $$PWD/criteria/genderCriterion.h \
+        $$PWD/criteria/scheduleCriterion.h \
+        $$PWD/criteria/sectionCriterion.h \
+        $$PWD/criteria/teammatesCriterion.h \
+        $$PWD/criteria/teamsizeCriterion.h \
+        $$PWD/criteria/URMIdentityCriterion.h \
+        $$PWD/dialogs/attributeRulesDialog.h \
+        $$PWD/dialogs/baseTimeZoneDialog.h \
+        $$PWD/dialogs/categorizingDialog.h \
+        $$PWD/dialogs/customResponseOptionsDialog.h \
+        $$PWD/dialogs/customTeamnamesDialog.h \
+        $$PWD/dialogs/customTeamsizesDialog.h \
+        $$PWD/dialogs/dataTypesTableDialog.h \
+        $$PWD/dialogs/dayNamesDialog.h \
+        $$PWD/dialogs/editOrAddStudentDialog.h \
+        $$PWD/dialogs/editSectionNamesDialog.h \
+        $$PWD/dialogs/findMatchingNameDialog.h \
+        $$PWD/dialogs/identityRulesDialog.h \
+        $$PWD/dialogs/listTableDialog.h \
+        $$PWD/dialogs/loadDataDialog.h \
+        $$PWD/dialogs/progressDialog.h \
+        $$PWD/dialogs/refineTeamsDialog.h \
+        $$PWD/dialogs/registerDialog.h \
+        $$PWD/dialogs/sampleQuestionsDialog.h \
+        $$PWD/dialogs/startDialog.h \
+        $$PWD/dialogs/teammatesRulesDialog.h \
+        $$PWD/dialogs/whichFilesDialog.h \
+        $$PWD/LMS/LMS.h \
+        $$PWD/LMS/canvashandler.h \
+        $$PWD/LMS/googlehandler.h \
+        $$PWD/widgets/attributeWidget.h \
+        $$PWD/widgets/boxwhiskerplot.h \
+        $$PWD/widgets/checkableComboBox.h \
+        $$PWD/widgets/comboBoxWithElidedContents.h \
+        $$PWD/widgets/dropcsvframe.h \
+        $$PWD/widgets/frameThatForwardsMouseClicks.h \
+        $$PWD/widgets/groupingCriteriaCardWidget.h \
+        $$PWD/widgets/labelThatForwardsMouseClicks.h \
+        $$PWD/widgets/labelWithInstantTooltip.h \
+        $$PWD/widgets/sortableTableWidgetItem.h \
+        $$PWD/widgets/studentTableWidget.h \
+        $$PWD/widgets/styledComboBox.h \
+        $$PWD/widgets/surveyMakerQuestion.h \
+        $$PWD/widgets/switchButton.h \
+        $$PWD/widgets/teamsTabItem.h \
+        $$PWD/widgets/teamTreeWidget.h \
+        $$PWD/widgets/verticalspinboxstyle.h \
+        $$PWD/csvfile.h \
+        $$PWD/dataOptions.h \
+        $$PWD/GA.h \
+        $$PWD/gaCheckpoint.h \
+        $$PWD/greedySeeder.h \
+        $$PWD/gruepr.h \
+        $$PWD/gruepr_globals.h \
+        $$PWD/Levenshtein.h \
+        $$PWD/multiSectionOptimizer.h \
+        $$PWD/studentRecord.h \
+        $$PWD/studentSnapshot.h \
+        $$PWD/survey.h \
+        $$PWD/surveyMakerWizard.h \
+        $$PWD/surveyReader.h \
+        $$PWD/teamingOptions.h \
+        $$PWD/teamRecord.h \
+        $$PWD/teamOptimizer.h
+
+FORMS += \
+        $$PWD/dialogs/attributeRulesDialog.ui \
+        $$PWD/dialogs/loadDataDialog.ui \
+        $$PWD/dialogs/sampleQuestionsDialog.ui \
+        $$PWD/dialogs/teammatesRulesDialog.ui \
+        $$PWD/dialogs/whichFilesDialog.ui \
+        $$PWD/gruepr.ui
+
+RESOURCES += \
+        $$PWD/gruepr.qrc
@@ -32,6 +32,29 @@
 //    All fonts are licensed under SIL OPEN FONT LICENSE V1.1.
 /////////////////////////////////////////////////////////////////////////////////////////////////////////
 // DONE:
+//  - added gruepr-cli, a command-line tool to form teams from a survey file or saved work without the gruepr window
+//  - faster optimization: scoring a team set reuses preallocated memory instead of allocating for every genome
+//  - faster optimization: teams are scored from a compact copy of the student data made once before optimizing
+//  - faster optimization: meeting times are counted many time blocks at once, which matters most for schedules with 15-minute resolution
+//  - faster optimization: each generation, only the teams that changed from their parent team set are rescored
+//  - much faster optimization with the assignment preference criterion: each new team set's assignment starts from its parent's
+//  - larger classes: up to 10,000 students can be teamed at once, with each generation's time and memory growing roughly linearly with class size
+//  - island-model optimization (in gruepr-cli): the genepool can be split into islands that breed in parallel and periodically exchange their best team sets
+//  - faster optimization: each generation's new team sets are bred on all processor cores, with the same results no matter how many there are
+//  - faster optimization: a team set that was already scored, even with its teams or teammates in a different order, is not scored again
+//  - faster optimization: a team that was already scored, in any team set and any generation, is not scored again (unless a criterion compares teams to each other)
+//  - faster optimization: each generation's genomes are ranked by score with a radix sort, on all threads when there is a single population
+//  - optional local search in the optimization, improving the top team sets each generation by swapping students between teams
+//  - optional time limit for the optimization of each section, with the population sized from a measurement of the scoring speed
+//  - long optimizations periodically save a checkpoint in the background, so that an interrupted optimization can be continued
+//  - when teaming each section separately, all of the sections are optimized at the same time, sharing the processor's threads
+//  - a team set, including one edited by hand, can be refined: optimized again starting from those teams, optionally keeping chosen students or teams in place
+//  - when there are teammates rules or penalized identity rules, half of the initial population is built greedily to follow them
+//  - faster optimization: gender and racial/ethnic identity rules are checked with precomputed tables instead of comparing text for every team
+//  - faster optimization: required and prevented teammates are checked with a precomputed matrix of student pairs, even when every past teammate is prevented
+//  - faster optimization: multiple choice attribute responses are tallied in a count for each response instead of sorted for every team
+//  - faster optimization: each team is scored on all of the criteria in turn, while its students' data is still in cache
+//  - faster optimization: teams of 2 to 8 students are scored with versions of the scoring compiled for that team size
 //
 // TO DO:
 //
@@ -49,12 +72,6 @@
 //  - enable in Google Forms various options -- must wait on new API functionality from Google
 //      - Form options: don't collect email, don't limit one response per user, don't show link to respond again
 //      - Question options: req'd question, answer validity checks (for email & numerical input questions)
-//
-//    WAYS THAT MIGHT IMPROVE THE GENETIC ALGORITHM IN FUTURE:
-//  - use multiple genepools with limited cross-breeding
-//  - to get around the redundancy-of-genome issue, sort indexes w/in each team  and then each teams w/in the genome
-//      - alternatively, store each genome as std::set< std::set< int > >, but that adds to data overhead
-//      - could also store genepool as std::set < genome >, sorted by score
 /////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "gruepr_globals.h"
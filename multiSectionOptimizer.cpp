@@ -0,0 +1,138 @@
+#include "multiSectionOptimizer.h"
+#include "GA.h"
+#include <QThread>
+#include <QtConcurrentRun>
+#include <algorithm>
+
+MultiSectionOptimizer::MultiSectionOptimizer(const QList<StudentRecord> &students, const DataOptions *const dataOptions, QObject *parent) :
+    QObject(parent),
+    students(students),
+    dataOptions(dataOptions)
+{
+    progressTimer.setInterval(PROGRESS_INTERVAL);
+    connect(&progressTimer, &QTimer::timeout, this, &MultiSectionOptimizer::progressUpdated);
+}
+
+MultiSectionOptimizer::~MultiSectionOptimizer()
+{
+    // the jobs' optimizers can't be deleted while they're still running
+    stop();
+    threadPool.waitForDone();
+}
+
+
+MultiSectionOptimizer::Job &MultiSectionOptimizer::addJob(const QList<int> &studentIndexes, const TeamingOptions &sectionTeamingOptions)
+{
+    auto job = std::make_unique<Job>();
+    job->teamingOptions = sectionTeamingOptions;
+    job->studentIndexes = studentIndexes;
+    job->optimizer = std::make_unique<TeamOptimizer>(students, job->studentIndexes, job->teamingOptions.teamSizesDesired, &job->teamingOptions, dataOptions);
+
+    Job *const jobPtr = job.get();
+    connect(jobPtr->optimizer.get(), &TeamOptimizer::generationComplete, this,
+            [this, jobPtr](const float *const allScores, const int *const orderedIndex, const int generation, const float scoreStability, const bool) {
+                progressMutex.lock();
+                jobPtr->generation = generation;
+                jobPtr->bestScore = allScores[orderedIndex[0]];
+                jobPtr->stable = (generation > GA::MAX_GENERATIONS) || ((generation >= GA::MIN_GENERATIONS) && (scoreStability > GA::MIN_SCORE_STABILITY));
+                progressMutex.unlock();
+            }, Qt::DirectConnection);
+    connect(&jobPtr->futureWatcher, &QFutureWatcher< QList<int> >::finished, this, [this, jobPtr] {jobFinished(jobPtr);});
+
+    allJobs.push_back(std::move(job));
+    return *jobPtr;
+}
+
+
+//////////////////
+// Start every job. As many run at once as there are processor threads, each with an equal share of the threads for its own parallel work,
+// with the largest sections started first so that a large section started last doesn't hold up the end.
+//////////////////
+void MultiSectionOptimizer::start()
+{
+    const int numJobs = int(allJobs.size());
+    if(numJobs == 0) {
+        emit finished();
+        return;
+    }
+
+    const int numProcessorThreads = std::max(1, QThread::idealThreadCount());
+    const int numConcurrentJobs = std::min(numJobs, numProcessorThreads);
+    threadPool.setMaxThreadCount(numConcurrentJobs);
+
+    std::vector<Job*> jobsBySize;
+    jobsBySize.reserve(numJobs);
+    for(const auto &job : allJobs) {
+        job->optimizer->numThreads = std::max(1, numProcessorThreads / numConcurrentJobs);
+        jobsBySize.push_back(job.get());
+    }
+    std::stable_sort(jobsBySize.begin(), jobsBySize.end(), [](const Job *const a, const Job *const b)
+                                                            {return a->studentIndexes.size() > b->studentIndexes.size();});
+
+    progressTimer.start();
+    for(auto *const job : jobsBySize) {
+        job->futureWatcher.setFuture(QtConcurrent::run(&threadPool, &TeamOptimizer::optimize, job->optimizer.get()));
+    }
+}
+
+void MultiSectionOptimizer::stop()
+{
+    for(const auto &job : allJobs) {
+        job->optimizer->stop();
+    }
+}
+
+void MultiSectionOptimizer::stopStableJobs()
+{
+    progressMutex.lock();
+    for(const auto &job : allJobs) {
+        if(job->stable && !job->finished) {
+            job->optimizer->stop();
+        }
+    }
+    progressMutex.unlock();
+}
+
+
+MultiSectionOptimizer::Progress MultiSectionOptimizer::progress()
+{
+    Progress progress;
+    progressMutex.lock();
+    progress.numJobs = int(allJobs.size());
+    progress.numFinished = numFinished;
+    bool anyRunning = false;
+    bool anyScored = false;
+    for(const auto &job : allJobs) {
+        if(!job->finished) {
+            if(job->stable) {
+                progress.numStable++;
+            }
+            progress.generation = anyRunning? std::min(progress.generation, job->generation) : job->generation;
+            anyRunning = true;
+        }
+        if(job->generation > 0) {
+            progress.bestScore = anyScored? std::min(progress.bestScore, job->bestScore) : job->bestScore;
+            anyScored = true;
+        }
+    }
+    progressMutex.unlock();
+    return progress;
+}
+
+
+void MultiSectionOptimizer::jobFinished(Job *const job)
+{
+    job->bestTeamSet = job->futureWatcher.result();
+
+    progressMutex.lock();
+    job->finished = true;
+    numFinished++;
+    const bool allFinished = (numFinished == int(allJobs.size()));
+    progressMutex.unlock();
+
+    if(allFinished) {
+        progressTimer.stop();
+        emit progressUpdated();
+        emit finished();
+    }
+}
@@ -0,0 +1,83 @@
+#ifndef MULTISECTIONOPTIMIZER_H
+#define MULTISECTIONOPTIMIZER_H
+
+// The optimization of every section's teams at the same time, for when each section is teamed separately.
+// Each section is an independent job--its own students, team sizes, and copy of the teaming options, optimized by its own TeamOptimizer--
+// and the jobs all run at once on one pool of threads, sharing out the processor's threads, rather than one section after another.
+
+#include "dataOptions.h"
+#include "studentRecord.h"
+#include "teamOptimizer.h"
+#include "teamingOptions.h"
+#include <QFutureWatcher>
+#include <QList>
+#include <QMutex>
+#include <QObject>
+#include <QThreadPool>
+#include <QTimer>
+#include <memory>
+#include <vector>
+
+class MultiSectionOptimizer : public QObject
+{
+    Q_OBJECT
+
+public:
+    MultiSectionOptimizer(const QList<StudentRecord> &students, const DataOptions *const dataOptions, QObject *parent = nullptr);
+    ~MultiSectionOptimizer() override;
+    MultiSectionOptimizer(const MultiSectionOptimizer&) = delete;
+    MultiSectionOptimizer operator= (const MultiSectionOptimizer&) = delete;
+    MultiSectionOptimizer(MultiSectionOptimizer&&) = delete;
+    MultiSectionOptimizer& operator= (MultiSectionOptimizer&&) = delete;
+
+    struct Job
+    {
+        TeamingOptions teamingOptions;                  // this section's own copy, with its section name and team sizes
+        QList<int> studentIndexes;
+        std::unique_ptr<TeamOptimizer> optimizer;
+        QFutureWatcher< QList<int> > futureWatcher;
+        QList<int> bestTeamSet;                         // the result, once finished
+
+        // the progress, updated by the optimization's thread after each generation (guarded by progressMutex)
+        int generation = 0;
+        float bestScore = 0;
+        bool stable = false;                            // the score has become stable, or the maximum number of generations has been reached
+        bool finished = false;
+    };
+
+    // returns the new job, whose optimizer can be further set up before start()
+    Job &addJob(const QList<int> &studentIndexes, const TeamingOptions &sectionTeamingOptions);
+    const std::vector<std::unique_ptr<Job>> &jobs() const {return allJobs;}
+
+    void start();
+    void stop();                    // every job ends after the generation currently being created
+    void stopStableJobs();          // only the jobs that have become stable end
+
+    struct Progress
+    {
+        int numJobs = 0;
+        int numFinished = 0;
+        int numStable = 0;          // stable jobs that haven't yet finished
+        int generation = 0;         // the fewest generations of the jobs still running
+        float bestScore = 0;        // the lowest of the jobs' best scores
+    };
+    Progress progress();            // thread-safe
+
+signals:
+    void progressUpdated();         // periodically, while the jobs are running
+    void finished();                // once every job has finished
+
+private:
+    void jobFinished(Job *const job);
+
+    const QList<StudentRecord> &students;
+    const DataOptions *const dataOptions;
+    QMutex progressMutex;
+    std::vector<std::unique_ptr<Job>> allJobs;
+    int numFinished = 0;
+    QThreadPool threadPool;         // runs the jobs, as many at once as there are processor threads; each job then gets its share of the threads
+    QTimer progressTimer;
+    inline static const int PROGRESS_INTERVAL = 250;    // ms between progressUpdated signals
+};
+
+#endif // MULTISECTIONOPTIMIZER_H
@@ -0,0 +1,161 @@
+#include "studentSnapshot.h"
+#include <QHash>
+
+StudentSnapshot::StudentSnapshot(const StudentRecord *const students, const int numStudents, const DataOptions *const dataOptions,
+                                 const QList<int> &studentsBeingTeamed) :
+    records(students),
+    numStudents(numStudents)
+{
+    genderMask.reserve(numStudents);
+    URMResponseIndex.reserve(numStudents);
+    timezone.reserve(numStudents);
+    hasSchedule.reserve(numStudents);
+    for(int student = 0; student < numStudents; student++) {
+        const auto &record = students[student];
+
+        uint8_t mask = 0;
+        for(const auto gender : record.gender) {
+            mask |= genderBit(gender);
+        }
+        genderMask << mask;
+
+        int responseIndex = -1;
+        if(!record.URMResponse.isEmpty() && record.URMResponse != "--") {
+            responseIndex = int(URMResponses.indexOf(record.URMResponse));
+            if(responseIndex == -1) {
+                responseIndex = int(URMResponses.size());
+                URMResponses << record.URMResponse;
+            }
+        }
+        URMResponseIndex << responseIndex;
+
+        timezone << record.timezone;
+    }
+
+    // attributes
+    const int numAttributes = (dataOptions != nullptr)? dataOptions->numAttributes : 0;
+    attributeVals_discrete.resize(numAttributes);
+    attributeVals_continuous.resize(numAttributes);
+    for(int attribute = 0; attribute < numAttributes; attribute++) {
+        for(int student = 0; student < numStudents; student++) {
+            const auto &record = students[student];
+            if(attribute < record.attributeVals_discrete.size()) {
+                attributeVals_discrete[attribute].append(record.attributeVals_discrete[attribute].cbegin(), record.attributeVals_discrete[attribute].cend());
+            }
+            else {
+                attributeVals_discrete[attribute].appendEmpty();
+            }
+            if(attribute < record.attributeVals_continuous.size()) {
+                attributeVals_continuous[attribute].append(record.attributeVals_continuous[attribute].cbegin(), record.attributeVals_continuous[attribute].cend());
+            }
+            else {
+                attributeVals_continuous[attribute].appendEmpty();
+            }
+        }
+    }
+
+    // schedules
+    if(dataOptions != nullptr) {
+        numScheduleDays = int(dataOptions->dayNames.size());
+        numScheduleTimes = int(dataOptions->timeNames.size());
+    }
+    scheduleWordsPerDay = (numScheduleTimes + 63) / 64;
+    availabilityBits.fill(0, qsizetype(numStudents) * numScheduleDays * scheduleWordsPerDay);
+    const int chartSize = numScheduleDays * numScheduleTimes;
+    for(int student = 0; student < numStudents; student++) {
+        const auto &record = students[student];
+        const bool scheduleKnown = !record.ambiguousSchedule && (record.unavailable.size() >= chartSize);
+        hasSchedule << uint8_t(scheduleKnown);
+        uint64_t *const studentAvailability = availabilityBits.data() + (qsizetype(student) * numScheduleDays * scheduleWordsPerDay);
+        for(int day = 0; day < numScheduleDays; day++) {
+            for(int time = 0; time < numScheduleTimes; time++) {
+                // students without a known schedule are treated as available at all times
+                if(!scheduleKnown || !record.unavailable[day * numScheduleTimes + time]) {
+                    studentAvailability[day * scheduleWordsPerDay + time / 64] |= (uint64_t(1) << (time % 64));
+                }
+            }
+        }
+    }
+
+    // teammates, converted from IDs to indexes (any ID that isn't one of the students being teamed can never be a teammate, so is dropped)
+    QList<uint8_t> beingTeamed(numStudents, uint8_t(studentsBeingTeamed.isEmpty()));
+    for(const int student : studentsBeingTeamed) {
+        if((student >= 0) && (student < numStudents)) {
+            beingTeamed[student] = 1;
+        }
+    }
+    QHash<long long, int> indexOfID;
+    indexOfID.reserve(numStudents);
+    for(int student = 0; student < numStudents; student++) {
+        if(beingTeamed[student] != 0) {
+            indexOfID.insert(students[student].ID, student);
+        }
+    }
+    QList<int> indexes;
+    auto appendIndexes = [&indexOfID, &indexes](const QSet<long long> &IDs, FlatLists<int> &lists) {
+        indexes.clear();
+        for(const auto ID : IDs) {
+            const int index = indexOfID.value(ID, -1);
+            if(index != -1) {
+                indexes << index;
+            }
+        }
+        std::sort(indexes.begin(), indexes.end());
+        lists.append(indexes.cbegin(), indexes.cend());
+    };
+    for(int student = 0; student < numStudents; student++) {
+        if(beingTeamed[student] != 0) {
+            appendIndexes(students[student].groupTogether, groupTogether);
+            appendIndexes(students[student].splitApart, splitApart);
+        }
+        else {
+            groupTogether.appendEmpty();
+            splitApart.appendEmpty();
+        }
+    }
+
+    // the matrices, indexing the students in order of their first appearance in the lists
+    QList<int> matrixIndex(numStudents, -1);
+    int matrixSize = 0;
+    const auto addToMatrix = [&matrixIndex, &matrixSize](const int student) {
+        if(matrixIndex[student] == -1) {
+            matrixIndex[student] = matrixSize;
+            matrixSize++;
+        }
+    };
+    for(int student = 0; student < numStudents; student++) {
+        for(const auto *const lists : {&groupTogether, &splitApart}) {
+            if(lists->size(student) > 0) {
+                addToMatrix(student);
+                std::for_each(lists->begin(student), lists->end(student), addToMatrix);
+            }
+        }
+    }
+    if((matrixSize > 0) && (matrixSize <= MAX_TEAMMATES_MATRIX_SIZE)) {
+        teammatesMatrixIndex = matrixIndex;
+        groupTogetherMatrix.resize(matrixSize);
+        splitApartMatrix.resize(matrixSize);
+        for(int student = 0; student < numStudents; student++) {
+            std::for_each(groupTogether.begin(student), groupTogether.end(student),
+                          [this, &matrixIndex, student](const int other){groupTogetherMatrix.set(matrixIndex[student], matrixIndex[other]);});
+            std::for_each(splitApart.begin(student), splitApart.end(student),
+                          [this, &matrixIndex, student](const int other){splitApartMatrix.set(matrixIndex[student], matrixIndex[other]);});
+        }
+    }
+}
+
+
+qsizetype StudentSnapshot::sizeInBytes() const
+{
+    qsizetype size = (genderMask.size() * qsizetype(sizeof(uint8_t))) + (URMResponseIndex.size() * qsizetype(sizeof(int))) +
+                     (timezone.size() * qsizetype(sizeof(float))) + (hasSchedule.size() * qsizetype(sizeof(uint8_t))) +
+                     (availabilityBits.size() * qsizetype(sizeof(uint64_t))) + groupTogether.sizeInBytes() + splitApart.sizeInBytes() +
+                     (teammatesMatrixIndex.size() * qsizetype(sizeof(int))) + groupTogetherMatrix.sizeInBytes() + splitApartMatrix.sizeInBytes();
+    for(const auto &values : attributeVals_discrete) {
+        size += values.sizeInBytes();
+    }
+    for(const auto &values : attributeVals_continuous) {
+        size += values.sizeInBytes();
+    }
+    return size;
+}
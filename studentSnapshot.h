@@ -0,0 +1,115 @@
+#ifndef STUDENTSNAPSHOT_H
+#define STUDENTSNAPSHOT_H
+
+// A compact, read-only copy of the student data that is used to score teams, made once before optimizing.
+// Everything is stored in flat arrays indexed by the student's position in the students array (the same index used in the genomes),
+// so that scoring reads contiguous memory instead of chasing the pointers inside each StudentRecord's sets, lists, and strings.
+
+#include "dataOptions.h"
+#include "gruepr_globals.h"
+#include "studentRecord.h"
+#include <QList>
+#include <QStringList>
+#include <algorithm>
+#include <cstdint>
+
+class StudentSnapshot
+{
+public:
+    // studentsBeingTeamed: indexes of the students that will be placed on teams (if empty, all of them)
+    StudentSnapshot(const StudentRecord *const students, const int numStudents, const DataOptions *const dataOptions,
+                    const QList<int> &studentsBeingTeamed = {});
+    ~StudentSnapshot() = default;
+    StudentSnapshot(const StudentSnapshot&) = delete;
+    StudentSnapshot operator= (const StudentSnapshot&) = delete;
+    StudentSnapshot(StudentSnapshot&&) = delete;
+    StudentSnapshot& operator= (StudentSnapshot&&) = delete;
+
+    // A list of values for each student, all stored end-to-end in one array
+    template<typename T>
+    class FlatLists
+    {
+    public:
+        FlatLists() : starts(1, 0) {}
+        template<typename Iterator> void append(Iterator first, Iterator last) {for(; first != last; ++first) {values << *first;} starts << int(values.size());}
+        void appendEmpty() {starts << int(values.size());}
+        const T *begin(const int student) const {return values.constData() + starts[student];}
+        const T *end(const int student) const {return values.constData() + starts[student + 1];}
+        int size(const int student) const {return starts[student + 1] - starts[student];}
+        int maxSize() const;
+        qsizetype sizeInBytes() const {return (starts.size() * qsizetype(sizeof(int))) + (values.size() * qsizetype(sizeof(T)));}
+
+    private:
+        QList<int> starts;      // student's values are values[starts[student]] up to (not including) values[starts[student + 1]]
+        QList<T> values;
+    };
+
+    // A square matrix of bits, one row of words for each student in it
+    class BitMatrix
+    {
+    public:
+        void resize(const int size) {wordsPerRow = (size + 63) / 64; bits.fill(0, qsizetype(size) * wordsPerRow);}
+        void set(const int row, const int column) {bits[(qsizetype(row) * wordsPerRow) + (column / 64)] |= (uint64_t(1) << (column % 64));}
+        const uint64_t *row(const int row) const {return bits.constData() + (qsizetype(row) * wordsPerRow);}
+        static bool test(const uint64_t *const row, const int column) {return ((row[column / 64] >> (column % 64)) & 1u) != 0;}
+        qsizetype sizeInBytes() const {return bits.size() * qsizetype(sizeof(uint64_t));}
+
+    private:
+        int wordsPerRow = 0;
+        QList<uint64_t> bits;
+    };
+
+    qsizetype sizeInBytes() const;          // memory used by the arrays read during scoring
+
+    const StudentRecord *const records;         // the students this was made from, for one-time setup (e.g., creating a criterion's workspace)
+    const int numStudents;
+
+    // gender: genderBit(gender) is set for each of the student's genders
+    static constexpr uint8_t genderBit(const Gender gender) {return uint8_t(1u << static_cast<int>(gender));}
+    QList<uint8_t> genderMask;
+
+    // racial/ethnic/cultural identity: index into URMResponses of the student's response, or -1 if there's no response ("" or "--")
+    QStringList URMResponses;                   // each distinct response, exactly as written
+    QList<int> URMResponseIndex;
+
+    // attribute question responses: one FlatLists per attribute
+    QList<FlatLists<int>> attributeVals_discrete;
+    QList<FlatLists<float>> attributeVals_continuous;
+    QList<float> timezone;
+
+    // schedule: a bitset for each student with 1 = available, and each day's time blocks starting in a new word
+    int numScheduleDays = 0;
+    int numScheduleTimes = 0;
+    int scheduleWordsPerDay = 0;
+    QList<uint8_t> hasSchedule;                 // false if the schedule is ambiguous or incomplete
+    const uint64_t *availability(const int student) const {return availabilityBits.constData() + (qsizetype(student) * numScheduleDays * scheduleWordsPerDay);}
+    static bool isAvailable(const uint64_t *const dayAvailability, const int time) {return ((dayAvailability[time / 64] >> (time % 64)) & 1u) != 0;}
+
+    // teammates: sorted indexes of the students that each student should be placed with / kept apart from
+    // (only those being teamed, since no other student can be placed on a team with them)
+    FlatLists<int> groupTogether;
+    FlatLists<int> splitApart;
+    // ...and the same as matrices over just the students in any of these lists, if there aren't too many of them,
+    // so that whether a student is to be placed with or kept apart from another is a single bit test
+    bool hasTeammatesMatrices() const {return !teammatesMatrixIndex.isEmpty();}
+    QList<int> teammatesMatrixIndex;            // each student's row and column in the matrices, or -1 if they aren't in them
+    BitMatrix groupTogetherMatrix;
+    BitMatrix splitApartMatrix;
+    inline static const int MAX_TEAMMATES_MATRIX_SIZE = 4096;   // students in the matrices (2 MB each) before the lists are used instead
+
+private:
+    QList<uint64_t> availabilityBits;
+};
+
+
+template<typename T>
+int StudentSnapshot::FlatLists<T>::maxSize() const
+{
+    int max = 0;
+    for(int student = 0; student < starts.size() - 1; student++) {
+        max = std::max(max, size(student));
+    }
+    return max;
+}
+
+#endif // STUDENTSNAPSHOT_H
@@ -0,0 +1,44 @@
+#ifndef SURVEYREADER_H
+#define SURVEYREADER_H
+
+// The interpretation of a survey data file's questions and responses, shared by the load data dialog and gruepr-cli so that both read a survey the same way.
+// Everything here works on an open CsvFile and the DataOptions / StudentRecords being filled from it;
+// any asking, reporting, or cancelling is left to the caller.
+
+#include "csvfile.h"
+#include "dataOptions.h"
+#include "studentRecord.h"
+#include <QList>
+
+class SurveyReader
+{
+public:
+    // the possible meanings of a survey question, each with the pattern recognizing it in the header text and the number of questions allowed to have it
+    static const QList<possFieldMeaning> &surveyFieldOptions();
+
+    // preload the fieldMeanings of the survey file from its header row (already read), leaving any meaning already given untouched
+    static void preloadFieldMeanings(CsvFile &surveyFile, DataOptions::DataSource source);
+
+    // set the fields of dataOptions, including the attribute question texts and the schedule day names, according to the survey file's fieldMeanings
+    static void setFieldsFromMeanings(const CsvFile &surveyFile, DataOptions &dataOptions, DataOptions::DataSource source);
+
+    // compile the schedule's time names and resolution from the schedule responses of every row, starting with the data row already read;
+    // the time names are padded to a full day if students answered in their home timezones, but setting the base timezone is left to the caller
+    static void compileTimeNames(CsvFile &surveyFile, DataOptions &dataOptions);
+
+    // update the type of gender data given in the survey from one student's responses
+    static void updateGenderType(const QStringList &fieldValues, DataOptions &dataOptions);
+
+    // size the attribute response lists of dataOptions before processing each attribute
+    static void sizeAttributeResponses(DataOptions &dataOptions);
+
+    // determine the type, response options, and values of one attribute from all of the students' responses, and set each student's value(s)
+    static void processAttributeResponses(int attribute, QList<StudentRecord> &students, DataOptions &dataOptions);
+
+    // gather and sort all of the unique URM, section, and gender responses, and count the students with each URM and gender identity
+    static void gatherIdentityResponses(const QList<StudentRecord> &students, DataOptions &dataOptions);
+
+    inline static const QString UNUSEDTEXT = QObject::tr("Unused");
+};
+
+#endif // SURVEYREADER_H
@@ -0,0 +1,1549 @@
+#include "teamOptimizer.h"
+#include "greedySeeder.h"
+#include <QElapsedTimer>
+#include <QHash>
+#include <QSet>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <sstream>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace {
+int maxNumThreads()
+{
+#ifdef _OPENMP
+    return omp_get_max_threads();
+#else
+    return 1;
+#endif
+}
+
+void setMaxNumThreads(const int numThreads)
+{
+#ifdef _OPENMP
+    omp_set_num_threads(numThreads);
+#else
+    Q_UNUSED(numThreads)
+#endif
+}
+
+int threadNum()
+{
+#ifdef _OPENMP
+    return omp_get_thread_num();
+#else
+    return 0;
+#endif
+}
+
+// a well-mixed 64 bit hash of a 64 bit value
+uint64_t splitmix64(uint64_t value)
+{
+    value += 0x9E3779B97F4A7C15ULL;
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+    return value ^ (value >> 31);
+}
+
+// the seed for each island's pRNG; the first island uses the seed itself
+std::mt19937::result_type islandSeed(const std::mt19937::result_type seed, const int island)
+{
+    if(island == 0) {
+        return seed;
+    }
+    std::seed_seq seeds{seed, std::mt19937::result_type(island)};
+    std::mt19937::result_type islandSeed = 0;
+    seeds.generate(&islandSeed, &islandSeed + 1);
+    return islandSeed;
+}
+
+// a pRNG's state, in its standard textual representation, for checkpoints
+QByteArray pRNGState(const std::mt19937 &pRNG)
+{
+    std::ostringstream state;
+    state << pRNG;
+    return QByteArray::fromStdString(state.str());
+}
+
+bool restorePRNGState(std::mt19937 &pRNG, const QByteArray &state)
+{
+    std::istringstream stream(state.toStdString());
+    stream >> pRNG;
+    return !stream.fail();
+}
+
+// put each pinned student in the genome back at its pinned position, swapping it with whichever student is there
+// (each swap puts one pinned student in place for good, so this takes at most one swap per pinned student)
+void pinStudents(int genome[], const int genomeSize, const int pinnedPosition[])
+{
+    for(int position = 0; position < genomeSize; position++) {
+        int pinned = pinnedPosition[genome[position]];
+        while((pinned >= 0) && (pinned != position)) {
+            std::swap(genome[position], genome[pinned]);
+            pinned = pinnedPosition[genome[position]];
+        }
+    }
+}
+}   // namespace
+
+
+TeamOptimizer::TeamOptimizer(const QList<StudentRecord> &students, const QList<int> &studentIndexes, const QList<int> &teamSizes,
+                             const TeamingOptions *const teamingOptions, const DataOptions *const dataOptions, QObject *parent) :
+    QObject(parent),
+    students(students),
+    studentIndexes(studentIndexes),
+    teamSizes(teamSizes),
+    numTeams(int(teamSizes.size())),
+    numStudents(int(studentIndexes.size())),
+    teamingOptions(teamingOptions),
+    dataOptions(dataOptions),
+    snapshot(students.constData(), int(students.size()), dataOptions, studentIndexes)
+{
+    // set the working value of the genetic algorithm's population size and tournament selection probability
+    ga.setGAParameters(numStudents);
+}
+
+
+TeamOptimizer::ScoringWorkspace::ScoringWorkspace(const StudentSnapshot &students, const int numTeams, const int teamSizes[],
+                                                   const TeamingOptions *const teamingOptions) :
+    teamScores(numTeams),
+    penaltyPoints(numTeams),
+    teamsToScore(numTeams),
+    teamSizesToScore(numTeams),
+    teammatesToScore(std::accumulate(teamSizes, teamSizes + numTeams, 0)),
+    teamKeysToScore(numTeams)
+{
+    const int numCriteria = int(teamingOptions->criteria.size());
+    criteriaScores.reserve(numCriteria);
+    criterionWorkspaces.reserve(numCriteria);
+    for(const auto *const criterion : teamingOptions->criteria) {
+        criteriaScores.append(QList<float>(numTeams));
+        criterionWorkspaces.push_back(criterion->createWorkspace(students, numTeams, teamSizes));
+    }
+}
+
+
+TeamOptimizer::TeamScorePool::TeamScorePool(const int populationSize, const int numTeams) :
+    numTeams(numTeams),
+    scores(size_t(populationSize) * numTeams),
+    penalties(size_t(populationSize) * numTeams),
+    changed(size_t(populationSize) * numTeams, 1)
+{
+}
+
+void TeamOptimizer::TeamScorePool::copyTeam(const int genome, const int team, const TeamScorePool &source, const int sourceGenome)
+{
+    const qsizetype index = (qsizetype(genome) * numTeams) + team;
+    const qsizetype sourceIndex = (qsizetype(sourceGenome) * numTeams) + team;
+    scores[index] = source.scores[sourceIndex];
+    penalties[index] = source.penalties[sourceIndex];
+    changed[index] = source.changed[sourceIndex];
+}
+
+void TeamOptimizer::TeamScorePool::copyGenome(const int genome, const TeamScorePool &source, const int sourceGenome)
+{
+    const qsizetype start = qsizetype(genome) * numTeams;
+    const qsizetype sourceStart = qsizetype(sourceGenome) * numTeams;
+    std::copy_n(source.scores.cbegin() + sourceStart, numTeams, scores.begin() + start);
+    std::copy_n(source.penalties.cbegin() + sourceStart, numTeams, penalties.begin() + start);
+    std::copy_n(source.changed.cbegin() + sourceStart, numTeams, changed.begin() + start);
+}
+
+void TeamOptimizer::TeamScorePool::markGenomeChanged(const int genome)
+{
+    std::fill_n(changed.begin() + (qsizetype(genome) * numTeams), numTeams, 1);
+}
+
+
+TeamOptimizer::GenomeMemoryPool::GenomeMemoryPool(const int populationSize, const QList<Criterion*> &criteria, const int numTeams)
+{
+    offsets.reserve(criteria.size());
+    for(const auto *const criterion : criteria) {
+        const int size = criterion->scoresTeamsIndependently()? 0 : criterion->genomeMemorySize(numTeams);
+        if(size > 0) {
+            offsets << (wordsPerGenome * qsizetype(sizeof(uint64_t)));
+            wordsPerGenome += (size + qsizetype(sizeof(uint64_t)) - 1) / qsizetype(sizeof(uint64_t));
+        }
+        else {
+            offsets << -1;
+        }
+    }
+    memory.resize(size_t(populationSize) * wordsPerGenome, 0);
+}
+
+void TeamOptimizer::GenomeMemoryPool::attach(const int genome, ScoringWorkspace &workspace)
+{
+    auto *const genomeMemory = reinterpret_cast<std::byte*>(memory.data() + (qsizetype(genome) * wordsPerGenome));
+    for(int criterion = 0; criterion < offsets.size(); criterion++) {
+        auto *const criterionWorkspace = workspace.criterionWorkspaces[criterion].get();
+        if((offsets[criterion] != -1) && (criterionWorkspace != nullptr)) {
+            criterionWorkspace->genomeMemory = genomeMemory + offsets[criterion];
+        }
+    }
+}
+
+void TeamOptimizer::GenomeMemoryPool::copyGenome(const int genome, const GenomeMemoryPool &source, const int sourceGenome)
+{
+    std::copy_n(source.memory.cbegin() + (qsizetype(sourceGenome) * wordsPerGenome), wordsPerGenome, memory.begin() + (qsizetype(genome) * wordsPerGenome));
+}
+
+
+TeamOptimizer::GenomeScoreCache::GenomeScoreCache(const int populationSize)
+{
+    qsizetype numSlots = 1;
+    while((numSlots < qsizetype(SLOTS_PER_GENOME) * populationSize) && (numSlots < MAX_SLOTS)) {
+        numSlots *= 2;
+    }
+    entries.resize(numSlots);
+    slotMask = uint64_t(numSlots - 1);
+}
+
+bool TeamOptimizer::GenomeScoreCache::find(const uint64_t key, Entry &entry)
+{
+    const auto slot = qsizetype(key & slotMask);
+    auto &lock = locks[slot % NUM_LOCKS];
+    lock.lock();
+    const bool found = (entries[slot].key == key);
+    if(found) {
+        entry = entries[slot];
+    }
+    lock.unlock();
+    return found;
+}
+
+void TeamOptimizer::GenomeScoreCache::insert(const Entry &entry)
+{
+    const auto slot = qsizetype(entry.key & slotMask);
+    auto &lock = locks[slot % NUM_LOCKS];
+    lock.lock();
+    entries[slot] = entry;
+    lock.unlock();
+}
+
+uint64_t TeamOptimizer::genomeKey(const int _teammates[], const int _numTeams, const int _teamSizes[], const TeamScoreCache &_teamScoreCache)
+{
+    // the team keys are summed into a key that doesn't depend on the teams' order
+    uint64_t key = 0;
+    int ID = 0;
+    for(int team = 0; team < _numTeams; team++) {
+        key += _teamScoreCache.teamKey(_teammates + ID, _teamSizes[team]);
+        ID += _teamSizes[team];
+    }
+    return (key == 0)? 1 : key;
+}
+
+
+TeamOptimizer::TeamScoreCache::TeamScoreCache(const int numStudents, const int populationSize, const int numTeams) :
+    studentHashes(numStudents)
+{
+    for(int index = 0; index < numStudents; index++) {
+        studentHashes[index] = splitmix64(uint64_t(index));
+    }
+
+    qsizetype numEntries = WAYS;
+    while((numEntries < qsizetype(ENTRIES_PER_GENOME) * populationSize * numTeams / WAYS) && (numEntries < MAX_ENTRIES)) {
+        numEntries *= 2;
+    }
+    entries.resize(numEntries);
+    bucketMask = uint64_t((numEntries / WAYS) - 1);
+}
+
+uint64_t TeamOptimizer::TeamScoreCache::teamKey(const int teammates[], const int teamSize) const
+{
+    // the students' hashes are summed into a hash that doesn't depend on their order, and then mixed with the team size
+    // (so that a team set's key, the sum of its teams' keys, isn't simply the sum of all the students' hashes)
+    uint64_t teamHash = uint64_t(teamSize);
+    for(int teammate = 0; teammate < teamSize; teammate++) {
+        teamHash += studentHashes[teammates[teammate]];
+    }
+    const uint64_t key = splitmix64(teamHash);
+    return (key == 0)? 1 : key;
+}
+
+bool TeamOptimizer::TeamScoreCache::find(const uint64_t key, float &teamScore, float &penaltyPoints)
+{
+    const auto bucket = qsizetype(key & bucketMask);
+    Entry *const bucketEntries = entries.data() + (bucket * WAYS);
+    auto &lock = locks[bucket % NUM_LOCKS];
+    lock.lock();
+    bool found = false;
+    for(int way = 0; way < WAYS; way++) {
+        if(bucketEntries[way].key == key) {
+            teamScore = bucketEntries[way].teamScore;
+            penaltyPoints = bucketEntries[way].penaltyPoints;
+            bucketEntries[way].lastUsed = generation;
+            found = true;
+            break;
+        }
+    }
+    lock.unlock();
+    return found;
+}
+
+void TeamOptimizer::TeamScoreCache::insert(const uint64_t key, const float teamScore, const float penaltyPoints)
+{
+    const auto bucket = qsizetype(key & bucketMask);
+    Entry *const bucketEntries = entries.data() + (bucket * WAYS);
+    auto &lock = locks[bucket % NUM_LOCKS];
+    lock.lock();
+    // replace this key if another thread already inserted it, otherwise an empty entry, otherwise the one unused for the most generations
+    int replace = 0;
+    for(int way = 0; way < WAYS; way++) {
+        if(bucketEntries[way].key == key) {
+            replace = way;
+            break;
+        }
+        if((bucketEntries[way].key == 0) || (bucketEntries[way].lastUsed < bucketEntries[replace].lastUsed)) {
+            replace = way;
+            if(bucketEntries[way].key == 0) {
+                break;
+            }
+        }
+    }
+    bucketEntries[replace] = {key, teamScore, penaltyPoints, generation};
+    lock.unlock();
+}
+
+TeamOptimizer::Island::Island(const GA &fullGA, const int start, const int populationSize, const std::mt19937::result_type seed) :
+    start(start),
+    ga(fullGA),
+    ranker(populationSize),
+    pRNG(seed)
+{
+    ga.setReducedPopulationSize(populationSize);
+}
+
+void TeamOptimizer::orderIslands(std::vector<Island> &islands, const float scores[], int islandOrderedIndex[])
+{
+    // a single population is ranked using all of the threads; otherwise each island is ranked on its own thread
+    if(islands.size() == 1) {
+        islands.front().ranker.rank(scores, islands.front().ga.populationsize, islandOrderedIndex);
+        return;
+    }
+#pragma omp parallel for \
+        default(none) \
+        shared(islands, scores, islandOrderedIndex)
+    for(int islandNum = 0; islandNum < int(islands.size()); islandNum++) {
+        auto &island = islands[islandNum];
+        island.ranker.rank(scores + island.start, island.ga.populationsize, islandOrderedIndex + island.start);
+    }
+}
+
+void TeamOptimizer::orderGenePool(const std::vector<Island> &islands, const float scores[], const int islandOrderedIndex[], int orderedIndex[])
+{
+    const int numIslands = int(islands.size());
+    const int populationSize = islands.back().start + islands.back().ga.populationsize;
+    for(const auto &island : islands) {
+        for(int genome = island.start; genome < island.start + island.ga.populationsize; genome++) {
+            orderedIndex[genome] = island.start + islandOrderedIndex[genome];
+        }
+    }
+    // merge pairs of neighboring islands, then pairs of those pairs, and so on
+    for(int width = 1; width < numIslands; width *= 2) {
+        for(int island = 0; island + width < numIslands; island += 2 * width) {
+            const int end = (island + (2 * width) < numIslands)? islands[island + (2 * width)].start : populationSize;
+            std::inplace_merge(orderedIndex + islands[island].start, orderedIndex + islands[island + width].start, orderedIndex + end,
+                               [scores](const int i, const int j){return (scores[i] > scores[j]);});
+        }
+    }
+}
+
+
+TeamOptimizer::LocalSearch::LocalSearch(const QList<int> &teamSizes, const std::vector<uint8_t> &positionPinned, const int numThreads, const int numTeams,
+                                        const std::mt19937::result_type seed) :
+    teamStartPositions(numTeams + 1, 0),
+    positionPinned(positionPinned),
+    teamScores(numThreads, std::vector<float>(numTeams)),
+    pRNG(seed)
+{
+    // (only the unpinned students on each team can be swapped)
+    QList<long long> numSwappable(numTeams, 0);
+    long long numStudentsSwappable = 0;
+    for(int team = 0; team < numTeams; team++) {
+        teamStartPositions[team + 1] = teamStartPositions[team] + teamSizes[team];
+        for(int position = teamStartPositions[team]; position < teamStartPositions[team + 1]; position++) {
+            teamOfPosition << team;
+            if(positionPinned[position] == 0) {
+                numSwappable[team]++;
+                numStudentsSwappable++;
+            }
+        }
+    }
+
+    // if there are few enough possible swaps, list them all once; otherwise leave room for a sample of them
+    const long long numStudents = teamStartPositions[numTeams];
+    long long numSwapsPossible = numStudentsSwappable * numStudentsSwappable;
+    for(const auto swappable : std::as_const(numSwappable)) {
+        numSwapsPossible -= swappable * swappable;
+    }
+    numSwapsPossible /= 2;
+    allSwaps = (numSwapsPossible <= MAX_LOCAL_SEARCH_SWAPS);
+    swaps.reserve(allSwaps? numSwapsPossible : MAX_LOCAL_SEARCH_SWAPS);
+    if(allSwaps) {
+        for(int positionA = 0; positionA < numStudents; positionA++) {
+            if(positionPinned[positionA] != 0) {
+                continue;
+            }
+            for(int positionB = teamStartPositions[teamOfPosition[positionA] + 1]; positionB < numStudents; positionB++) {
+                if(positionPinned[positionB] == 0) {
+                    swaps.emplace_back(positionA, positionB);
+                }
+            }
+        }
+    }
+}
+
+
+//////////////////
+// Hill climb one genome by steepest ascent: each step evaluates every candidate swap (or a new random sample of them) and makes the best one, if it improves the score
+// Each candidate's genome score is calculated exactly as it would be after the swap--with the two teams' new scores in a copy of the team scores--
+// and ties go to the earliest candidate, so that the result doesn't depend on how many threads are used
+//////////////////
+int TeamOptimizer::hillClimb(int genome[], float teamScores[], float penaltyPoints[], uint8_t needsScoring[], float &score, const int maxSteps,
+                             LocalSearch &localSearch, std::vector<ScoringWorkspace> &scoringWorkspaces, TeamScoreCache &teamScoreCache) const
+{
+    if(numTeams < 2) {
+        return 0;
+    }
+
+    // make sure that every team's score is up to date (the genome's score may have come from the score cache)
+    score = rescoreGenome(snapshot, genome, numTeams, teamSizes.constData(), teamingOptions, dataOptions, scoringWorkspaces.front(),
+                          teamScores, penaltyPoints, needsScoring, &teamScoreCache);
+
+    // the score and penalty of a team after putting student into position, from the team score cache if possible
+    auto scoreTeamAfterSwap = [this, genome, &localSearch, &teamScoreCache]
+                              (ScoringWorkspace &workspace, const int position, const int student, float &teamScore, float &teamPenalty) {
+        const int team = localSearch.teamOfPosition[position];
+        const int teamStart = localSearch.teamStartPositions[team];
+        int *const teammates = workspace.teammatesToScore.data();
+        std::copy(genome + teamStart, genome + localSearch.teamStartPositions[team + 1], teammates);
+        teammates[position - teamStart] = student;
+        const uint64_t key = teamScoreCache.teamKey(teammates, teamSizes[team]);
+        if(!teamScoreCache.find(key, teamScore, teamPenalty)) {
+            scoreTeams(snapshot, teammates, 1, teamSizes.constData() + team, teamingOptions, dataOptions, workspace);
+            teamScore = workspace.teamScores[0];
+            teamPenalty = workspace.penaltyPoints[0];
+            teamScoreCache.insert(key, teamScore, teamPenalty);
+        }
+    };
+
+    const auto &sharedNumTeams = numTeams;
+    const auto &sharedTeamSizes = teamSizes;
+    int numSteps = 0;
+    for(; numSteps < maxSteps; numSteps++) {
+        if(!localSearch.allSwaps) {
+            const int genomeSize = localSearch.teamStartPositions.back();
+            std::uniform_int_distribution<int> randPosition(0, genomeSize - 1);
+            localSearch.swaps.clear();
+            while(int(localSearch.swaps.size()) < MAX_LOCAL_SEARCH_SWAPS) {
+                const int positionA = randPosition(localSearch.pRNG);
+                const int positionB = randPosition(localSearch.pRNG);
+                if((localSearch.teamOfPosition[positionA] != localSearch.teamOfPosition[positionB]) &&
+                    (localSearch.positionPinned[positionA] == 0) && (localSearch.positionPinned[positionB] == 0)) {
+                    localSearch.swaps.emplace_back(positionA, positionB);
+                }
+            }
+        }
+        const int numSwaps = int(localSearch.swaps.size());
+        const auto &sharedNumSwaps = numSwaps;
+
+        float bestScore = score;
+        int bestSwap = -1;
+#pragma omp parallel \
+        default(none) \
+        shared(genome, teamScores, localSearch, scoringWorkspaces, scoreTeamAfterSwap, sharedNumTeams, sharedTeamSizes, sharedNumSwaps, bestScore, bestSwap)
+        {
+            auto &workspace = scoringWorkspaces[threadNum()];
+            auto &trialTeamScores = localSearch.teamScores[threadNum()];
+            std::copy(teamScores, teamScores + sharedNumTeams, trialTeamScores.begin());
+            float threadBestScore = bestScore;
+            int threadBestSwap = -1;
+#pragma omp for schedule(static)
+            for(int swap = 0; swap < sharedNumSwaps; swap++) {
+                const auto [positionA, positionB] = localSearch.swaps[swap];
+                const int teamA = localSearch.teamOfPosition[positionA];
+                const int teamB = localSearch.teamOfPosition[positionB];
+                float teamPenalty = 0;
+                scoreTeamAfterSwap(workspace, positionA, genome[positionB], trialTeamScores[teamA], teamPenalty);
+                scoreTeamAfterSwap(workspace, positionB, genome[positionA], trialTeamScores[teamB], teamPenalty);
+                const float trialScore = combineTeamScores(trialTeamScores.data(), sharedNumTeams, sharedTeamSizes.constData());
+                trialTeamScores[teamA] = teamScores[teamA];
+                trialTeamScores[teamB] = teamScores[teamB];
+                if(trialScore > threadBestScore) {
+                    threadBestScore = trialScore;
+                    threadBestSwap = swap;
+                }
+            }
+#pragma omp critical
+            {
+                if((threadBestSwap != -1) && ((threadBestScore > bestScore) || ((threadBestScore == bestScore) && (threadBestSwap < bestSwap)))) {
+                    bestScore = threadBestScore;
+                    bestSwap = threadBestSwap;
+                }
+            }
+        }
+
+        if(bestSwap == -1) {
+            break;
+        }
+        const auto [positionA, positionB] = localSearch.swaps[bestSwap];
+        const int teamA = localSearch.teamOfPosition[positionA];
+        const int teamB = localSearch.teamOfPosition[positionB];
+        auto &workspace = scoringWorkspaces.front();
+        scoreTeamAfterSwap(workspace, positionA, genome[positionB], teamScores[teamA], penaltyPoints[teamA]);
+        scoreTeamAfterSwap(workspace, positionB, genome[positionA], teamScores[teamB], penaltyPoints[teamB]);
+        std::swap(genome[positionA], genome[positionB]);
+        score = combineTeamScores(teamScores, numTeams, teamSizes.constData());
+    }
+    return numSteps;
+}
+
+
+void TeamOptimizer::stop()
+{
+    optimizationStoppedmutex.lock();
+    optimizationStopped = true;
+    optimizationStoppedmutex.unlock();
+}
+
+
+QList<int> TeamOptimizer::bestTeamSetSoFar(float *score)
+{
+    bestTeamSetSoFarMutex.lock();
+    QList<int> bestTeamSet = bestSoFar;
+    if(score != nullptr) {
+        *score = bestScoreSoFar;
+    }
+    bestTeamSetSoFarMutex.unlock();
+    return bestTeamSet;
+}
+
+
+uint64_t TeamOptimizer::optimizationKey() const
+{
+    uint64_t key = splitmix64(uint64_t(numStudents));
+    for(const int index : studentIndexes) {
+        key = splitmix64(key ^ uint64_t(students[index].ID));
+    }
+    for(const int teamSize : teamSizes) {
+        key = splitmix64(key ^ uint64_t(teamSize));
+    }
+    const std::vector<int> pinnedPosition = pinnedPositions();
+    for(int student = 0; student < int(pinnedPosition.size()); student++) {
+        if(pinnedPosition[student] >= 0) {
+            key = splitmix64(key ^ ((uint64_t(student) << 32) | uint64_t(pinnedPosition[student])));
+        }
+    }
+    return key;
+}
+
+
+bool TeamOptimizer::hasStartingTeamSet() const
+{
+    if(startingTeamSet.size() != numStudents) {
+        return false;
+    }
+    QList<int> sortedStartingTeamSet = startingTeamSet;
+    QList<int> sortedStudentIndexes = studentIndexes;
+    std::sort(sortedStartingTeamSet.begin(), sortedStartingTeamSet.end());
+    std::sort(sortedStudentIndexes.begin(), sortedStudentIndexes.end());
+    return (sortedStartingTeamSet == sortedStudentIndexes);
+}
+
+std::vector<int> TeamOptimizer::pinnedPositions() const
+{
+    std::vector<int> pinnedPosition(students.size(), -1);
+    if(pinnedStudents.isEmpty() || !hasStartingTeamSet()) {
+        return pinnedPosition;
+    }
+    const QSet<int> pinned(pinnedStudents.cbegin(), pinnedStudents.cend());
+    for(int position = 0; position < numStudents; position++) {
+        const int student = startingTeamSet[position];
+        if(pinned.contains(student)) {
+            pinnedPosition[student] = position;
+        }
+    }
+    return pinnedPosition;
+}
+
+
+//////////////////
+// Whether a checkpoint can be resumed by this optimization: written for the same students and team sizes,
+// with a population no larger than this one's (it's smaller if it was reduced for a time budget), and every student and ancestor index in range
+//////////////////
+bool TeamOptimizer::checkpointFits(const GACheckpoint &checkpoint) const
+{
+    if(!checkpoint.isValid()) {
+        return false;
+    }
+    const auto &state = checkpoint.state();
+    if((state.optimizationKey != optimizationKey()) || (state.numStudents != numStudents) || (state.populationSize > ga.populationsize) ||
+        (state.numAncestors != ga.numAncestors()) ||
+        (state.numIslands > std::max(1, state.populationSize / GA::MIN_ISLAND_POPULATIONSIZE)) ||
+        (state.pRNGStates.size() != (state.numIslands + 1)) || (state.numBestScores != GA::GENERATIONS_OF_STABILITY)) {
+        return false;
+    }
+    const int numRecords = int(students.size());
+    const auto *const genePoolEnd = state.genePool + (qsizetype(state.populationSize) * state.numStudents);
+    const auto *const ancestorsEnd = state.ancestors + (qsizetype(state.populationSize) * state.numAncestors);
+    return std::all_of(state.genePool, genePoolEnd, [numRecords](const int student){return (student >= 0) && (student < numRecords);}) &&
+           std::all_of(state.ancestors, ancestorsEnd, [&state](const int ancestor){return (ancestor >= 0) && (ancestor <= state.populationSize);});
+}
+
+bool TeamOptimizer::canResumeFromCheckpoint(int *generation, float *bestScore) const
+{
+    if(checkpointFileName.isEmpty()) {
+        return false;
+    }
+    const GACheckpoint checkpoint(checkpointFileName);
+    if(!checkpointFits(checkpoint)) {
+        return false;
+    }
+    if(generation != nullptr) {
+        *generation = checkpoint.state().generation;
+    }
+    if(bestScore != nullptr) {
+        *bestScore = checkpoint.bestScore();
+    }
+    return true;
+}
+
+
+////////////////////
+// Score random genomes on every thread for the given time, to find how many genomes can be scored per second.
+// Every team is scored (nothing comes from the caches), just as in the first generation.
+////////////////////
+double TeamOptimizer::measureGenomesPerSecond(const qint64 milliseconds) const
+{
+    // make local copies of member variables to satisfy openMP's needs
+    const auto &sharedStudents = snapshot;
+    const auto &sharedStudentIndexes = studentIndexes;
+    const auto &sharedNumTeams = numTeams;
+    const auto &sharedTeamSizes = teamSizes;
+    const auto *const sharedTeamingOptions = teamingOptions;
+    const auto *const sharedDataOptions = dataOptions;
+    const auto &sharedMilliseconds = milliseconds;
+    const bool sharedTeamMajorScoring = teamMajorScoring;
+
+    QElapsedTimer timer;
+    timer.start();
+    long long numGenomesScored = 0;
+#pragma omp parallel \
+        default(none) \
+        shared(timer, sharedMilliseconds, sharedStudents, sharedStudentIndexes, sharedNumTeams, sharedTeamSizes, sharedTeamingOptions, sharedDataOptions, \
+               sharedTeamMajorScoring) \
+        reduction(+:numGenomesScored)
+    {
+        ScoringWorkspace workspace(sharedStudents, sharedNumTeams, sharedTeamSizes.constData(), sharedTeamingOptions);
+        workspace.teamMajor = sharedTeamMajorScoring;
+        QList<int> genome = sharedStudentIndexes;
+        std::mt19937 pRNG(threadNum());
+        while(timer.elapsed() < sharedMilliseconds) {
+            std::shuffle(genome.begin(), genome.end(), pRNG);
+            getGenomeScore(sharedStudents, genome.constData(), sharedNumTeams, sharedTeamSizes.constData(), sharedTeamingOptions, sharedDataOptions, workspace);
+            numGenomesScored++;
+        }
+    }
+
+    return double(numGenomesScored) / std::max(double(timer.nsecsElapsed()) / 1.0E9, 1.0E-9);
+}
+
+
+////////////////////
+// Initialize weights based on priority then normalize all score factor weights using norm factor = number of factors / total weights of all factors
+// First criterion has weight 10, then each subsequent criterion is 3/4 the weight of the prev. one
+////////////////////
+void TeamOptimizer::setCriteriaWeights(const QList<Criterion*> &criteria)
+{
+    float weight = 10;
+    float sumOfWeights = 0;
+    for (auto *const criterion : criteria) {
+        criterion->weight = weight;
+        sumOfWeights += weight;
+        weight *= 0.75;
+    }
+
+    const int numCriteria = int(criteria.size());
+    float normFactor = numCriteria / sumOfWeights;
+    if(!std::isfinite(normFactor)) {
+        normFactor = 0;
+    }
+    // convert weights to realWeights
+    for (auto *const criterion : criteria) {
+        criterion->weight *= normFactor;
+    }
+}
+
+
+////////////////////
+// A static public wrapper for the getGenomeScore function
+// The calculated scores are updated into the .scores members of the _teams array sent to the function
+// This is a static function, and parameters are named with leading underscore to differentiate from TeamOptimizer member variables
+////////////////////
+void TeamOptimizer::calcTeamScores(const QList<StudentRecord> &_students, TeamSet &_teams, const TeamingOptions *const _teamingOptions)
+{
+    // the genome is sized from the teams themselves, since they may not hold the students currently counted as active (e.g., refined from another section)
+    const int _numTeams = _teams.size();
+    const auto &_dataOptions = _teams.dataOptions;
+    QList<int> teamSizes(_numTeams);
+    int numStudentsOnTeams = 0;
+    for(int teamnum = 0; teamnum < _numTeams; teamnum++) {
+        teamSizes[teamnum] = _teams[teamnum].size;
+        numStudentsOnTeams += teamSizes[teamnum];
+    }
+    QList<int> genome(numStudentsOnTeams);
+    QHash<long long, int> indexOfID;
+    indexOfID.reserve(_students.size());
+    for(int index = int(_students.size()) - 1; index >= 0; index--) {     // (backwards, so that a repeated ID finds its first student)
+        indexOfID.insert(_students.at(index).ID, index);
+    }
+    int ID = 0;
+    for(int teamnum = 0; teamnum < _numTeams; teamnum++) {
+        for(const auto studentID : std::as_const(_teams[teamnum].studentIDs)) {
+            genome[ID] = indexOfID.value(studentID, int(_students.size()));
+            ID++;
+        }
+    }
+
+    const StudentSnapshot snapshot(_students.constData(), int(_students.size()), &_dataOptions, genome);
+    ScoringWorkspace workspace(snapshot, _numTeams, teamSizes.constData(), _teamingOptions);
+    getGenomeScore(snapshot, genome.data(), _numTeams, teamSizes.data(), _teamingOptions, &_dataOptions, workspace);
+
+    for(int teamnum = 0; teamnum < _numTeams; teamnum++) {
+        _teams[teamnum].score = workspace.teamScores[teamnum];
+    }
+}
+
+
+////////////////////////////////////////////
+// Create and optimize teams using genetic algorithm
+////////////////////////////////////////////
+QList<int> TeamOptimizer::optimize()
+{
+    // Initialize an initial generation of random teammate sets, genePool[populationSize][numStudents].
+    // Each genome in this generation stores (by permutation) which students are in which team.
+    // Array has one entry per student and lists, in order, the index of the student in the students[] array.
+    // For example, if team 1 has 4 students, and genePool[0][] = [4, 9, 12, 1, 3, 6...], then the first genome places
+    // students[] entries 4, 9, 12, and 1 on to team 1 and students[] entries 3 and 6 as the first two students on team 2.
+
+    // when sharing the processor with other optimizations, use only this optimization's share of the threads
+    // (the setting belongs to this calling thread, so it affects no other optimization and is put back at the end)
+    const int previousMaxNumThreads = maxNumThreads();
+    if(numThreads > 0) {
+        setMaxNumThreads(numThreads);
+    }
+
+    // with a time budget, reduce the population (if needed) so that enough generations fit in the budget,
+    // sized from the speed of scoring the genomes of a first generation, where every team is scored (so later generations are faster)
+    // (unless continuing from a checkpoint, which sets the population to the one it saved)
+    QElapsedTimer optimizationTimer;
+    optimizationTimer.start();
+    std::unique_ptr<GACheckpoint> checkpoint;
+    resumedFromCheckpoint = false;
+    if(resumeFromCheckpoint && !checkpointFileName.isEmpty()) {
+        checkpoint = std::make_unique<GACheckpoint>(checkpointFileName);
+        resumedFromCheckpoint = checkpointFits(*checkpoint);
+        if(resumedFromCheckpoint && (checkpoint->state().populationSize < ga.populationsize)) {
+            ga.setReducedPopulationSize(checkpoint->state().populationSize);
+        }
+    }
+    if((timeBudget > 0) && !resumedFromCheckpoint) {
+        const qint64 calibrationTime = std::clamp(qint64(timeBudget) / CALIBRATION_FRACTION, qint64(1), MAX_CALIBRATION_TIME);
+        calibratedGenomesPerSecond = measureGenomesPerSecond(calibrationTime);
+        const double secondsLeft = double(timeBudget - optimizationTimer.elapsed()) / 1000.0;
+        const double populationThatFits = (calibratedGenomesPerSecond * secondsLeft) / GA::TIMEBUDGET_GENERATIONS;
+        if(populationThatFits < ga.populationsize) {
+            ga.setReducedPopulationSize(std::max(GA::MIN_TIMEBUDGET_POPULATIONSIZE, int(populationThatFits)));
+        }
+    }
+    bestTeamSetSoFarMutex.lock();
+    bestSoFar.clear();
+    bestTeamSetSoFarMutex.unlock();
+
+    // allocate memory for gene pools and ancestor pools (RAII — freed automatically)
+    GA::GenePool genePool(ga, numStudents);
+    GA::GenePool nextGenGenePool(ga, numStudents);
+    GA::AncestorPool ancestors(ga);
+    GA::AncestorPool nextGenAncestors(ga);
+
+    // split the genepool into islands that breed independently of each other (by default, a single island that is the whole genepool),
+    // each with its own pRNG (need to specifically create and seed them here because this is happening in a new thread)
+    std::random_device randDev;
+    const std::mt19937::result_type masterSeed = seed.value_or(randDev());
+    const int numIslandsUsed = resumedFromCheckpoint? checkpoint->state().numIslands :
+                                                      std::clamp(numIslands, 1, std::max(1, ga.populationsize / GA::MIN_ISLAND_POPULATIONSIZE));
+    std::vector<Island> islands;
+    islands.reserve(numIslandsUsed);
+    for(int island = 0; island < numIslandsUsed; island++) {
+        const int start = int((static_cast<long long>(ga.populationsize) * island) / numIslandsUsed);
+        const int end = int((static_cast<long long>(ga.populationsize) * (island + 1)) / numIslandsUsed);
+        islands.emplace_back(ga, start, end - start, islandSeed(masterSeed, island));
+    }
+
+    // each island's offspring are bred in fixed blocks of genomes, each block with its own pRNG seeded from its island's pRNG every generation,
+    // so that the offspring are the same no matter how many threads breed them or which thread breeds which block
+    std::vector<BreedingBlock> breedingBlocks;
+    for(int island = 0; island < numIslandsUsed; island++) {
+        const int end = islands[island].start + islands[island].ga.populationsize;
+        int blockOnIsland = 0;
+        for(int first = islands[island].start + GA::NUM_ELITES; first < end; first += GENOMES_PER_BREEDING_BLOCK) {
+            breedingBlocks.push_back({island, blockOnIsland, first, std::min(first + GENOMES_PER_BREEDING_BLOCK, end)});
+            blockOnIsland++;
+        }
+    }
+
+    // arrays of indexes, sorted in order of score: within each island, as the genomes' indexes on the island,
+    // and within the whole genepool (so genePool[orderedIndex[0]] is the one with the top score)
+    auto islandOrderedIndex = std::make_unique<int[]>(ga.populationsize);
+    auto orderedIndex = std::make_unique<int[]>(ga.populationsize);
+    for(const auto &island : islands) {
+        for(int genome = 0; genome < island.ga.populationsize; genome++) {
+            islandOrderedIndex[island.start + genome] = genome;
+        }
+    }
+
+    // with a starting team set, part of the initial population starts from it, and any pinned students are kept at their positions in it
+    const bool warmStart = hasStartingTeamSet();
+    const std::vector<int> pinnedPosition = pinnedPositions();
+    std::vector<uint8_t> positionPinned(numStudents, 0);
+    for(const int position : pinnedPosition) {
+        if(position >= 0) {
+            positionPinned[position] = 1;
+        }
+    }
+    const bool pinning = std::any_of(positionPinned.cbegin(), positionPinned.cend(), [](const uint8_t pinned){return pinned != 0;});
+
+    // make local copies of member variables to satisfy openMP's needs
+    const auto &sharedStudents = snapshot;
+    const auto &sharedStudentIndexes = studentIndexes;
+    const auto &sharedNumStudents = numStudents;
+    const auto &sharedNumTeams = numTeams;
+    const auto &sharedTeamSizes = teamSizes;
+    const auto *const sharedTeamingOptions = teamingOptions;
+    const auto *const sharedDataOptions = dataOptions;
+    const auto &sharedStartingTeamSet = startingTeamSet;
+
+    // create an initial population on each island (each island in parallel), or, if resuming, the population saved in the checkpoint
+    if(resumedFromCheckpoint) {
+        const auto &state = checkpoint->state();
+        std::copy_n(state.genePool, qsizetype(ga.populationsize) * numStudents, genePool[0]);
+        std::copy_n(state.ancestors, qsizetype(ga.populationsize) * ancestors.numAncestors(), ancestors[0]);
+        std::copy_n(state.islandOrderedIndex, ga.populationsize, islandOrderedIndex.get());
+        std::copy_n(state.orderedIndex, ga.populationsize, orderedIndex.get());
+        for(int island = 0; island < numIslandsUsed; island++) {
+            restorePRNGState(islands[island].pRNG, state.pRNGStates.at(island));
+        }
+    }
+    else {
+        // with greedy seeding, the last part of each island's population is built greedily (below), and the rest as usual
+        const GreedySeeder greedySeeder(snapshot, studentIndexes, teamSizes, teamingOptions, dataOptions);
+        const bool seedingGreedily = greedySeeding && greedySeeder.hasHardRules();
+        std::vector<int> greedyGenomes;
+        std::vector<int> firstGreedyGenome(numIslandsUsed);
+        for(int islandNum = 0; islandNum < numIslandsUsed; islandNum++) {
+            const auto &island = islands[islandNum];
+            const int end = island.start + island.ga.populationsize;
+            firstGreedyGenome[islandNum] = seedingGreedily? (end - ((island.ga.populationsize * GREEDY_SEEDING_PERCENT) / 100)) : end;
+            for(int genome = firstGreedyGenome[islandNum]; genome < end; genome++) {
+                greedyGenomes.push_back(genome);
+            }
+        }
+
+        // start with an array of all the student IDs in order
+        // then make a random permutation for each genome in the island, store in genePool
+        // (or, with a starting team set, first the starting team set itself and then variants of it with a few students swapped)
+        // just use random values for their initial "ancestor" values
+#pragma omp parallel for \
+            default(none) \
+            shared(islands, genePool, ancestors, sharedStudentIndexes, sharedNumStudents, sharedStartingTeamSet, warmStart, pinning, pinnedPosition, firstGreedyGenome)
+        for(int islandNum = 0; islandNum < int(islands.size()); islandNum++) {
+            auto &island = islands[islandNum];
+            auto randPerm = std::make_unique<int[]>(sharedNumStudents);
+            for(int i = 0; i < sharedNumStudents; i++) {
+                randPerm[i] = sharedStudentIndexes[i];
+            }
+            std::uniform_int_distribution<unsigned int> randAncestor(0, island.ga.populationsize);
+            std::uniform_int_distribution<int> randNumSwaps(1, MAX_WARM_START_SWAPS);
+            const int numWarmStarts = warmStart? std::max(1, (island.ga.populationsize * WARM_START_PERCENT) / 100) : 0;
+            for(int genome = island.start; genome < island.start + island.ga.populationsize; genome++) {
+                auto *const thisGenome = genePool[genome];
+                if((genome - island.start) < numWarmStarts) {
+                    std::copy(sharedStartingTeamSet.cbegin(), sharedStartingTeamSet.cend(), thisGenome);
+                    if(genome != island.start) {
+                        for(int swap = randNumSwaps(island.pRNG); swap > 0; swap--) {
+                            island.ga.mutate(thisGenome, sharedNumStudents, island.pRNG);
+                        }
+                    }
+                }
+                else if(genome < firstGreedyGenome[islandNum]) {
+                    std::shuffle(randPerm.get(), randPerm.get()+sharedNumStudents, island.pRNG);
+                    for(int ID = 0; ID < sharedNumStudents; ID++) {
+                        thisGenome[ID] = randPerm[ID];
+                    }
+                }
+                if(pinning && (genome < firstGreedyGenome[islandNum])) {
+                    pinStudents(thisGenome, sharedNumStudents, pinnedPosition.data());
+                }
+                auto *const thisGenomesAncestors = ancestors[genome];
+                for(int ancestor = 0; ancestor < ancestors.numAncestors(); ancestor++) {
+                    thisGenomesAncestors[ancestor] = int(randAncestor(island.pRNG));
+                }
+            }
+        }
+
+        // build the greedy genomes, each in parallel with its own pRNG (seeded from the genome's place in the genepool, as if it were an island of its own
+        // after those of the islands and the local search), so that they're the same no matter how many threads build them
+        if(seedingGreedily) {
+            const std::mt19937::result_type greedySeed = islandSeed(masterSeed, numIslandsUsed + 1);
+#pragma omp parallel \
+            default(none) \
+            shared(greedySeeder, greedyGenomes, greedySeed, genePool, sharedNumStudents, pinning, pinnedPosition)
+            {
+                GreedySeeder::Workspace workspace(greedySeeder);
+#pragma omp for schedule(dynamic, 16)
+                for(int greedyGenome = 0; greedyGenome < int(greedyGenomes.size()); greedyGenome++) {
+                    const int genome = greedyGenomes[greedyGenome];
+                    std::mt19937 pRNG(islandSeed(greedySeed, genome));
+                    greedySeeder.buildTeamSet(genePool[genome], pRNG, workspace);
+                    if(pinning) {
+                        pinStudents(genePool[genome], sharedNumStudents, pinnedPosition.data());
+                    }
+                }
+            }
+        }
+    }
+
+    auto worstTeam = std::make_unique<int[]>(ga.populationsize);
+    auto teamStartPositions = std::make_unique<int[]>(numTeams + 1);
+    auto teamOfPosition = std::make_unique<int[]>(numStudents);
+    teamStartPositions[0] = 0;
+    for(int team = 0; team < numTeams; team++) {
+        teamStartPositions[team + 1] = teamStartPositions[team] + teamSizes[team];
+        std::fill(teamOfPosition.get() + teamStartPositions[team], teamOfPosition.get() + teamStartPositions[team + 1], team);
+    }
+
+    // each genome's team scores, kept so that only the teams that change from one generation to the next need to be rescored
+    // (unless a criterion scores the teams relative to each other, in which case any change means rescoring the whole genome)
+    TeamScorePool teamScorePool(ga.populationsize, numTeams);
+    TeamScorePool nextGenTeamScorePool(ga.populationsize, numTeams);
+    const bool rescoreOnlyChangedTeams = std::all_of(teamingOptions->criteria.cbegin(), teamingOptions->criteria.cend(),
+                                                     [](const Criterion *const criterion){return criterion->scoresTeamsIndependently();});
+    const auto &sharedRescoreOnlyChangedTeams = rescoreOnlyChangedTeams;
+    long long numTeamsRescored = 0;
+
+    // the score of each team set already scored, found from a hash of the students' hashes, so that a repeated team set isn't rescored
+    GenomeScoreCache scoreCache(ga.populationsize);
+    long long numScoreCacheHits = 0;
+
+    // and the score of each team already scored (which also hashes the students for the team set keys)
+    TeamScoreCache teamScoreCache(int(students.size()), ga.populationsize, numTeams);
+    TeamScoreCache *cachedTeamScores = rescoreOnlyChangedTeams? &teamScoreCache : nullptr;
+    long long numTeamScoreCacheHits = 0;
+
+    // optional local search of each generation's elites (seeded as if it were the next island, so that its pRNG differs from every island's)
+    const bool localSearching = rescoreOnlyChangedTeams && (localSearchElites > 0);
+    LocalSearch localSearch(teamSizes, positionPinned, maxNumThreads(), numTeams, islandSeed(masterSeed, numIslandsUsed));
+    QElapsedTimer localSearchTimer;
+    localSearchGain = 0;
+    localSearchSeconds = 0;
+    localSearchSwaps = 0;
+
+    // memory kept with each genome by any criterion that scores the whole genome at once, passed down to each child from one of its parents
+    GenomeMemoryPool genomeMemoryPool(ga.populationsize, teamingOptions->criteria, numTeams);
+    GenomeMemoryPool nextGenGenomeMemoryPool(ga.populationsize, teamingOptions->criteria, numTeams);
+
+    // preallocate one set of scoring variables and one mating scratch space per thread, reused for every genome in every generation
+    std::vector<ScoringWorkspace> scoringWorkspaces;
+    std::vector<std::unique_ptr<uint64_t[]>> matingScratch;
+    // (numThreads, if set, has already capped the threads used by every parallel region, above)
+    const int numWorkspaceThreads = maxNumThreads();
+    scoringWorkspaces.reserve(numWorkspaceThreads);
+    matingScratch.reserve(numWorkspaceThreads);
+    for(int thread = 0; thread < numWorkspaceThreads; thread++) {
+        scoringWorkspaces.emplace_back(snapshot, numTeams, teamSizes.constData(), teamingOptions);
+        scoringWorkspaces.back().teamMajor = teamMajorScoring;
+        matingScratch.push_back(std::make_unique<uint64_t[]>(GA::alleleBitmapWords(students.size())));
+    }
+
+    // calculate this first generation's scores (multi-threaded using OpenMP), or, if resuming, use the scores saved in the checkpoint
+    // (along with the saved orderings, so that the optimization continues exactly as it would have; the first generation then scores every team)
+    auto scores = std::make_unique<float[]>(ga.populationsize);
+    bool unpenalizedGenomePresent = false;
+    float bestScores[GA::GENERATIONS_OF_STABILITY]={0};	// historical record of best score in the genome, going back generationsOfStability generations
+    float scoreStability = 0;
+    int generation = 0;
+    if(resumedFromCheckpoint) {
+        const auto &state = checkpoint->state();
+        std::copy_n(state.scores, ga.populationsize, scores.get());
+        std::copy_n(state.bestScores, GA::GENERATIONS_OF_STABILITY, bestScores);
+        unpenalizedGenomePresent = state.unpenalizedGenomePresent;
+        scoreStability = state.scoreStability;
+        generation = state.generation;
+        teamScoreCache.generation = generation;
+        restorePRNGState(localSearch.pRNG, state.pRNGStates.at(numIslandsUsed));
+        checkpoint.reset();
+    }
+    else {
+#pragma omp parallel \
+            default(none) \
+            shared(scores, scoringWorkspaces, teamScorePool, genomeMemoryPool, cachedTeamScores, sharedStudents, genePool, sharedNumTeams, sharedTeamSizes, sharedTeamingOptions, sharedDataOptions) \
+            reduction(||:unpenalizedGenomePresent)
+        {
+            auto &workspace = scoringWorkspaces[threadNum()];
+#pragma omp for
+            for(int genome = 0; genome < ga.populationsize; genome++) {
+                const float *const penaltyPoints = teamScorePool.penaltyPoints(genome);
+                genomeMemoryPool.attach(genome, workspace);
+                scores[genome] = rescoreGenome(sharedStudents, genePool[genome], sharedNumTeams, sharedTeamSizes.constData(), sharedTeamingOptions, sharedDataOptions,
+                                               workspace, teamScorePool.teamScores(genome), teamScorePool.penaltyPoints(genome), teamScorePool.needsScoring(genome),
+                                               cachedTeamScores);
+                unpenalizedGenomePresent = unpenalizedGenomePresent ||
+                                           std::all_of(penaltyPoints, penaltyPoints + sharedNumTeams, [](const float p){return p <= 0.0f;});
+            }
+        }
+
+        // get genome indexes in order of score, largest to smallest
+        orderIslands(islands, scores.get(), islandOrderedIndex.get());
+        orderGenePool(islands, scores.get(), islandOrderedIndex.get(), orderedIndex.get());
+    }
+
+    // keep a copy of the best team set found so far, so that it can be had at any time
+    const auto recordBestTeamSet = [this, &genePool, &orderedIndex, &scores] {
+        const int best = orderedIndex[0];
+        bestTeamSetSoFarMutex.lock();
+        if(bestSoFar.isEmpty() || (scores[best] > bestScoreSoFar)) {
+            bestSoFar.resize(numStudents);
+            std::copy(genePool[best], genePool[best] + numStudents, bestSoFar.begin());
+            bestScoreSoFar = scores[best];
+        }
+        bestTeamSetSoFarMutex.unlock();
+    };
+    recordBestTeamSet();
+    firstUnpenalizedGeneration = unpenalizedGenomePresent? generation : -1;
+    emit generationComplete(scores.get(), orderedIndex.get(), generation, scoreStability, unpenalizedGenomePresent);
+
+    bool localOptimizationStopped = false;
+    bool outOfTime = false;
+    bool keepOptimizing = false;
+
+    // periodic checkpoints of the optimization's state, saved on a background thread
+    std::unique_ptr<GACheckpoint::Writer> checkpointWriter;
+    if(!checkpointFileName.isEmpty()) {
+        checkpointWriter = std::make_unique<GACheckpoint::Writer>(checkpointFileName);
+    }
+    GACheckpoint::State checkpointState;
+    checkpointState.optimizationKey = optimizationKey();
+    checkpointState.numStudents = numStudents;
+    checkpointState.populationSize = ga.populationsize;
+    checkpointState.numAncestors = ancestors.numAncestors();
+    checkpointState.numIslands = numIslandsUsed;
+    checkpointState.bestScores = bestScores;
+    checkpointState.numBestScores = GA::GENERATIONS_OF_STABILITY;
+    QElapsedTimer checkpointTimer;
+    checkpointTimer.start();
+
+    // now optimize
+    do {        // allow user to choose to continue optimizing beyond maxGenerations or seemingly reaching stability
+        do {        // keep optimizing until reach stability or maxGenerations
+            // clone each island's elites into the next generation, shifting their ancestor arrays as if "self-mating"
+            for(auto &island : islands) {
+                const int start = island.start;
+                const int *const islandOrder = islandOrderedIndex.get() + start;
+                for(int genome = 0; genome < GA::NUM_ELITES; genome++) {
+                    island.ga.clone(genePool[start + islandOrder[genome]], ancestors[start + islandOrder[genome]], islandOrder[genome],
+                                    nextGenGenePool[start + genome], nextGenAncestors[start + genome], numStudents);
+                    nextGenTeamScorePool.copyGenome(start + genome, teamScorePool, start + islandOrder[genome]);
+                    nextGenGenomeMemoryPool.copyGenome(start + genome, genomeMemoryPool, start + islandOrder[genome]);
+                }
+                island.generationSeed = island.pRNG();
+            }
+
+            // create rest of each island's next generation by mating, one block of genomes at a time (multi-threaded using OpenMP)
+            // each block's offspring come only from its own island's genomes, and only it writes to its rows of the next generation
+#pragma omp parallel \
+            default(none) \
+                shared(islands, breedingBlocks, matingScratch, islandOrderedIndex, genePool, nextGenGenePool, ancestors, nextGenAncestors, teamScorePool, \
+                       nextGenTeamScorePool, genomeMemoryPool, nextGenGenomeMemoryPool, teamStartPositions, sharedRescoreOnlyChangedTeams, sharedNumStudents, sharedNumTeams, \
+                       pinning, pinnedPosition)
+            {
+                uint64_t *const inMomsAllele = matingScratch[threadNum()].get();
+#pragma omp for schedule(dynamic, 1)
+                for(int blockNum = 0; blockNum < int(breedingBlocks.size()); blockNum++) {
+                    const auto &block = breedingBlocks[blockNum];
+                    const auto &island = islands[block.island];
+                    const int start = island.start;
+                    const int *const islandOrder = islandOrderedIndex.get() + start;
+                    const int *const *const islandGenePool = genePool.data() + start;
+                    const int *const *const islandAncestors = ancestors.data() + start;
+                    std::seed_seq blockSeeds{island.generationSeed, std::mt19937::result_type(block.blockOnIsland)};
+                    std::mt19937 pRNG(blockSeeds);
+
+                    for(int genome = block.firstGenome; genome < block.endGenome; genome++) {
+                        //get a couple of parents
+                        const int *mom=nullptr, *dad=nullptr;               // pointer to genome of mom and dad
+                        island.ga.tournamentSelectParents(islandGenePool, islandOrder, islandAncestors, mom, dad, nextGenAncestors[genome], pRNG);
+
+                        //mate them and put child in nextGenGenePool
+                        const auto *const child = nextGenGenePool[genome];
+                        const auto [firstTeamFromMom, endTeamFromMom] = island.ga.mate(mom, dad, teamStartPositions.get(), sharedNumTeams, nextGenGenePool[genome],
+                                                                                       sharedNumStudents, inMomsAllele, pRNG);
+                        //(mom's teams already have her pinned students in place, so putting back any pinned students only changes the other teams)
+                        if(pinning) {
+                            pinStudents(nextGenGenePool[genome], sharedNumStudents, pinnedPosition.data());
+                        }
+
+                        //the child's teams from mom's allele are unchanged from mom; any other team is unchanged from dad only if no students shifted in or out of it
+                        const int momsIndex = start + nextGenAncestors[genome][0];
+                        const int dadsIndex = start + nextGenAncestors[genome][1];
+                        if(!genomeMemoryPool.isEmpty()) {
+                            const bool mostlyFromMom = ((endTeamFromMom - firstTeamFromMom) > (sharedNumTeams / 2));
+                            nextGenGenomeMemoryPool.copyGenome(genome, genomeMemoryPool, mostlyFromMom? momsIndex : dadsIndex);
+                        }
+                        if(!sharedRescoreOnlyChangedTeams) {
+                            nextGenTeamScorePool.markGenomeChanged(genome);
+                            continue;
+                        }
+                        for(int team = 0; team < sharedNumTeams; team++) {
+                            if((team >= firstTeamFromMom) && (team < endTeamFromMom)) {
+                                nextGenTeamScorePool.copyTeam(genome, team, teamScorePool, momsIndex);
+                            }
+                            else if(std::equal(child + teamStartPositions[team], child + teamStartPositions[team + 1], dad + teamStartPositions[team])) {
+                                nextGenTeamScorePool.copyTeam(genome, team, teamScorePool, dadsIndex);
+                            }
+                            else {
+                                nextGenTeamScorePool.markTeamChanged(genome, team);
+                            }
+                        }
+                    }
+                }
+            }
+
+            // swap pointers to make nextGen's genePool, ancestors, and team scores into this generation's
+            swap(genePool, nextGenGenePool);
+            swap(ancestors, nextGenAncestors);
+            std::swap(teamScorePool, nextGenTeamScorePool);
+            std::swap(genomeMemoryPool, nextGenGenomeMemoryPool);
+
+            generation++;
+            teamScoreCache.generation = generation;
+
+            // calculate this generation's scores (multi-threaded using OpenMP, with the per-thread scoring variables)
+            unpenalizedGenomePresent = false;
+#pragma omp parallel \
+            default(none) \
+                shared(scores, worstTeam, scoringWorkspaces, teamScorePool, genomeMemoryPool, scoreCache, teamScoreCache, cachedTeamScores, teamStartPositions, teamOfPosition, \
+                       sharedStudents, genePool, sharedNumStudents, sharedNumTeams, sharedTeamSizes, sharedTeamingOptions, sharedDataOptions) \
+                reduction(||:unpenalizedGenomePresent) reduction(+:numTeamsRescored, numScoreCacheHits, numTeamScoreCacheHits)
+            {
+                auto &workspace = scoringWorkspaces[threadNum()];
+#pragma omp for
+                for(int genome = 0; genome < ga.populationsize; genome++) {
+                    const float *const teamScores = teamScorePool.teamScores(genome);
+                    const float *const penaltyPoints = teamScorePool.penaltyPoints(genome);
+
+                    // a team set that was already scored, even with its teams or teammates in a different order, gets the same score without scoring it
+                    // (its teams that needed scoring are left marked, so that any children inheriting them will score them)
+                    GenomeScoreCache::Entry cached;
+                    const uint64_t key = genomeKey(genePool[genome], sharedNumTeams, sharedTeamSizes.constData(), teamScoreCache);
+                    if(scoreCache.find(key, cached)) {
+                        const int *const thisGenome = genePool[genome];
+                        scores[genome] = cached.score;
+                        worstTeam[genome] = teamOfPosition[std::find(thisGenome, thisGenome + sharedNumStudents, cached.worstTeamMember) - thisGenome];
+                        unpenalizedGenomePresent = unpenalizedGenomePresent || cached.unpenalized;
+                        numScoreCacheHits++;
+                        continue;
+                    }
+
+                    genomeMemoryPool.attach(genome, workspace);
+                    scores[genome] = rescoreGenome(sharedStudents, genePool[genome], sharedNumTeams, sharedTeamSizes.constData(), sharedTeamingOptions, sharedDataOptions,
+                                                   workspace, teamScorePool.teamScores(genome), teamScorePool.penaltyPoints(genome), teamScorePool.needsScoring(genome),
+                                                   cachedTeamScores);
+                    numTeamsRescored += workspace.numTeamsRescored;
+                    numTeamScoreCacheHits += workspace.numTeamsFromCache;
+                    // find this genome's worst team
+                    int worst = 0;
+                    for(int team = 1; team < sharedNumTeams; team++) {
+                        if(teamScores[team] < teamScores[worst]) {
+                            worst = team;
+                        }
+                    }
+                    worstTeam[genome] = worst;
+                    const bool unpenalized = std::all_of(penaltyPoints, penaltyPoints + sharedNumTeams, [](const float p){return p <= 0.0f;});
+                    unpenalizedGenomePresent = unpenalizedGenomePresent || unpenalized;
+                    scoreCache.insert({key, scores[genome], genePool[genome][teamStartPositions[worst]], unpenalized});
+                }
+            }
+
+            // improve each island's top genomes by local search (finding them with a partial ranking, since the full ranking follows)
+            if(localSearching) {
+                localSearchTimer.start();
+                for(auto &island : islands) {
+                    int *const islandOrder = islandOrderedIndex.get() + island.start;
+                    const int numElites = std::min(localSearchElites, island.ga.populationsize);
+                    island.ranker.rankTop(scores.get() + island.start, island.ga.populationsize, numElites, islandOrder);
+                    for(int elite = 0; elite < numElites; elite++) {
+                        const int genome = island.start + islandOrder[elite];
+                        const float scoreBefore = scores[genome];
+                        localSearchSwaps += hillClimb(genePool[genome], teamScorePool.teamScores(genome), teamScorePool.penaltyPoints(genome),
+                                                      teamScorePool.needsScoring(genome), scores[genome], MAX_LOCAL_SEARCH_STEPS,
+                                                      localSearch, scoringWorkspaces, teamScoreCache);
+                        localSearchGain += scores[genome] - scoreBefore;
+                        const float *const teamScores = teamScorePool.teamScores(genome);
+                        const float *const penaltyPoints = teamScorePool.penaltyPoints(genome);
+                        worstTeam[genome] = int(std::min_element(teamScores, teamScores + numTeams) - teamScores);
+                        unpenalizedGenomePresent = unpenalizedGenomePresent ||
+                                                   std::all_of(penaltyPoints, penaltyPoints + numTeams, [](const float p){return p <= 0.0f;});
+                    }
+                }
+                localSearchSeconds += double(localSearchTimer.nsecsElapsed()) / 1.0E9;
+            }
+
+            // get genome indexes in order of score, largest to smallest, on each island
+            orderIslands(islands, scores.get(), islandOrderedIndex.get());
+
+            // every migrationInterval generations, each island's best genomes replace the worst genomes on the next island over
+            // (all of the migrants are copied before any island is reordered, so that no genome migrates more than once)
+            if((numIslandsUsed > 1) && (migrationInterval > 0) && ((generation % migrationInterval) == 0)) {
+                for(int island = 0; island < numIslandsUsed; island++) {
+                    const auto &from = islands[island];
+                    const auto &to = islands[(island + 1) % numIslandsUsed];
+                    for(int migrant = 0; migrant < GA::NUM_MIGRANTS; migrant++) {
+                        const int source = from.start + islandOrderedIndex[from.start + migrant];
+                        const int destinationOnIsland = islandOrderedIndex[to.start + to.ga.populationsize - GA::NUM_MIGRANTS + migrant];
+                        const int destination = to.start + destinationOnIsland;
+                        std::copy(genePool[source], genePool[source] + numStudents, genePool[destination]);
+                        std::fill(ancestors[destination], ancestors[destination] + ancestors.numAncestors(), destinationOnIsland);
+                        teamScorePool.copyGenome(destination, teamScorePool, source);
+                        genomeMemoryPool.copyGenome(destination, genomeMemoryPool, source);
+                        scores[destination] = scores[source];
+                        worstTeam[destination] = worstTeam[source];
+                    }
+                }
+                for(const auto &island : islands) {
+                    int *const islandOrder = islandOrderedIndex.get() + island.start;
+                    std::inplace_merge(islandOrder, islandOrder + island.ga.populationsize - GA::NUM_MIGRANTS, islandOrder + island.ga.populationsize,
+                                       [&scores, &island](const int i, const int j){return (scores[island.start + i] > scores[island.start + j]);});
+                }
+            }
+
+            // and in the whole genepool
+            orderGenePool(islands, scores.get(), islandOrderedIndex.get(), orderedIndex.get());
+
+            // mutate all but each island's single top-scoring genome with some probability
+#pragma omp parallel for \
+            default(none) \
+                shared(islands, islandOrderedIndex, genePool, worstTeam, teamScorePool, teamStartPositions, teamOfPosition, sharedRescoreOnlyChangedTeams, sharedNumStudents, \
+                       positionPinned)
+            for(int islandNum = 0; islandNum < int(islands.size()); islandNum++) {
+                auto &island = islands[islandNum];
+                std::uniform_int_distribution<unsigned int> randProbability(1, 100);
+                for(int genome = island.start; genome < island.start + island.ga.populationsize; genome++) {
+                    if(genome == island.start + islandOrderedIndex[island.start]) {
+                        continue;
+                    }
+                    while(randProbability(island.pRNG) < island.ga.mutationlikelihood) {
+                        const auto [siteA, siteB] = island.ga.mutateWorstTeam(genePool[genome], teamStartPositions.get(), worstTeam[genome], sharedNumStudents, island.pRNG);
+                        if((positionPinned[siteA] != 0) || (positionPinned[siteB] != 0)) {
+                            std::swap(genePool[genome][siteA], genePool[genome][siteB]);   // undo a mutation that would move a pinned student
+                            continue;
+                        }
+                        if(sharedRescoreOnlyChangedTeams) {
+                            teamScorePool.markTeamChanged(genome, teamOfPosition[siteA]);
+                            teamScorePool.markTeamChanged(genome, teamOfPosition[siteB]);
+                        }
+                        else {
+                            teamScorePool.markGenomeChanged(genome);
+                        }
+                    }
+                }
+            }
+
+            // determine best score, save in historical record, and calculate score stability
+            const float maxScoreInThisGeneration = scores[orderedIndex[0]];
+            const float maxScoreFromGenerationsAgo = bestScores[(generation+1) % (GA::GENERATIONS_OF_STABILITY)];
+            bestScores[generation % (GA::GENERATIONS_OF_STABILITY)] = maxScoreInThisGeneration;	//best scores from most recent generationsOfStability, wrapping storage location
+
+            if(maxScoreInThisGeneration == maxScoreFromGenerationsAgo) {
+                scoreStability = maxScoreInThisGeneration / 0.0001F;
+            }
+            else {
+                scoreStability = maxScoreInThisGeneration / (maxScoreInThisGeneration - maxScoreFromGenerationsAgo);
+            }
+
+            // save a checkpoint every checkpointInterval seconds (trying again next generation if the last one is still being saved)
+            if((checkpointWriter != nullptr) && (checkpointTimer.elapsed() >= (checkpointInterval * 1000LL))) {
+                checkpointState.generation = generation;
+                checkpointState.scoreStability = scoreStability;
+                checkpointState.unpenalizedGenomePresent = unpenalizedGenomePresent;
+                checkpointState.genePool = genePool[0];         // each pool's genomes are stored end-to-end, starting with genome 0
+                checkpointState.ancestors = ancestors[0];
+                checkpointState.scores = scores.get();
+                checkpointState.orderedIndex = orderedIndex.get();
+                checkpointState.islandOrderedIndex = islandOrderedIndex.get();
+                checkpointState.pRNGStates.clear();
+                for(const auto &island : islands) {
+                    checkpointState.pRNGStates << pRNGState(island.pRNG);
+                }
+                checkpointState.pRNGStates << pRNGState(localSearch.pRNG);
+                if(checkpointWriter->write(checkpointState)) {
+                    checkpointTimer.restart();
+                }
+            }
+
+            recordBestTeamSet();
+            if(unpenalizedGenomePresent && (firstUnpenalizedGeneration == -1)) {
+                firstUnpenalizedGeneration = generation;
+            }
+            emit generationComplete(scores.get(), orderedIndex.get(), generation, scoreStability, unpenalizedGenomePresent);
+
+            optimizationStoppedmutex.lock();
+            localOptimizationStopped = optimizationStopped;
+            optimizationStoppedmutex.unlock();
+            outOfTime = (timeBudget > 0) && (optimizationTimer.elapsed() >= timeBudget);
+        }
+        while(!localOptimizationStopped && !outOfTime && ((generation < GA::MIN_GENERATIONS) ||
+                                                          ((generation < GA::MAX_GENERATIONS) && (scoreStability < GA::MIN_SCORE_STABILITY))));
+
+        if(localOptimizationStopped || outOfTime || !continueUntilStopped || teamingOptions->criteria.empty()) { //if no criteria to group by, return immediately
+            keepOptimizing = false;
+            emit finishedOptimizing();
+        }
+        else {
+            keepOptimizing = true;
+        }
+    }
+    while(keepOptimizing);
+
+    // improve the best genome by local search, for as long as any swap improves it (if there's time)
+    if(rescoreOnlyChangedTeams && localSearchAtEnd && !outOfTime) {
+        localSearchTimer.start();
+        const int best = orderedIndex[0];
+        const float scoreBefore = scores[best];
+        localSearchSwaps += hillClimb(genePool[best], teamScorePool.teamScores(best), teamScorePool.penaltyPoints(best), teamScorePool.needsScoring(best),
+                                      scores[best], std::numeric_limits<int>::max(), localSearch, scoringWorkspaces, teamScoreCache);
+        localSearchGain += scores[best] - scoreBefore;
+        localSearchSeconds += double(localSearchTimer.nsecsElapsed()) / 1.0E9;
+        bestScores[generation % (GA::GENERATIONS_OF_STABILITY)] = scores[best];
+        recordBestTeamSet();
+    }
+
+    if(checkpointWriter != nullptr) {
+        checkpointWriter->waitForFinished();
+        numCheckpointsWritten = checkpointWriter->numWritten();
+    }
+
+    finalGeneration = generation;
+    fractionOfTeamsRescored = (generation > 0)? double(numTeamsRescored) / (double(generation) * ga.populationsize * numTeams) : 1;
+    scoreCacheHitRate = (generation > 0)? double(numScoreCacheHits) / (double(generation) * ga.populationsize) : 0;
+    teamScoreCacheHitRate = ((numTeamScoreCacheHits + numTeamsRescored) > 0)? double(numTeamScoreCacheHits) / double(numTeamScoreCacheHits + numTeamsRescored) : 0;
+    teamSetScore = bestScores[generation % (GA::GENERATIONS_OF_STABILITY)];
+
+    //copy best team set into a QList to return
+    QList<int> bestTeamSet;
+    bestTeamSet.reserve(numStudents);
+    const auto &bestGenome = genePool[orderedIndex[0]];
+    for(int ID = 0; ID < numStudents; ID++) {
+        bestTeamSet << bestGenome[ID];
+    }
+
+    setMaxNumThreads(previousMaxNumThreads);
+    return bestTeamSet;
+}
+
+
+//////////////////
+// Calculate score for one teamset (one genome)
+// Returns the total net score (which is, typically, the harmonic mean of all team scores)
+// Modifies the workspace's teamScores to give scores for each individual team in the genome, too
+// This is a static function, and parameters are named with leading underscore to differentiate from TeamOptimizer member variables
+//////////////////
+float TeamOptimizer::getGenomeScore(const StudentSnapshot &_students, const int _teammates[], const int _numTeams, const int _teamSizes[],
+                                    const TeamingOptions *const _teamingOptions, const DataOptions *const _dataOptions, ScoringWorkspace &_workspace)
+{
+    scoreTeams(_students, _teammates, _numTeams, _teamSizes, _teamingOptions, _dataOptions, _workspace);
+    return combineTeamScores(_workspace.teamScores.constData(), _numTeams, _teamSizes);
+}
+
+
+//////////////////
+// Calculate score for one teamset (one genome) whose unchanged teams were already scored
+// The teams needing a score are gathered, in order, into a smaller genome that is scored in the workspace, and then their scores are stored back
+// Since each team is scored exactly as it would be in the full genome, the result is identical to getGenomeScore
+// (as is the score of any team found in the team score cache, since it is only used when each team's score depends on nothing but its students)
+//////////////////
+float TeamOptimizer::rescoreGenome(const StudentSnapshot &_students, const int _teammates[], const int _numTeams, const int _teamSizes[],
+                                   const TeamingOptions *const _teamingOptions, const DataOptions *const _dataOptions, ScoringWorkspace &_workspace,
+                                   float _teamScores[], float _penaltyPoints[], uint8_t _needsScoring[], TeamScoreCache *const _teamScoreCache)
+{
+    int *const teamsToScore = _workspace.teamsToScore.data();
+    uint64_t *const teamKeysToScore = _workspace.teamKeysToScore.data();
+    int numTeamsToScore = 0, numTeamsFromCache = 0, teamStart = 0;
+    for(int team = 0; team < _numTeams; team++) {
+        if(_needsScoring[team] != 0) {
+            if(_teamScoreCache == nullptr) {
+                teamsToScore[numTeamsToScore] = team;
+                numTeamsToScore++;
+            }
+            else {
+                const uint64_t key = _teamScoreCache->teamKey(_teammates + teamStart, _teamSizes[team]);
+                if(_teamScoreCache->find(key, _teamScores[team], _penaltyPoints[team])) {
+                    _needsScoring[team] = 0;
+                    numTeamsFromCache++;
+                }
+                else {
+                    teamsToScore[numTeamsToScore] = team;
+                    teamKeysToScore[numTeamsToScore] = key;
+                    numTeamsToScore++;
+                }
+            }
+        }
+        teamStart += _teamSizes[team];
+    }
+    _workspace.numTeamsRescored = numTeamsToScore;
+    _workspace.numTeamsFromCache = numTeamsFromCache;
+
+    if(numTeamsToScore == _numTeams) {
+        scoreTeams(_students, _teammates, _numTeams, _teamSizes, _teamingOptions, _dataOptions, _workspace);
+    }
+    else if(numTeamsToScore > 0) {
+        int *const teamSizesToScore = _workspace.teamSizesToScore.data();
+        int *const teammatesToScore = _workspace.teammatesToScore.data();
+        int studentNum = 0, teamStart = 0, teamToScore = 0;
+        for(int team = 0; (team < _numTeams) && (teamToScore < numTeamsToScore); team++) {
+            if(team == teamsToScore[teamToScore]) {
+                teamSizesToScore[teamToScore] = _teamSizes[team];
+                std::copy(_teammates + teamStart, _teammates + teamStart + _teamSizes[team], teammatesToScore + studentNum);
+                studentNum += _teamSizes[team];
+                teamToScore++;
+            }
+            teamStart += _teamSizes[team];
+        }
+        scoreTeams(_students, teammatesToScore, numTeamsToScore, teamSizesToScore, _teamingOptions, _dataOptions, _workspace);
+    }
+
+    for(int teamToScore = 0; teamToScore < numTeamsToScore; teamToScore++) {
+        const int team = teamsToScore[teamToScore];
+        _teamScores[team] = _workspace.teamScores[teamToScore];
+        _penaltyPoints[team] = _workspace.penaltyPoints[teamToScore];
+        _needsScoring[team] = 0;
+        if(_teamScoreCache != nullptr) {
+            _teamScoreCache->insert(teamKeysToScore[teamToScore], _teamScores[team], _penaltyPoints[team]);
+        }
+    }
+
+    return combineTeamScores(_teamScores, _numTeams, _teamSizes);
+}
+
+
+//////////////////
+// Calculate the score of each team in a genome (or a set of teams gathered from one), leaving them in the workspace's teamScores and penaltyPoints
+//////////////////
+void TeamOptimizer::scoreTeams(const StudentSnapshot &_students, const int _teammates[], const int _numTeams, const int _teamSizes[],
+                               const TeamingOptions *const _teamingOptions, const DataOptions *const _dataOptions, ScoringWorkspace &_workspace)
+{
+    float *const _teamScores = _workspace.teamScores.data();
+    auto &_criteriaScores = _workspace.criteriaScores;
+    auto &_penaltyPoints = _workspace.penaltyPoints;
+
+    // Initialize each component and team score
+    std::fill(_penaltyPoints.begin(), _penaltyPoints.begin() + _numTeams, 0.0f);
+    for(auto &criteria : _criteriaScores) {
+        std::fill(criteria.begin(), criteria.begin() + _numTeams, 0.0f);
+    }
+    std::fill(_teamScores, _teamScores + _numTeams, 0.0f);
+
+    // Each run of consecutive criteria that score teams independently is scored team-major: each team is scored on every criterion of the run in turn,
+    // so that its students' data is still in cache for all of them. Any other criterion is given all of the teams at once, at its place in the order
+    // (so the penalty points, which each criterion adds to and then weights, build up in the same order either way)
+    const auto &_criteria = _teamingOptions->criteria;
+    const int numCriteria = int(_criteria.size());
+    int criterion = 0;
+    while(criterion < numCriteria) {
+        if(!_workspace.teamMajor || !_criteria[criterion]->scoresTeamsIndependently()) {
+            _criteria[criterion]->calculateScore(_students, _teammates, _numTeams, _teamSizes, _teamingOptions, _dataOptions,
+                                                 _criteriaScores[criterion], _penaltyPoints, _workspace.criterionWorkspaces[criterion].get());
+            criterion++;
+            continue;
+        }
+
+        int endOfRun = criterion + 1;
+        while((endOfRun < numCriteria) && _criteria[endOfRun]->scoresTeamsIndependently()) {
+            endOfRun++;
+        }
+        int studentNum = 0;
+        for(int team = 0; team < _numTeams; team++) {
+            for(int runCriterion = criterion; runCriterion < endOfRun; runCriterion++) {
+                _criteria[runCriterion]->calculateTeamScore(_students, _teammates + studentNum, _teamSizes[team], team, _teamingOptions, _dataOptions,
+                                                            _criteriaScores[runCriterion], _penaltyPoints,
+                                                            _workspace.criterionWorkspaces[runCriterion].get());
+            }
+            studentNum += _teamSizes[team];
+        }
+        criterion = endOfRun;
+    }
+
+    // Bring together for a final score for each team:
+    // Score is normalized to be out of 100 (but with possible "extra credit" for more than criterion match)
+    for(int team = 0; team < _numTeams; team++) {
+        for(int criterion = 0; criterion < _teamingOptions->criteria.size(); criterion++) {
+            // remove any criterion's "extra credit" (score > weight) if **any** penalties are being applied,
+            // so that very high extra credit doesn't cancel out the penalty
+            if(_criteriaScores[criterion][team] > _teamingOptions->criteria[criterion]->weight &&
+                _penaltyPoints[team] > 0) {
+                _teamScores[team] += _teamingOptions->criteria[criterion]->weight;
+            }
+            else {
+                _teamScores[team] += _criteriaScores[criterion][team];
+            }
+        }
+
+        if(_penaltyPoints[team] > 0) {
+            _penaltyPoints[team] = std::max(_penaltyPoints[team], MINIMUM_PENALTY);
+        }
+        _teamScores[team] = 100 * ((_teamScores[team] / float(_teamingOptions->criteria.size())) - _penaltyPoints[team]);
+    }
+}
+
+
+//////////////////
+// Bring all team scores together for a total genome score
+//////////////////
+float TeamOptimizer::combineTeamScores(const float _teamScores[], const int _numTeams, const int _teamSizes[])
+{
+    // Use the harmonic mean, the inverse of the average of the inverses, so score is skewed towards the smaller members.
+    // This makes it so we optimize for better values of the worse teams rather than run-away best teams.
+    // Very poor teams have 0 or negative scores, and this makes the harmonic mean impossible to calculate.
+    // Thus, if any teamScore is <= 0, we instead use the arithmetic mean punished by reducing towards negative infinity by half the arithmetic mean.
+    float harmonicSum = 0, regularSum = 0;
+    int numTeamsScored = 0;
+    bool allTeamsPositive = true;
+    for(int team = 0; team < _numTeams; team++) {
+        //ignore unpenalized teams of one since their score of 0 is not meaningful
+        if(_teamSizes[team] == 1 && _teamScores[team] == 0) {
+            continue;
+        }
+        numTeamsScored++;
+        regularSum += _teamScores[team];
+
+        if(_teamScores[team] <= 0) {
+            allTeamsPositive = false;
+        }
+        else {
+            harmonicSum += 1/_teamScores[team];
+        }
+    }
+
+    if(allTeamsPositive) {
+        return(float(numTeamsScored)/harmonicSum);      //harmonic mean
+    }
+
+    const float mean = regularSum / float(numTeamsScored);
+    return(mean - (std::abs(mean)/2));   //"punished" arithmetic mean
+}
@@ -0,0 +1,319 @@
+#ifndef TEAMOPTIMIZER_H
+#define TEAMOPTIMIZER_H
+
+// The optimization of a team set using the genetic algorithm.
+// Kept separate from the gruepr window so that the same optimization can be run without any GUI (e.g., gruepr-cli)
+
+#include "GA.h"
+#include "dataOptions.h"
+#include "gaCheckpoint.h"
+#include "studentRecord.h"
+#include "studentSnapshot.h"
+#include "teamRecord.h"
+#include "teamingOptions.h"
+#include <QList>
+#include <QMutex>
+#include <QObject>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+
+class TeamOptimizer : public QObject
+{
+    Q_OBJECT
+
+public:
+    TeamOptimizer(const QList<StudentRecord> &students, const QList<int> &studentIndexes, const QList<int> &teamSizes,
+                  const TeamingOptions *const teamingOptions, const DataOptions *const dataOptions, QObject *parent = nullptr);
+    ~TeamOptimizer() override = default;
+    TeamOptimizer(const TeamOptimizer&) = delete;
+    TeamOptimizer operator= (const TeamOptimizer&) = delete;
+    TeamOptimizer(TeamOptimizer&&) = delete;
+    TeamOptimizer& operator= (TeamOptimizer&&) = delete;
+
+    QList<int> optimize();          // return value is a single permutation-of-indexes into students
+    void stop();                    // thread-safe; optimization ends after the generation currently being created
+    QList<int> bestTeamSetSoFar(float *score = nullptr);    // thread-safe; the best team set found so far (empty until the first generation is scored)
+
+    // Everything that one thread needs to score genomes: the score arrays plus each criterion's workspace.
+    // Allocated once before scoring begins so that scoring a genome never allocates memory.
+    class ScoringWorkspace
+    {
+    public:
+        ScoringWorkspace(const StudentSnapshot &students, const int numTeams, const int teamSizes[], const TeamingOptions *const teamingOptions);
+
+        QList<float> teamScores;
+        QList<QList<float>> criteriaScores;
+        QList<float> penaltyPoints;
+        std::vector<std::unique_ptr<Criterion::Workspace>> criterionWorkspaces;
+        bool teamMajor = true;              // score each team on all of the criteria in turn, rather than all teams on each criterion in turn (see scoreTeams)
+
+        // the teams gathered together for rescoring, and how many there were in the most recently rescored genome
+        QList<int> teamsToScore;
+        QList<int> teamSizesToScore;
+        QList<int> teammatesToScore;
+        QList<uint64_t> teamKeysToScore;
+        int numTeamsRescored = 0;
+        int numTeamsFromCache = 0;
+    };
+
+    // A bounded cache of the scores of individual teams, shared by all of the scoring threads and kept for the whole optimization,
+    // so that a team that turns up again--in another genome, at another position, or in a later generation--isn't rescored.
+    // Only usable when every criterion scores each team independently of the others (see Criterion::scoresTeamsIndependently).
+    // Teams are found by a hash of their set of students (see teamKey). Each key can be in any of the WAYS entries of one bucket,
+    // and when that bucket is full the entry that was used the most generations ago is replaced.
+    class TeamScoreCache
+    {
+    public:
+        TeamScoreCache(int numStudents, int populationSize, int numTeams);
+
+        // a hash of the team's students and size that doesn't depend on the order of the students, never 0
+        uint64_t teamKey(const int teammates[], const int teamSize) const;
+        bool find(const uint64_t key, float &teamScore, float &penaltyPoints);  // returns false if the key isn't in the cache
+        void insert(const uint64_t key, const float teamScore, const float penaltyPoints);
+
+        int generation = 0;                 // set before each generation is scored, to mark the entries used in it
+
+    private:
+        struct Entry
+        {
+            uint64_t key = 0;               // 0 = empty entry
+            float teamScore = 0;
+            float penaltyPoints = 0;
+            int lastUsed = 0;               // the generation in which this team was last found or inserted
+        };
+        inline static const int WAYS = 4;
+        inline static const int ENTRIES_PER_GENOME = 4;         // (rounded up to a power of 2)
+        inline static const qsizetype MAX_ENTRIES = 1 << 20;
+        inline static const int NUM_LOCKS = 256;                // each bucket is guarded by lock number (bucket % NUM_LOCKS)
+        std::vector<uint64_t> studentHashes;
+        std::vector<Entry> entries;
+        uint64_t bucketMask = 0;
+        QMutex locks[NUM_LOCKS];
+    };
+
+    static void setCriteriaWeights(const QList<Criterion*> &criteria);
+    static void calcTeamScores(const QList<StudentRecord> &_students, TeamSet &_teams, const TeamingOptions *const _teamingOptions);
+    // the scores of each team, criterion, and penalty are left in _workspace
+    static float getGenomeScore(const StudentSnapshot &_students, const int _teammates[], const int _numTeams, const int _teamSizes[],
+                                const TeamingOptions *const _teamingOptions, const DataOptions *const _dataOptions, ScoringWorkspace &_workspace);
+    // scores only the teams flagged in _needsScoring, storing their results into _teamScores and _penaltyPoints (and clearing their flags),
+    // then combines these with the unchanged teams' stored scores into the genome score;
+    // if given a _teamScoreCache, flagged teams found in it aren't scored, and the teams that are scored are added to it
+    static float rescoreGenome(const StudentSnapshot &_students, const int _teammates[], const int _numTeams, const int _teamSizes[],
+                               const TeamingOptions *const _teamingOptions, const DataOptions *const _dataOptions, ScoringWorkspace &_workspace,
+                               float _teamScores[], float _penaltyPoints[], uint8_t _needsScoring[], TeamScoreCache *const _teamScoreCache = nullptr);
+
+    GA ga;                                  // class for genetic algorithm optimization
+    bool continueUntilStopped = false;      // if true, keep optimizing after reaching stability or maxGenerations until stop() is called
+    std::optional<std::mt19937::result_type> seed;  // if set, seeds the pRNG so that the optimization is reproducible (e.g., for benchmarking)
+    int numIslands = 1;                     // if more than 1, the genepool is split into this many islands that each breed on their own (in parallel)
+    int migrationInterval = GA::MIGRATION_INTERVAL;  // generations between the islands exchanging their best genomes
+    int numThreads = 0;                     // if more than 0, the most threads to use (e.g., when other optimizations are running at the same time)
+    int timeBudget = 0;                     // if more than 0, the most time (in ms) to spend optimizing, after which the best team set so far is returned;
+                                            // the population is reduced, from a measurement of how fast genomes are scored, so that enough generations fit
+    float teamSetScore = 0;
+    int finalGeneration = 1;
+    double fractionOfTeamsRescored = 1;     // after the first generation, the fraction of teams that actually needed to be scored
+    double scoreCacheHitRate = 0;           // after the first generation, the fraction of team sets whose score was found in the score cache
+    double teamScoreCacheHitRate = 0;       // after the first generation, the fraction of teams needing a score whose score was found in the team score cache
+
+    // optional local search, improving genomes by swapping students between teams (see hillClimb);
+    // only done if every criterion scores each team independently of the others, so that a swap needs only its two teams rescored
+    int localSearchElites = 0;              // if more than 0, each generation this many of each island's top genomes are improved by local search
+    bool localSearchAtEnd = false;          // if true, the best genome is improved by local search once the optimization has finished
+    double localSearchGain = 0;             // the total increase in genome scores from local search
+    double localSearchSeconds = 0;          // time spent in local search
+    long long localSearchSwaps = 0;         // number of improving swaps made by local search
+    double calibratedGenomesPerSecond = 0;  // with a time budget, the measured speed of scoring genomes on all threads that the population was sized from
+    bool teamMajorScoring = true;           // if false, genomes are scored one criterion at a time over all teams (e.g., for benchmarking the difference)
+
+    // optional greedy seeding, building part of the initial population with GreedySeeder when there are any hard rules (teammates or identity rules
+    // that are penalized when broken), so that the optimization doesn't begin from team sets that nearly all break them
+    bool greedySeeding = true;
+    int firstUnpenalizedGeneration = -1;    // the first generation with a team set breaking none of the hard rules (0 = the initial population), or -1 if none
+
+    // optional warm start, refining an existing team set (e.g., one edited by hand) instead of starting over from random team sets
+    QList<int> startingTeamSet;             // if a permutation of studentIndexes (in the same form that optimize() returns), the team set to start from:
+                                            // part of the initial population is this team set and variants of it with a few students swapped
+    QList<int> pinnedStudents;              // students (indexes into students) that stay on their team in startingTeamSet for the whole optimization
+
+    // optional checkpoints, so that an interrupted optimization can be resumed (see GACheckpoint)
+    QString checkpointFileName;             // if not empty, the optimization's state is saved to this file every checkpointInterval seconds (on a background thread)
+    int checkpointInterval = CHECKPOINT_INTERVAL;
+    bool resumeFromCheckpoint = false;      // if true and checkpointFileName holds a checkpoint of this same optimization, optimize() continues from it
+    bool resumedFromCheckpoint = false;     // whether optimize() did continue from a checkpoint
+    int numCheckpointsWritten = 0;
+    bool canResumeFromCheckpoint(int *generation = nullptr, float *bestScore = nullptr) const;  // whether checkpointFileName holds a checkpoint of this optimization
+    inline static const int CHECKPOINT_INTERVAL = 30;
+
+    inline const static float MINIMUM_PENALTY = 1.01f;            // ensures that even the smallest penalty to a team makes that team have negative score
+
+signals:
+    void generationComplete(const float *const allScores, const int *const orderedIndex,
+                            const int generation, const float scoreStability, const bool unpenalizedGenomePresent);
+    void finishedOptimizing();              // emitted once optimization will not continue any further
+
+private:
+    // The score and penalty of each team in each genome of a genepool, along with whether the team has changed since it was scored.
+    // Offspring copy these from their parents for each team they inherit unchanged, so that only new or mutated teams need scoring.
+    class TeamScorePool
+    {
+    public:
+        TeamScorePool(int populationSize, int numTeams);
+
+        float *teamScores(const int genome) {return scores.data() + (qsizetype(genome) * numTeams);}
+        float *penaltyPoints(const int genome) {return penalties.data() + (qsizetype(genome) * numTeams);}
+        uint8_t *needsScoring(const int genome) {return changed.data() + (qsizetype(genome) * numTeams);}
+
+        void copyTeam(const int genome, const int team, const TeamScorePool &source, const int sourceGenome);
+        void copyGenome(const int genome, const TeamScorePool &source, const int sourceGenome);
+        void markTeamChanged(const int genome, const int team) {changed[(qsizetype(genome) * numTeams) + team] = 1;}
+        void markGenomeChanged(const int genome);
+
+    private:
+        int numTeams;
+        std::vector<float> scores;
+        std::vector<float> penalties;
+        std::vector<uint8_t> changed;
+    };
+
+    // Each genome's memory for every criterion that keeps one (see Criterion::genomeMemorySize), all together in one block per genome
+    class GenomeMemoryPool
+    {
+    public:
+        GenomeMemoryPool(int populationSize, const QList<Criterion*> &criteria, int numTeams);
+
+        bool isEmpty() const {return wordsPerGenome == 0;}
+        void attach(const int genome, ScoringWorkspace &workspace);     // give each criterion's workspace this genome's memory
+        void copyGenome(const int genome, const GenomeMemoryPool &source, const int sourceGenome);
+
+    private:
+        QList<qsizetype> offsets;           // where each criterion's memory starts within a genome's block (in bytes), or -1 if it keeps none
+        qsizetype wordsPerGenome = 0;
+        std::vector<uint64_t> memory;       // (in 8-byte words, so that each criterion's memory is 8-byte aligned)
+    };
+
+    // A bounded cache of the scores of the team sets already scored, shared by all of the scoring threads.
+    // Team sets are found by a hash of their canonical form--the set of teams, each a set of students--so that the same team set
+    // is found no matter the order of its teams or of the students within them (see genomeKey).
+    // Each key has a single slot, and a newer team set replaces an older one whose key has the same slot.
+    class GenomeScoreCache
+    {
+    public:
+        explicit GenomeScoreCache(int populationSize);
+
+        struct Entry
+        {
+            uint64_t key = 0;               // 0 = empty slot
+            float score = 0;
+            int worstTeamMember = 0;        // any student on the worst-scoring team (since the team's position can differ)
+            bool unpenalized = false;
+        };
+        bool find(const uint64_t key, Entry &entry);    // returns false if the key isn't in the cache
+        void insert(const Entry &entry);
+
+    private:
+        inline static const int SLOTS_PER_GENOME = 4;           // (rounded up to a power of 2)
+        inline static const qsizetype MAX_SLOTS = 1 << 20;
+        inline static const int NUM_LOCKS = 64;                 // each slot is guarded by lock number (slot % NUM_LOCKS)
+        std::vector<Entry> entries;
+        uint64_t slotMask = 0;
+        QMutex locks[NUM_LOCKS];
+    };
+    // a hash of the team set that doesn't depend on the order of the teams or of the students within each team, never 0
+    static uint64_t genomeKey(const int _teammates[], const int _numTeams, const int _teamSizes[], const TeamScoreCache &_teamScoreCache);
+
+    // In the island model, one part of the genepool--genomes [start, start + ga.populationsize)--that breeds on its own, with its own pRNG.
+    // Within an island, genomes are referred to by their index on the island, so that the island's ga works on it as a genepool of its own.
+    class Island
+    {
+    public:
+        Island(const GA &fullGA, int start, int populationSize, std::mt19937::result_type seed);
+
+        int start;
+        GA ga;
+        GA::ScoreRanker ranker;
+        std::mt19937 pRNG;
+        std::mt19937::result_type generationSeed = 0;   // drawn from pRNG each generation, to seed the pRNG of each of the island's breeding blocks
+    };
+
+    // A range of genomes [firstGenome, endGenome) in the next generation of one island, all bred by one thread with the block's own pRNG
+    struct BreedingBlock
+    {
+        int island;
+        int blockOnIsland;
+        int firstGenome;
+        int endGenome;
+    };
+    inline static const int GENOMES_PER_BREEDING_BLOCK = 256;
+
+    // sort each island's genomes (by their index on the island) in order of score, largest to smallest
+    static void orderIslands(std::vector<Island> &islands, const float scores[], int islandOrderedIndex[]);
+    // merge the islands' orders into the order of the whole genepool
+    static void orderGenePool(const std::vector<Island> &islands, const float scores[], const int islandOrderedIndex[], int orderedIndex[]);
+
+    // Scratch space for hill climbing a genome by swapping students on different teams, reused for every hill climb
+    class LocalSearch
+    {
+    public:
+        LocalSearch(const QList<int> &teamSizes, const std::vector<uint8_t> &positionPinned, int numThreads, int numTeams, std::mt19937::result_type seed);
+
+        QList<int> teamStartPositions;
+        QList<int> teamOfPosition;
+        std::vector<uint8_t> positionPinned;        // positions holding a pinned student, which are never swapped
+        std::vector<std::pair<int, int>> swaps;     // the positions in the genome of the students in each candidate swap
+        bool allSwaps = false;                      // swaps holds every possible swap, rather than a new random sample for each step
+        std::vector<std::vector<float>> teamScores; // for each thread, a copy of the genome's team scores in which to try out swaps
+        std::mt19937 pRNG;
+    };
+    inline static const int MAX_LOCAL_SEARCH_SWAPS = 4096;      // candidate swaps per step; if more swaps are possible, a random sample of this many
+    inline static const int MAX_LOCAL_SEARCH_STEPS = 50;        // swaps made in each generation's hill climb of an elite (the one at the end can make any number)
+
+    // Improve the genome by repeatedly making whichever candidate swap of two students on different teams most improves its score,
+    // until none of the candidates does or maxSteps swaps have been made; returns the number of swaps made.
+    // The candidates are evaluated in parallel, each by scoring just the two teams it changes (or finding them in the team score cache).
+    int hillClimb(int genome[], float teamScores[], float penaltyPoints[], uint8_t needsScoring[], float &score, int maxSteps,
+                  LocalSearch &localSearch, std::vector<ScoringWorkspace> &scoringWorkspaces, TeamScoreCache &teamScoreCache) const;
+
+    // with a warm start, part of each island's initial population starts from startingTeamSet: the team set itself, and then variants of it
+    // with 1 to MAX_WARM_START_SWAPS pairs of students swapped
+    bool hasStartingTeamSet() const;
+    // for each student (by index into students), the position it's pinned to in every genome, or -1 if it isn't pinned
+    std::vector<int> pinnedPositions() const;
+    inline static const int WARM_START_PERCENT = 25;
+    inline static const int MAX_WARM_START_SWAPS = 3;
+    inline static const int GREEDY_SEEDING_PERCENT = 50;        // with greedy seeding, the part of each island's initial population built by GreedySeeder
+
+    // a hash of the students, team sizes, and pinned students, saved in checkpoints so that a checkpoint is only resumed by the same optimization
+    uint64_t optimizationKey() const;
+    bool checkpointFits(const GACheckpoint &checkpoint) const;
+
+    // how many random genomes all of the threads together can fully score per second, measured over the given time (in ms)
+    double measureGenomesPerSecond(qint64 milliseconds) const;
+    inline static const int CALIBRATION_FRACTION = 20;      // with a time budget, this fraction of the budget is spent measuring the scoring speed...
+    inline static const qint64 MAX_CALIBRATION_TIME = 500;  // ...but at most this long (in ms)
+
+    static void scoreTeams(const StudentSnapshot &_students, const int _teammates[], const int _numTeams, const int _teamSizes[],
+                           const TeamingOptions *const _teamingOptions, const DataOptions *const _dataOptions, ScoringWorkspace &_workspace);
+    static float combineTeamScores(const float _teamScores[], const int _numTeams, const int _teamSizes[]);
+
+    const QList<StudentRecord> &students;
+    const QList<int> studentIndexes;        // the indexes of students to be placed on teams
+    const QList<int> teamSizes;
+    const int numTeams;
+    const int numStudents;
+    const TeamingOptions *const teamingOptions;
+    const DataOptions *const dataOptions;
+    const StudentSnapshot snapshot;         // the student data, in the compact form used for scoring
+
+    QMutex optimizationStoppedmutex;
+    bool optimizationStopped = false;
+
+    QMutex bestTeamSetSoFarMutex;
+    QList<int> bestSoFar;
+    float bestScoreSoFar = 0;
+};
+
+#endif // TEAMOPTIMIZER_H
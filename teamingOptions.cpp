@@ -2,6 +2,7 @@
 #include <QJsonArray>
 #include <QMetaEnum>
 #include <QString>
+#include <algorithm>
 
 
 TeamingOptions::TeamingOptions(const QJsonObject &jsonTeamingOptions)
@@ -31,6 +32,7 @@ TeamingOptions::TeamingOptions(const QJsonObject &jsonTeamingOptions)
     }
     numTeamsDesired = jsonTeamingOptions["numTeamsDesired"].toInt();
     idealTeamSize = jsonTeamingOptions["idealTeamSize"].toInt(4);
+    timeLimitPerSection = jsonTeamingOptions["timeLimitPerSection"].toInt(0);
     sectionName = jsonTeamingOptions["sectionName"].toString();
     sectionType = static_cast<SectionType>(jsonTeamingOptions["sectionType"].toInt());
     teamsetNumber = jsonTeamingOptions["teamsetNumber"].toInt();
@@ -64,6 +66,7 @@ QJsonObject TeamingOptions::toJson() const
         {"largerTeamsNumTeams", largerTeamsNumTeams},
         {"teamSizesDesired", teamSizesDesiredArray},
         {"numTeamsDesired", numTeamsDesired},
+        {"timeLimitPerSection", timeLimitPerSection},
         {"sectionName", sectionName},
         {"sectionType", static_cast<int>(sectionType)},
         {"teamsetNumber", teamsetNumber}
@@ -71,3 +74,16 @@ QJsonObject TeamingOptions::toJson() const
 
     return content;
 }
+
+QList<int> TeamingOptions::calculateTeamSizes(const int numStudents, const int idealSize, const bool largerTeams)
+{
+    int numTeams = std::max(1, numStudents/idealSize);
+    if((numStudents % idealSize != 0) && !largerTeams) {
+        numTeams++;
+    }
+    QList<int> teamSizes(numTeams, 0);
+    for(int student = 0; student < numStudents; student++) {
+        teamSizes[student % numTeams]++;
+    }
+    return teamSizes;
+}
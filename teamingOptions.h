@@ -19,6 +19,10 @@ public:
 
     QJsonObject toJson() const;
 
+    // team sizes for the given ideal size, the same as offered in the team size box:
+    // if students can't be evenly divided, either one more team of smaller size(s) or the same number of teams with larger size(s)
+    static QList<int> calculateTeamSizes(int numStudents, int idealSize, bool largerTeams);
+
     QList<Criterion*> criteria;
 
     int idealTeamSize = 4;
@@ -29,6 +33,8 @@ public:
     QList<int> teamSizesDesired;
     int numTeamsDesired = 1;
 
+    int timeLimitPerSection = 0;                        // if more than 0, the most time (in seconds) to spend optimizing each section's teams
+
     QString sectionName;
     enum class SectionType {noSections, allTogether, allSeparately, oneSection} sectionType = SectionType::noSections;
 
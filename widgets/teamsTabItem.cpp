@@ -7,6 +7,7 @@
 #include "criteria/teammatesCriterion.h"
 #include "criteria/URMIdentityCriterion.h"
 #include "dialogs/customTeamnamesDialog.h"
+#include "dialogs/refineTeamsDialog.h"
 #include "LMS/canvashandler.h"
 #include "widgets/labelWithInstantTooltip.h"
 #include <QApplication>
@@ -216,6 +217,15 @@ void TeamsTabItem::init(TeamingOptions &incomingTeamingOptions, QList<StudentRec
     connect(sendToPreventedTeammates, &QPushButton::clicked, this, &TeamsTabItem::makeNewSetWithAllNewTeammates);
     teamOptionsLayout->addWidget(sendToPreventedTeammates);
 
+    auto *refineTeamsButton = new QPushButton(tr("Refine these teams"), this);
+    refineTeamsButton->setStyleSheet(SMALLBUTTONSTYLEINVERTED);
+    refineTeamsButton->setSizePolicy(QSizePolicy::Fixed, QSizePolicy::Fixed);
+    refineTeamsButton->setFlat(true);
+    refineTeamsButton->setToolTip(tr("<html>Create a new set of teams by improving on these teams (including any changes you've made to them) "
+                                     "instead of starting over, optionally keeping some students or teams as they are</html>"));
+    connect(refineTeamsButton, &QPushButton::clicked, this, &TeamsTabItem::refineTeams);
+    teamOptionsLayout->addWidget(refineTeamsButton);
+
     auto *savePrintLayout = new QHBoxLayout;
     savePrintLayout->setSpacing(2);
     teamDataLayout->addLayout(savePrintLayout);
@@ -643,7 +653,7 @@ void TeamsTabItem::swapStudents(const QList<int> &arguments) // QList<int> argum
                   studentBTeam.studentIDs[studentBTeam.studentIDs.indexOf(studentB->ID)]);      //(of course, studentATeam == studentBTeam)
 
         // Re-score the teams and refresh all the info
-        gruepr::calcTeamScores(students, numStudents, teams, teamingOptions);
+        TeamOptimizer::calcTeamScores(students, teams, teamingOptions);
         teams[studentATeamNum].refreshTeamInfo(students, ScheduleCriterion::getNumBlocksForOneMeeting(teamingOptions));
         teams[studentATeamNum].createTooltip(students);
 
@@ -692,7 +702,7 @@ void TeamsTabItem::swapStudents(const QList<int> &arguments) // QList<int> argum
         //refresh the info for both teams
         if((studentATeamItem != nullptr) && (studentATeamItem->treeItemType == TeamTreeWidgetItem::TreeItemType::team) &&
             (studentBTeamItem != nullptr) && (studentBTeamItem->treeItemType == TeamTreeWidgetItem::TreeItemType::team)) {
-            gruepr::calcTeamScores(students, numStudents, teams, teamingOptions);
+            TeamOptimizer::calcTeamScores(students, teams, teamingOptions);
             studentATeam.refreshTeamInfo(students, ScheduleCriterion::getNumBlocksForOneMeeting(teamingOptions));
             studentATeam.createTooltip(students);
             studentBTeam.refreshTeamInfo(students, ScheduleCriterion::getNumBlocksForOneMeeting(teamingOptions));
@@ -827,7 +837,7 @@ void TeamsTabItem::moveAStudent(const QList<int> &arguments) // QList<int> argum
     //refresh the info, tooltip, treeitem for both teams
     if((oldTeamItem != nullptr) && (oldTeamItem->treeItemType == TeamTreeWidgetItem::TreeItemType::team) &&
         (newTeamItem != nullptr) && (newTeamItem->treeItemType == TeamTreeWidgetItem::TreeItemType::team)) {
-        gruepr::calcTeamScores(students, numStudents, teams, teamingOptions);
+        TeamOptimizer::calcTeamScores(students, teams, teamingOptions);
         oldTeam.refreshTeamInfo(students, ScheduleCriterion::getNumBlocksForOneMeeting(teamingOptions));
         oldTeam.createTooltip(students);
         newTeam.refreshTeamInfo(students, ScheduleCriterion::getNumBlocksForOneMeeting(teamingOptions));
@@ -1093,6 +1103,21 @@ void TeamsTabItem::makeNewSetWithAllNewTeammates()
 }
 
 
+void TeamsTabItem::refineTeams()
+{
+    auto *window = new refineTeamsDialog(teams, students, this);
+    if(window->exec() == QDialog::Accepted) {
+        QList<QList<long long>> teamIDLists;
+        teamIDLists.reserve(teams.size());
+        for(const auto &team : std::as_const(teams)) {
+            teamIDLists << team.studentIDs;
+        }
+        emit refineTeamsRequested(teamIDLists, window->pinnedStudentIDs(), teamingOptions->sectionType == TeamingOptions::SectionType::allSeparately);
+    }
+    delete window;
+}
+
+
 void TeamsTabItem::saveTeams()
 {
     QStringList fileContents = createStdFileContents();
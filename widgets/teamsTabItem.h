@@ -45,6 +45,7 @@ signals:
     void connectedToPrinter();
     void saveState();
     void addCriterionRequested(Criterion::CriteriaType type);
+    void refineTeamsRequested(const QList<QList<long long>> &teamIDLists, const QList<long long> &pinnedIDs, bool separateSections);
 
 private slots:
     void changeTeamNames(const int index);
@@ -58,6 +59,7 @@ private slots:
     void undoRedoDragDrop();
 
     void makeNewSetWithAllNewTeammates();
+    void refineTeams();
 
     void saveTeams();
     void printTeams();